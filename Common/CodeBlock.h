@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 
 #include "Common/CommonTypes.h"
@@ -97,6 +98,9 @@ template<class T> class CodeBlock : public CodeBlockCommon, public T {
 			ProtectMemoryPages(region, region_size, MEM_PROT_READ | MEM_PROT_WRITE);
 		}
 		// If not WX Exclusive, no need to call ProtectMemoryPages because we never change the protection from RWX.
+		// This also resets the protection of anything an open batch made writable.
+		batchStart_ = nullptr;
+		batchEnd_ = nullptr;
 		PoisonMemory(offset);
 		ResetCodePtr(offset);
 		if (PlatformIsWXExclusive() && offset != 0) {
@@ -117,7 +121,7 @@ template<class T> class CodeBlock : public CodeBlockCommon, public T {
 			if (writeStart_ + sizeEstimate - region > (ptrdiff_t)region_size)
 				sizeEstimate = region_size - (writeStart_ - region);
 			writeEstimated_ = sizeEstimate;
-			ProtectMemoryPages(writeStart_, sizeEstimate, MEM_PROT_READ | MEM_PROT_WRITE);
+			MakeWritable(writeStart_, sizeEstimate);
 		}
 	}
 
@@ -129,7 +133,7 @@ template<class T> class CodeBlock : public CodeBlockCommon, public T {
 			if (pos + sizeEstimate - region > (ptrdiff_t)region_size)
 				sizeEstimate = region_size - (pos - region);
 			writeEstimated_ = pos - writeStart_ + sizeEstimate;
-			ProtectMemoryPages(pos, sizeEstimate, MEM_PROT_READ | MEM_PROT_WRITE);
+			MakeWritable(pos, sizeEstimate);
 		}
 	}
 
@@ -144,11 +148,39 @@ template<class T> class CodeBlock : public CodeBlockCommon, public T {
 			// Especially if we're linking blocks or similar.
 			if (sz < writeEstimated_)
 				sz = writeEstimated_;
-			ProtectMemoryPages(writeStart_, sz, MEM_PROT_READ | MEM_PROT_EXEC);
+			MakeExecutable(writeStart_, sz);
 			writeStart_ = nullptr;
 		}
 	}
 
+	// Groups the W^X transitions of everything written until the matching EndWriteBatch(), like
+	// several BeginWrite/EndWrite pairs and the exits patched when linking them, into as few
+	// protect calls as possible.  No code between the writes may run before it ends.  Can be nested.
+	void BeginWriteBatch() {
+		writeBatchDepth_++;
+	}
+
+	void EndWriteBatch() {
+		_dbg_assert_msg_(writeBatchDepth_ > 0, "EndWriteBatch() without BeginWriteBatch()");
+		if (--writeBatchDepth_ == 0 && batchStart_ != nullptr) {
+			ProtectMemoryPages(batchStart_, batchEnd_ - batchStart_, MEM_PROT_READ | MEM_PROT_EXEC);
+			batchStart_ = nullptr;
+			batchEnd_ = nullptr;
+		}
+	}
+
+	// For patching already written code, like block links, outside of BeginWrite/EndWrite.
+	// These take the writable pointer, and do nothing unless PlatformIsWXExclusive().
+	void BeginPatch(const u8 *writable, size_t size) {
+		if (PlatformIsWXExclusive())
+			MakeWritable(writable, size);
+	}
+
+	void EndPatch(const u8 *writable, size_t size) {
+		if (PlatformIsWXExclusive())
+			MakeExecutable(writable, size);
+	}
+
 	// Call this when shutting down. Don't rely on the destructor, even though it'll do the job.
 	void FreeCodeSpace() {
 #if !PPSSPP_PLATFORM(SWITCH)
@@ -192,11 +224,38 @@ template<class T> class CodeBlock : public CodeBlockCommon, public T {
 		T::SetCodePointer(ptr, GetWritablePtrFromCodePtr(ptr));
 	}
 
+private:
+	void MakeWritable(const u8 *ptr, size_t size) {
+		if (writeBatchDepth_ == 0) {
+			ProtectMemoryPages(ptr, size, MEM_PROT_READ | MEM_PROT_WRITE);
+			return;
+		}
+		// Already made writable earlier in this batch, which is common when linking to recent blocks.
+		if (ptr >= batchStart_ && ptr + size <= batchEnd_)
+			return;
+		const u8 *start = batchStart_ == nullptr ? ptr : std::min(batchStart_, ptr);
+		const u8 *end = batchStart_ == nullptr ? ptr + size : std::max(batchEnd_, ptr + size);
+		// The whole range is kept writable so that the check above is enough.  It's all code anyway.
+		ProtectMemoryPages(start, end - start, MEM_PROT_READ | MEM_PROT_WRITE);
+		batchStart_ = start;
+		batchEnd_ = end;
+	}
+
+	void MakeExecutable(const u8 *ptr, size_t size) {
+		// Inside a batch, EndWriteBatch() takes care of it in one go.
+		if (writeBatchDepth_ == 0)
+			ProtectMemoryPages(ptr, size, MEM_PROT_READ | MEM_PROT_EXEC);
+	}
+
 private:
 	// Note: this is a readable pointer.
 	const uint8_t *writeStart_ = nullptr;
 	uint8_t *writableRegion = nullptr;
 	size_t writeEstimated_ = 0;
+	// What an open write batch has made writable so far, to be made executable again when it ends.
+	int writeBatchDepth_ = 0;
+	const uint8_t *batchStart_ = nullptr;
+	const uint8_t *batchEnd_ = nullptr;
 #if PPSSPP_PLATFORM(SWITCH)
 	Jit jitController;
 #endif // PPSSPP_PLATFORM(SWITCH)
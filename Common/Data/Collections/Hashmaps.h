@@ -5,9 +5,21 @@
 #include <vector>
 
 #include "ext/xxhash.h"
+#include "Common/BitSet.h"
+#include "Common/Common.h"
 #include "Common/CommonFuncs.h"
 #include "Common/Log.h"
 
+#ifdef _M_SSE
+#include <emmintrin.h>
+#elif PPSSPP_ARCH(ARM_NEON)
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 // TODO: Try hardware CRC. Unfortunately not available on older Intels or ARM32.
 // Seems to be ubiquitous on ARM64 though.
 template<class K>
@@ -19,39 +31,181 @@ inline bool KeyEquals(const K &a, const K &b) {
 	return !memcmp(&a, &b, sizeof(K));
 }
 
+// Both maps below are "Swiss tables": every slot has a control byte, which is either FREE, REMOVED,
+// or the low 7 bits of the hash of the key in it. Slots are probed in aligned groups, and all control
+// bytes of a group are compared at once, so the key itself is almost only ever compared when it's
+// actually the one we're looking for.
 enum class BucketState : uint8_t {
-	FREE,
-	TAKEN,
-	REMOVED,  // for linear probing to work (and removal during deletion) we need tombstones
+	FREE = 0x80,
+	// A tombstone. Only needed when a group has been full, since then probes may have continued past it.
+	REMOVED = 0xFE,
+};
+
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+static const uint32_t HASHMAP_GROUP_SIZE = 16;
+#else
+// Without SIMD, a group is matched as a 64-bit word instead.
+static const uint32_t HASHMAP_GROUP_SIZE = 8;
+#endif
+
+// The slots in a group that matched. Depending on the implementation, each slot is a bit,
+// a nibble (NEON), or a byte (portable) of the mask, only the top bit of which is set.
+class HashGroupMatch {
+public:
+#ifdef _M_SSE
+	typedef uint32_t Bits;
+	static const int SLOT_SHIFT = 0;
+#elif PPSSPP_ARCH(ARM_NEON)
+	typedef uint64_t Bits;
+	static const int SLOT_SHIFT = 2;
+#else
+	typedef uint64_t Bits;
+	static const int SLOT_SHIFT = 3;
+#endif
+
+	explicit HashGroupMatch(Bits bits) : bits_(bits) {}
+
+	bool Any() const {
+		return bits_ != 0;
+	}
+
+	// Returns the lowest matching slot, and removes it from the match.
+	uint32_t Next() {
+#ifdef _M_SSE
+		uint32_t bit = LeastSignificantSetBit(bits_);
+#else
+		// LeastSignificantSetBit(u64) isn't available on all 32-bit targets.
+		uint32_t low = (uint32_t)bits_;
+		uint32_t bit = low != 0 ? LeastSignificantSetBit(low) : 32 + LeastSignificantSetBit((uint32_t)(bits_ >> 32));
+#endif
+		bits_ &= bits_ - 1;
+		return bit >> SLOT_SHIFT;
+	}
+
+private:
+	Bits bits_;
+};
+
+class HashGroup {
+public:
+	explicit HashGroup(const BucketState *ctrl) {
+#ifdef _M_SSE
+		ctrl_ = _mm_loadu_si128((const __m128i *)ctrl);
+#elif PPSSPP_ARCH(ARM_NEON)
+		ctrl_ = vld1q_u8((const uint8_t *)ctrl);
+#else
+		memcpy(&ctrl_, ctrl, HASHMAP_GROUP_SIZE);
+#endif
+	}
+
+	// This may give false positives in the portable version, which is fine since keys are compared anyway.
+	HashGroupMatch Match(uint8_t h2) const {
+#ifdef _M_SSE
+		return HashGroupMatch(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8((char)h2))));
+#elif PPSSPP_ARCH(ARM_NEON)
+		return ToMatch(vceqq_u8(ctrl_, vdupq_n_u8(h2)));
+#else
+		uint64_t x = ctrl_ ^ (LSBS * h2);
+		return HashGroupMatch((x - LSBS) & ~x & MSBS);
+#endif
+	}
+
+	// Exact in all versions.
+	HashGroupMatch MatchFree() const {
+#if defined(_M_SSE) || PPSSPP_ARCH(ARM_NEON)
+		return Match((uint8_t)BucketState::FREE);
+#else
+		// FREE is the only state with the top bit set and bit 1 clear.
+		return HashGroupMatch(ctrl_ & ~(ctrl_ << 6) & MSBS);
+#endif
+	}
+
+	// Either FREE or REMOVED, which are the only ones with the top bit set.
+	HashGroupMatch MatchAvailable() const {
+#ifdef _M_SSE
+		return HashGroupMatch(_mm_movemask_epi8(ctrl_));
+#elif PPSSPP_ARCH(ARM_NEON)
+		return ToMatch(vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(ctrl_), 7)));
+#else
+		return HashGroupMatch(ctrl_ & MSBS);
+#endif
+	}
+
+private:
+#ifdef _M_SSE
+	__m128i ctrl_;
+#elif PPSSPP_ARCH(ARM_NEON)
+	static HashGroupMatch ToMatch(uint8x16_t cmp) {
+		// Narrowing shift packs each byte of the comparison into a nibble.
+		uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+		return HashGroupMatch(vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL);
+	}
+
+	uint8x16_t ctrl_;
+#else
+	static const uint64_t LSBS = 0x0101010101010101ULL;
+	static const uint64_t MSBS = 0x8080808080808080ULL;
+
+	uint64_t ctrl_;
+#endif
+};
+
+inline uint32_t HashMapCapacity(int requested) {
+	uint32_t capacity = HASHMAP_GROUP_SIZE;
+	while (capacity < (uint32_t)requested)
+		capacity *= 2;
+	return capacity;
+}
+
+// Probes whole groups, in a triangular sequence which visits every group once.
+struct HashProbe {
+	HashProbe(uint32_t hash, uint32_t capacity) : mask((capacity / HASHMAP_GROUP_SIZE) - 1), group((hash >> 7) & mask) {}
+
+	uint32_t Offset() const {
+		return group * HASHMAP_GROUP_SIZE;
+	}
+	void Next() {
+		group = (group + ++stride) & mask;
+	}
+
+	uint32_t mask;
+	uint32_t group;
+	uint32_t stride = 0;
 };
 
-// Uses linear probing for cache-friendliness. Not segregating values from keys because
-// we always use very small values, so it's probably better to have them in the same
-// cache-line as the corresponding key.
+inline uint8_t HashControl(uint32_t hash) {
+	return hash & 0x7F;
+}
+
+// Not segregating values from keys because we always use very small values, so it's probably
+// better to have them in the same cache-line as the corresponding key.
 // Enforces that value are pointers to make sure that combined storage makes sense.
 template <class Key, class Value, Value NullValue>
 class DenseHashMap {
 public:
-	DenseHashMap(int initialCapacity) : capacity_(initialCapacity) {
-		map.resize(initialCapacity);
-		state.resize(initialCapacity);
+	DenseHashMap(int initialCapacity) : capacity_(HashMapCapacity(initialCapacity)) {
+		map.resize(capacity_);
+		state.resize(capacity_, BucketState::FREE);
 	}
 
 	// Returns nullptr if no entry was found.
 	Value Get(const Key &key) {
-		uint32_t mask = capacity_ - 1;
-		uint32_t pos = HashKey(key) & mask;
-		// No? Let's go into search mode. Linear probing.
-		uint32_t p = pos;
+		uint32_t hash = HashKey(key);
+		uint8_t h2 = HashControl(hash);
+		HashProbe probe(hash, capacity_);
 		while (true) {
-			if (state[p] == BucketState::TAKEN && KeyEquals(key, map[p].key))
-				return map[p].value;
-			else if (state[p] == BucketState::FREE)
-				return NullValue;
-			p = (p + 1) & mask;  // If the state is REMOVED, we just keep on walking. 
-			if (p == pos) {
-				_assert_msg_(false, "DenseHashMap: Hit full on Get()");
+			HashGroup group(&state[probe.Offset()]);
+			HashGroupMatch match = group.Match(h2);
+			while (match.Any()) {
+				uint32_t p = probe.Offset() + match.Next();
+				if (KeyEquals(key, map[p].key))
+					return map[p].value;
 			}
+			// A group that has never been full ends the search.
+			if (group.MatchFree().Any())
+				return NullValue;
+			probe.Next();
+			_dbg_assert_msg_(probe.stride < (uint32_t)capacity_ / HASHMAP_GROUP_SIZE, "DenseHashMap: Hit full on Get()");
 		}
 		return NullValue;
 	}
@@ -59,57 +213,70 @@ class DenseHashMap {
 	// Asserts if we already had the key!
 	bool Insert(const Key &key, Value value) {
 		// Check load factor, resize if necessary. We never shrink.
-		if (count_ > capacity_ / 2) {
-			Grow(2);
+		// Growing to the same size just gets rid of REMOVED tombstones.
+		if ((count_ + removedCount_ + 1) * 8 > capacity_ * 7) {
+			Grow(count_ * 16 >= capacity_ * 7 ? 2 : 1);
 		}
-		uint32_t mask = capacity_ - 1;
-		uint32_t pos = HashKey(key) & mask;
-		uint32_t p = pos;
+		uint32_t hash = HashKey(key);
+		uint8_t h2 = HashControl(hash);
+		HashProbe probe(hash, capacity_);
+		uint32_t target = 0xFFFFFFFF;
 		while (true) {
-			if (state[p] == BucketState::TAKEN) {
+			HashGroup group(&state[probe.Offset()]);
+			HashGroupMatch match = group.Match(h2);
+			while (match.Any()) {
+				uint32_t p = probe.Offset() + match.Next();
 				if (KeyEquals(key, map[p].key)) {
 					// Bad! We already got this one. Let's avoid this case.
 					_assert_msg_(false, "DenseHashMap: Duplicate key of size %d inserted", (int)sizeof(Key));
 					return false;
 				}
-				// continue looking....
-			} else {
-				// Got a place, either removed or FREE.
-				break;
-			}
-			p = (p + 1) & mask;
-			if (p == pos) {
-				// FULL! Error. Should not happen thanks to Grow().
-				_assert_msg_(false, "DenseHashMap: Hit full on Insert()");
 			}
+			// Remember the first available slot, but keep looking for the key until a free group.
+			HashGroupMatch available = group.MatchAvailable();
+			if (target == 0xFFFFFFFF && available.Any())
+				target = probe.Offset() + available.Next();
+			if (group.MatchFree().Any())
+				break;
+			probe.Next();
+			// FULL! Error. Should not happen thanks to Grow().
+			_assert_msg_(probe.stride < (uint32_t)capacity_ / HASHMAP_GROUP_SIZE, "DenseHashMap: Hit full on Insert()");
 		}
-		if (state[p] == BucketState::REMOVED) {
+		if (state[target] == BucketState::REMOVED) {
 			removedCount_--;
 		}
-		state[p] = BucketState::TAKEN;
-		map[p].key = key;
-		map[p].value = value;
+		state[target] = (BucketState)h2;
+		map[target].key = key;
+		map[target].value = value;
 		count_++;
 		return true;
 	}
 
 	bool Remove(const Key &key) {
-		uint32_t mask = capacity_ - 1;
-		uint32_t pos = HashKey(key) & mask;
-		uint32_t p = pos;
-		while (state[p] != BucketState::FREE) {
-			if (state[p] == BucketState::TAKEN && KeyEquals(key, map[p].key)) {
-				// Got it! Mark it as removed.
-				state[p] = BucketState::REMOVED;
-				removedCount_++;
-				count_--;
-				return true;
-			}
-			p = (p + 1) & mask;
-			if (p == pos) {
-				// FULL! Error. Should not happen.
-				_assert_msg_(false, "DenseHashMap: Hit full on Remove()");
+		uint32_t hash = HashKey(key);
+		uint8_t h2 = HashControl(hash);
+		HashProbe probe(hash, capacity_);
+		while (true) {
+			HashGroup group(&state[probe.Offset()]);
+			HashGroupMatch match = group.Match(h2);
+			while (match.Any()) {
+				uint32_t p = probe.Offset() + match.Next();
+				if (KeyEquals(key, map[p].key)) {
+					// Got it! If the group has never been full, no probe went past it, so no tombstone is needed.
+					if (group.MatchFree().Any()) {
+						state[p] = BucketState::FREE;
+					} else {
+						state[p] = BucketState::REMOVED;
+						removedCount_++;
+					}
+					count_--;
+					return true;
+				}
 			}
+			if (group.MatchFree().Any())
+				return false;
+			probe.Next();
+			_dbg_assert_msg_(probe.stride < (uint32_t)capacity_ / HASHMAP_GROUP_SIZE, "DenseHashMap: Hit full on Remove()");
 		}
 		return false;
 	}
@@ -121,7 +288,7 @@ class DenseHashMap {
 	template<class T>
 	inline void Iterate(T func) const {
 		for (size_t i = 0; i < map.size(); i++) {
-			if (state[i] == BucketState::TAKEN) {
+			if (IsTaken(state[i])) {
 				func(map[i].key, map[i].value);
 			}
 		}
@@ -130,7 +297,7 @@ class DenseHashMap {
 	template<class T>
 	inline void IterateMut(T func) {
 		for (size_t i = 0; i < map.size(); i++) {
-			if (state[i] == BucketState::TAKEN) {
+			if (IsTaken(state[i])) {
 				func(map[i].key, map[i].value);
 			}
 		}
@@ -155,6 +322,10 @@ class DenseHashMap {
 	}
 
 private:
+	static bool IsTaken(BucketState s) {
+		return ((uint8_t)s & 0x80) == 0;
+	}
+
 	void Grow(int factor) {
 		// We simply move out the existing data, then we re-insert the old.
 		// This is extremely non-atomic and will need synchronization.
@@ -167,11 +338,11 @@ class DenseHashMap {
 		int oldCount = count_;
 		capacity_ *= factor;
 		map.resize(capacity_);
-		state.resize(capacity_);
+		state.resize(capacity_, BucketState::FREE);
 		count_ = 0;  // Insert will update it.
 		removedCount_ = 0;
 		for (size_t i = 0; i < old.size(); i++) {
-			if (oldState[i] == BucketState::TAKEN) {
+			if (IsTaken(oldState[i])) {
 				Insert(old[i].key, old[i].value);
 			}
 		}
@@ -188,31 +359,32 @@ class DenseHashMap {
 	int removedCount_ = 0;
 };
 
-// Like the above, uses linear probing for cache-friendliness.
+// Like the above, a Swiss table.
 // Does not perform hashing at all so expects well-distributed keys.
 template <class Value, Value NullValue>
 class PrehashMap {
 public:
-	PrehashMap(int initialCapacity) : capacity_(initialCapacity) {
-		map.resize(initialCapacity);
-		state.resize(initialCapacity);
+	PrehashMap(int initialCapacity) : capacity_(HashMapCapacity(initialCapacity)) {
+		map.resize(capacity_);
+		state.resize(capacity_, BucketState::FREE);
 	}
 
 	// Returns nullptr if no entry was found.
 	Value Get(uint32_t hash) {
-		uint32_t mask = capacity_ - 1;
-		uint32_t pos = hash & mask;
-		// No? Let's go into search mode. Linear probing.
-		uint32_t p = pos;
+		uint8_t h2 = HashControl(hash);
+		HashProbe probe(hash, capacity_);
 		while (true) {
-			if (state[p] == BucketState::TAKEN && hash == map[p].hash)
-				return map[p].value;
-			else if (state[p] == BucketState::FREE)
-				return NullValue;
-			p = (p + 1) & mask;  // If the state is REMOVED, we just keep on walking. 
-			if (p == pos) {
-				_assert_msg_(false, "PrehashMap: Hit full on Get()");
+			HashGroup group(&state[probe.Offset()]);
+			HashGroupMatch match = group.Match(h2);
+			while (match.Any()) {
+				uint32_t p = probe.Offset() + match.Next();
+				if (hash == map[p].hash)
+					return map[p].value;
 			}
+			if (group.MatchFree().Any())
+				return NullValue;
+			probe.Next();
+			_dbg_assert_msg_(probe.stride < (uint32_t)capacity_ / HASHMAP_GROUP_SIZE, "PrehashMap: Hit full on Get()");
 		}
 		return NullValue;
 	}
@@ -220,52 +392,63 @@ class PrehashMap {
 	// Returns false if we already had the key! Which is a bit different.
 	bool Insert(uint32_t hash, Value value) {
 		// Check load factor, resize if necessary. We never shrink.
-		if (count_ > capacity_ / 2) {
-			Grow(2);
+		if ((count_ + removedCount_ + 1) * 8 > capacity_ * 7) {
+			Grow(count_ * 16 >= capacity_ * 7 ? 2 : 1);
 		}
-		uint32_t mask = capacity_ - 1;
-		uint32_t pos = hash & mask;
-		uint32_t p = pos;
-		while (state[p] != BucketState::FREE) {
-			if (state[p] == BucketState::TAKEN) {
+		uint8_t h2 = HashControl(hash);
+		HashProbe probe(hash, capacity_);
+		uint32_t target = 0xFFFFFFFF;
+		while (true) {
+			HashGroup group(&state[probe.Offset()]);
+			HashGroupMatch match = group.Match(h2);
+			while (match.Any()) {
+				uint32_t p = probe.Offset() + match.Next();
 				if (hash == map[p].hash)
 					return false;  // Bad!
-			} else {
-				// Got a place, either removed or FREE.
-				break;
-			}
-			p = (p + 1) & mask;
-			if (p == pos) {
-				// FULL! Error. Should not happen thanks to Grow().
-				_assert_msg_(false, "PrehashMap: Hit full on Insert()");
 			}
+			HashGroupMatch available = group.MatchAvailable();
+			if (target == 0xFFFFFFFF && available.Any())
+				target = probe.Offset() + available.Next();
+			if (group.MatchFree().Any())
+				break;
+			probe.Next();
+			// FULL! Error. Should not happen thanks to Grow().
+			_assert_msg_(probe.stride < (uint32_t)capacity_ / HASHMAP_GROUP_SIZE, "PrehashMap: Hit full on Insert()");
 		}
-		if (state[p] == BucketState::REMOVED) {
+		if (state[target] == BucketState::REMOVED) {
 			removedCount_--;
 		}
-		state[p] = BucketState::TAKEN;
-		map[p].hash = hash;
-		map[p].value = value;
+		state[target] = (BucketState)h2;
+		map[target].hash = hash;
+		map[target].value = value;
 		count_++;
 		return true;
 	}
 
 	bool Remove(uint32_t hash) {
-		uint32_t mask = capacity_ - 1;
-		uint32_t pos = hash & mask;
-		uint32_t p = pos;
-		while (state[p] != BucketState::FREE) {
-			if (state[p] == BucketState::TAKEN && hash == map[p].hash) {
-				// Got it!
-				state[p] = BucketState::REMOVED;
-				removedCount_++;
-				count_--;
-				return true;
-			}
-			p = (p + 1) & mask;
-			if (p == pos) {
-				_assert_msg_(false, "PrehashMap: Hit full on Remove()");
+		uint8_t h2 = HashControl(hash);
+		HashProbe probe(hash, capacity_);
+		while (true) {
+			HashGroup group(&state[probe.Offset()]);
+			HashGroupMatch match = group.Match(h2);
+			while (match.Any()) {
+				uint32_t p = probe.Offset() + match.Next();
+				if (hash == map[p].hash) {
+					// Got it!
+					if (group.MatchFree().Any()) {
+						state[p] = BucketState::FREE;
+					} else {
+						state[p] = BucketState::REMOVED;
+						removedCount_++;
+					}
+					count_--;
+					return true;
+				}
 			}
+			if (group.MatchFree().Any())
+				return false;
+			probe.Next();
+			_dbg_assert_msg_(probe.stride < (uint32_t)capacity_ / HASHMAP_GROUP_SIZE, "PrehashMap: Hit full on Remove()");
 		}
 		return false;
 	}
@@ -277,7 +460,7 @@ class PrehashMap {
 	template<class T>
 	void Iterate(T func) const {
 		for (size_t i = 0; i < map.size(); i++) {
-			if (state[i] == BucketState::TAKEN) {
+			if (IsTaken(state[i])) {
 				func(map[i].hash, map[i].value);
 			}
 		}
@@ -302,6 +485,10 @@ class PrehashMap {
 	}
 
 private:
+	static bool IsTaken(BucketState s) {
+		return ((uint8_t)s & 0x80) == 0;
+	}
+
 	void Grow(int factor) {
 		// We simply move out the existing data, then we re-insert the old.
 		// This is extremely non-atomic and will need synchronization.
@@ -315,15 +502,16 @@ class PrehashMap {
 		int oldCapacity = capacity_;
 		capacity_ *= factor;
 		map.resize(capacity_);
-		state.resize(capacity_);
+		state.resize(capacity_, BucketState::FREE);
 		count_ = 0;  // Insert will update it.
 		removedCount_ = 0;
 		for (size_t i = 0; i < old.size(); i++) {
-			if (oldState[i] == BucketState::TAKEN) {
+			if (IsTaken(oldState[i])) {
 				Insert(old[i].hash, old[i].value);
 			}
 		}
-		INFO_LOG(G3D, "Grew hashmap capacity from %d to %d", oldCapacity, capacity_);
+		if (oldCapacity != capacity_)
+			INFO_LOG(G3D, "Grew hashmap capacity from %d to %d", oldCapacity, capacity_);
 		_assert_msg_(oldCount == count_, "PrehashMap: count should not change in Grow()");
 	}
 	struct Pair {
@@ -23,7 +23,7 @@
 
 #ifdef _M_SSE
 #include <emmintrin.h>
-#include <smmintrin.h>
+#include <immintrin.h>
 #endif
 
 #if PPSSPP_ARCH(ARM_NEON)
@@ -34,227 +34,493 @@
 #endif
 #endif
 
-void ConvertBGRA8888ToRGBA8888(u32 *dst, const u32 *src, u32 numPixels) {
-#ifdef _M_SSE
-	const __m128i maskGA = _mm_set1_epi32(0xFF00FF00);
+// The bulk 16 <-> 32-bit converters all share a few generic kernels, described by where each
+// channel sits in the 16-bit format. Each kernel returns how many pixels it handled, and the
+// public functions finish the tail with their scalar loops.
+// SSE2 is the x86 baseline, AVX2 is picked at runtime from cpu_info, and NEON is compile-time like elsewhere.
+
+// Bits of 0 means the channel is missing (alpha is then opaque.)
+template <int RS, int RB, int GS, int GB, int BS, int BB, int AS, int AB>
+struct Format16 {
+	enum {
+		RShift = RS, RBits = RB,
+		GShift = GS, GBits = GB,
+		BShift = BS, BBits = BB,
+		AShift = AS, ABits = AB,
+	};
+};
+
+typedef Format16<0, 5, 5, 6, 11, 5, 0, 0> FormatRGB565;
+typedef Format16<0, 5, 5, 5, 10, 5, 15, 1> FormatRGBA5551;
+typedef Format16<0, 4, 4, 4, 8, 4, 12, 4> FormatRGBA4444;
+typedef Format16<11, 5, 5, 6, 0, 5, 0, 0> FormatBGR565;
+typedef Format16<11, 5, 6, 5, 1, 5, 0, 1> FormatABGR1555;
+typedef Format16<12, 4, 8, 4, 4, 4, 0, 4> FormatABGR4444;
 
-	const __m128i *srcp = (const __m128i *)src;
-	__m128i *dstp = (__m128i *)dst;
-	u32 sseChunks = numPixels / 4;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst & 0xF)) {
-		sseChunks = 0;
-	}
-	for (u32 i = 0; i < sseChunks; ++i) {
-		__m128i c = _mm_load_si128(&srcp[i]);
-		__m128i rb = _mm_andnot_si128(maskGA, c);
-		c = _mm_and_si128(c, maskGA);
+#if defined(_M_SSE)
 
-		__m128i b = _mm_srli_epi32(rb, 16);
-		__m128i r = _mm_slli_epi32(rb, 16);
-		c = _mm_or_si128(_mm_or_si128(c, r), b);
-		_mm_store_si128(&dstp[i], c);
-	}
-	// The remainder starts right after those done via SSE.
-	u32 i = sseChunks * 4;
+#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
+#define COLORCONV_TARGET(x) [[gnu::target(x)]]
 #else
-	u32 i = 0;
+#define COLORCONV_TARGET(x)
 #endif
-	for (; i < numPixels; i++) {
-		const u32 c = src[i];
-		dst[i] = ((c >> 16) & 0x000000FF) |
-			(c & 0xFF00FF00) |
-			((c << 16) & 0x00FF0000);
+
+template <int N>
+inline __m128i ShiftRight16(__m128i v) {
+	if constexpr (N > 0)
+		return _mm_srli_epi16(v, N);
+	else if constexpr (N < 0)
+		return _mm_slli_epi16(v, -N);
+	else
+		return v;
+}
+
+template <int N>
+inline __m128i ShiftRight32(__m128i v) {
+	if constexpr (N > 0)
+		return _mm_srli_epi32(v, N);
+	else if constexpr (N < 0)
+		return _mm_slli_epi32(v, -N);
+	else
+		return v;
+}
+
+// Extracts a channel and widens it to 8 bits, in the low byte of each 16-bit lane.
+template <int Shift, int Bits>
+inline __m128i ExpandChannel16(__m128i c) {
+	if constexpr (Bits == 0) {
+		return _mm_set1_epi16(0x00FF);
+	} else {
+		__m128i v = ShiftRight16<Shift>(c);
+		if constexpr (Shift + Bits != 16)
+			v = _mm_and_si128(v, _mm_set1_epi16((1 << Bits) - 1));
+		if constexpr (Bits == 1)
+			return _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), v), _mm_set1_epi16(0x00FF));
+		else if constexpr (Bits == 4)
+			return _mm_or_si128(v, _mm_slli_epi16(v, 4));
+		else
+			return _mm_or_si128(_mm_slli_epi16(v, 8 - Bits), _mm_srli_epi16(v, 2 * Bits - 8));
 	}
 }
 
-void ConvertBGRA8888ToRGB888(u8 *dst, const u32 *src, u32 numPixels) {
-	for (uint32_t x = 0; x < numPixels; ++x) {
-		uint32_t c = src[x];
-		dst[x * 3 + 0] = (c >> 16) & 0xFF;
-		dst[x * 3 + 1] = (c >> 8) & 0xFF;
-		dst[x * 3 + 2] = (c >> 0) & 0xFF;
+// Takes the top Bits of the byte at SrcByte and moves them to DstShift.
+template <int SrcByte, int Bits, int DstShift>
+inline __m128i PackChannel32(__m128i c) {
+	if constexpr (Bits == 0) {
+		return _mm_setzero_si128();
+	} else {
+		__m128i v = ShiftRight32<SrcByte * 8 + 8 - Bits - DstShift>(c);
+		return _mm_and_si128(v, _mm_set1_epi32(((1 << Bits) - 1) << DstShift));
 	}
 }
 
-#if defined(_M_SSE)
-#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
-[[gnu::target("sse4.1")]]
-#endif
-static inline void ConvertRGBA8888ToRGBA5551_SSE4(__m128i *dstp, const __m128i *srcp, u32 sseChunks) {
-	const __m128i maskAG = _mm_set1_epi32(0x8000F800);
-	const __m128i maskRB = _mm_set1_epi32(0x00F800F8);
-	const __m128i mask = _mm_set1_epi32(0x0000FFFF);
+template <typename Fmt, bool BGRA>
+static u32 ConvertExpand16To32_SSE2(u32 *dst, const u16 *src, u32 numPixels) {
+	const u32 blocks = numPixels / 8;
+	for (u32 i = 0; i < blocks; ++i) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)src + i);
+		const __m128i r = ExpandChannel16<Fmt::RShift, Fmt::RBits>(c);
+		const __m128i g = ExpandChannel16<Fmt::GShift, Fmt::GBits>(c);
+		const __m128i b = ExpandChannel16<Fmt::BShift, Fmt::BBits>(c);
+		const __m128i a = ExpandChannel16<Fmt::AShift, Fmt::ABits>(c);
+
+		// RRGG RRGG and BBAA BBAA (or BBGG and RRAA), then interleave.
+		const __m128i lo = _mm_or_si128(BGRA ? b : r, _mm_slli_epi16(g, 8));
+		const __m128i hi = _mm_or_si128(BGRA ? r : b, _mm_slli_epi16(a, 8));
+		_mm_storeu_si128((__m128i *)dst + i * 2 + 0, _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128((__m128i *)dst + i * 2 + 1, _mm_unpackhi_epi16(lo, hi));
+	}
+	return blocks * 8;
+}
+
+template <typename Fmt, bool BGRA>
+inline __m128i PackPixels32(__m128i c) {
+	const int rByte = BGRA ? 2 : 0;
+	const int bByte = BGRA ? 0 : 2;
+	__m128i v = _mm_or_si128(PackChannel32<rByte, Fmt::RBits, Fmt::RShift>(c), PackChannel32<1, Fmt::GBits, Fmt::GShift>(c));
+	v = _mm_or_si128(v, PackChannel32<bByte, Fmt::BBits, Fmt::BShift>(c));
+	v = _mm_or_si128(v, PackChannel32<3, Fmt::ABits, Fmt::AShift>(c));
+	// Sign extend so the saturating pack keeps all 16 bits (SSE2 has no _mm_packus_epi32.)
+	return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+}
 
-	for (u32 i = 0; i < sseChunks; i += 2) {
-		__m128i c1 = _mm_load_si128(&srcp[i + 0]);
-		__m128i c2 = _mm_load_si128(&srcp[i + 1]);
-		__m128i ag, rb;
+template <typename Fmt, bool BGRA>
+static u32 ConvertPack32To16_SSE2(u16 *dst, const u32 *src, u32 numPixels) {
+	const u32 blocks = numPixels / 8;
+	for (u32 i = 0; i < blocks; ++i) {
+		const __m128i c1 = PackPixels32<Fmt, BGRA>(_mm_loadu_si128((const __m128i *)src + i * 2 + 0));
+		const __m128i c2 = PackPixels32<Fmt, BGRA>(_mm_loadu_si128((const __m128i *)src + i * 2 + 1));
+		_mm_storeu_si128((__m128i *)dst + i, _mm_packs_epi32(c1, c2));
+	}
+	return blocks * 8;
+}
 
-		ag = _mm_and_si128(c1, maskAG);
-		ag = _mm_or_si128(_mm_srli_epi32(ag, 16), _mm_srli_epi32(ag, 6));
-		rb = _mm_and_si128(c1, maskRB);
-		rb = _mm_or_si128(_mm_srli_epi32(rb, 3), _mm_srli_epi32(rb, 9));
-		c1 = _mm_and_si128(_mm_or_si128(ag, rb), mask);
+// AVX2 versions of the above. These need to be separate since every helper needs the target attribute.
+template <int N>
+COLORCONV_TARGET("avx2") inline __m256i ShiftRight16_AVX2(__m256i v) {
+	if constexpr (N > 0)
+		return _mm256_srli_epi16(v, N);
+	else if constexpr (N < 0)
+		return _mm256_slli_epi16(v, -N);
+	else
+		return v;
+}
 
-		ag = _mm_and_si128(c2, maskAG);
-		ag = _mm_or_si128(_mm_srli_epi32(ag, 16), _mm_srli_epi32(ag, 6));
-		rb = _mm_and_si128(c2, maskRB);
-		rb = _mm_or_si128(_mm_srli_epi32(rb, 3), _mm_srli_epi32(rb, 9));
-		c2 = _mm_and_si128(_mm_or_si128(ag, rb), mask);
+template <int N>
+COLORCONV_TARGET("avx2") inline __m256i ShiftRight32_AVX2(__m256i v) {
+	if constexpr (N > 0)
+		return _mm256_srli_epi32(v, N);
+	else if constexpr (N < 0)
+		return _mm256_slli_epi32(v, -N);
+	else
+		return v;
+}
 
-		_mm_store_si128(&dstp[i / 2], _mm_packus_epi32(c1, c2));
+template <int Shift, int Bits>
+COLORCONV_TARGET("avx2") inline __m256i ExpandChannel16_AVX2(__m256i c) {
+	if constexpr (Bits == 0) {
+		return _mm256_set1_epi16(0x00FF);
+	} else {
+		__m256i v = ShiftRight16_AVX2<Shift>(c);
+		if constexpr (Shift + Bits != 16)
+			v = _mm256_and_si256(v, _mm256_set1_epi16((1 << Bits) - 1));
+		if constexpr (Bits == 1)
+			return _mm256_and_si256(_mm256_sub_epi16(_mm256_setzero_si256(), v), _mm256_set1_epi16(0x00FF));
+		else if constexpr (Bits == 4)
+			return _mm256_or_si256(v, _mm256_slli_epi16(v, 4));
+		else
+			return _mm256_or_si256(_mm256_slli_epi16(v, 8 - Bits), _mm256_srli_epi16(v, 2 * Bits - 8));
 	}
 }
-#endif
 
-void ConvertRGBA8888ToRGBA5551(u16 *dst, const u32 *src, u32 numPixels) {
-#if defined(_M_SSE)
-	const __m128i *srcp = (const __m128i *)src;
-	__m128i *dstp = (__m128i *)dst;
-	u32 sseChunks = (numPixels / 4) & ~1;
-	// SSE 4.1 required for _mm_packus_epi32.
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst & 0xF) || !cpu_info.bSSE4_1) {
-		sseChunks = 0;
+template <int SrcByte, int Bits, int DstShift>
+COLORCONV_TARGET("avx2") inline __m256i PackChannel32_AVX2(__m256i c) {
+	if constexpr (Bits == 0) {
+		return _mm256_setzero_si256();
 	} else {
-		ConvertRGBA8888ToRGBA5551_SSE4(dstp, srcp, sseChunks);
+		__m256i v = ShiftRight32_AVX2<SrcByte * 8 + 8 - Bits - DstShift>(c);
+		return _mm256_and_si256(v, _mm256_set1_epi32(((1 << Bits) - 1) << DstShift));
 	}
+}
 
-	// The remainder starts right after those done via SSE.
-	u32 i = sseChunks * 4;
-#else
+template <typename Fmt, bool BGRA>
+COLORCONV_TARGET("avx2") static u32 ConvertExpand16To32_AVX2(u32 *dst, const u16 *src, u32 numPixels) {
+	const u32 blocks = numPixels / 16;
+	for (u32 i = 0; i < blocks; ++i) {
+		const __m256i c = _mm256_loadu_si256((const __m256i *)src + i);
+		const __m256i r = ExpandChannel16_AVX2<Fmt::RShift, Fmt::RBits>(c);
+		const __m256i g = ExpandChannel16_AVX2<Fmt::GShift, Fmt::GBits>(c);
+		const __m256i b = ExpandChannel16_AVX2<Fmt::BShift, Fmt::BBits>(c);
+		const __m256i a = ExpandChannel16_AVX2<Fmt::AShift, Fmt::ABits>(c);
+
+		const __m256i lo = _mm256_or_si256(BGRA ? b : r, _mm256_slli_epi16(g, 8));
+		const __m256i hi = _mm256_or_si256(BGRA ? r : b, _mm256_slli_epi16(a, 8));
+		// Unpack works within 128-bit lanes, so put the halves back in order.
+		const __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+		const __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+		_mm256_storeu_si256((__m256i *)dst + i * 2 + 0, _mm256_permute2x128_si256(p0, p1, 0x20));
+		_mm256_storeu_si256((__m256i *)dst + i * 2 + 1, _mm256_permute2x128_si256(p0, p1, 0x31));
+	}
+	return blocks * 16;
+}
+
+template <typename Fmt, bool BGRA>
+COLORCONV_TARGET("avx2") inline __m256i PackPixels32_AVX2(__m256i c) {
+	const int rByte = BGRA ? 2 : 0;
+	const int bByte = BGRA ? 0 : 2;
+	__m256i v = _mm256_or_si256(PackChannel32_AVX2<rByte, Fmt::RBits, Fmt::RShift>(c), PackChannel32_AVX2<1, Fmt::GBits, Fmt::GShift>(c));
+	v = _mm256_or_si256(v, PackChannel32_AVX2<bByte, Fmt::BBits, Fmt::BShift>(c));
+	v = _mm256_or_si256(v, PackChannel32_AVX2<3, Fmt::ABits, Fmt::AShift>(c));
+	return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+}
+
+template <typename Fmt, bool BGRA>
+COLORCONV_TARGET("avx2") static u32 ConvertPack32To16_AVX2(u16 *dst, const u32 *src, u32 numPixels) {
+	const u32 blocks = numPixels / 16;
+	for (u32 i = 0; i < blocks; ++i) {
+		const __m256i c1 = PackPixels32_AVX2<Fmt, BGRA>(_mm256_loadu_si256((const __m256i *)src + i * 2 + 0));
+		const __m256i c2 = PackPixels32_AVX2<Fmt, BGRA>(_mm256_loadu_si256((const __m256i *)src + i * 2 + 1));
+		// Pack also works within lanes, 0xD8 restores the order of the 64-bit quarters.
+		_mm256_storeu_si256((__m256i *)dst + i, _mm256_permute4x64_epi64(_mm256_packs_epi32(c1, c2), 0xD8));
+	}
+	return blocks * 16;
+}
+
+#elif PPSSPP_ARCH(ARM_NEON)
+
+template <int N>
+inline uint16x8_t ShiftRight16(uint16x8_t v) {
+	if constexpr (N > 0)
+		return vshrq_n_u16(v, N);
+	else if constexpr (N < 0)
+		return vshlq_n_u16(v, -N);
+	else
+		return v;
+}
+
+template <int N>
+inline uint32x4_t ShiftRight32(uint32x4_t v) {
+	if constexpr (N > 0)
+		return vshrq_n_u32(v, N);
+	else if constexpr (N < 0)
+		return vshlq_n_u32(v, -N);
+	else
+		return v;
+}
+
+template <int Shift, int Bits>
+inline uint16x8_t ExpandChannel16(uint16x8_t c) {
+	if constexpr (Bits == 0) {
+		return vdupq_n_u16(0x00FF);
+	} else {
+		uint16x8_t v = ShiftRight16<Shift>(c);
+		if constexpr (Shift + Bits != 16)
+			v = vandq_u16(v, vdupq_n_u16((1 << Bits) - 1));
+		if constexpr (Bits == 1)
+			return vandq_u16(vsubq_u16(vdupq_n_u16(0), v), vdupq_n_u16(0x00FF));
+		else if constexpr (Bits == 4)
+			return vorrq_u16(v, vshlq_n_u16(v, 4));
+		else
+			return vorrq_u16(vshlq_n_u16(v, 8 - Bits), vshrq_n_u16(v, 2 * Bits - 8));
+	}
+}
+
+template <int SrcByte, int Bits, int DstShift>
+inline uint32x4_t PackChannel32(uint32x4_t c) {
+	if constexpr (Bits == 0) {
+		return vdupq_n_u32(0);
+	} else {
+		uint32x4_t v = ShiftRight32<SrcByte * 8 + 8 - Bits - DstShift>(c);
+		return vandq_u32(v, vdupq_n_u32(((1 << Bits) - 1) << DstShift));
+	}
+}
+
+template <typename Fmt, bool BGRA>
+static u32 ConvertExpand16To32_NEON(u32 *dst, const u16 *src, u32 numPixels) {
+	const u32 blocks = numPixels / 8;
+	for (u32 i = 0; i < blocks; ++i) {
+		const uint16x8_t c = vld1q_u16(src + i * 8);
+		const uint16x8_t r = ExpandChannel16<Fmt::RShift, Fmt::RBits>(c);
+		const uint16x8_t g = ExpandChannel16<Fmt::GShift, Fmt::GBits>(c);
+		const uint16x8_t b = ExpandChannel16<Fmt::BShift, Fmt::BBits>(c);
+		const uint16x8_t a = ExpandChannel16<Fmt::AShift, Fmt::ABits>(c);
+
+		// The interleaving store does the unpack for us.
+		uint16x8x2_t res;
+		res.val[0] = vorrq_u16(BGRA ? b : r, vshlq_n_u16(g, 8));
+		res.val[1] = vorrq_u16(BGRA ? r : b, vshlq_n_u16(a, 8));
+		vst2q_u16((u16 *)(dst + i * 8), res);
+	}
+	return blocks * 8;
+}
+
+template <typename Fmt, bool BGRA>
+inline uint16x4_t PackPixels32(uint32x4_t c) {
+	const int rByte = BGRA ? 2 : 0;
+	const int bByte = BGRA ? 0 : 2;
+	uint32x4_t v = vorrq_u32(PackChannel32<rByte, Fmt::RBits, Fmt::RShift>(c), PackChannel32<1, Fmt::GBits, Fmt::GShift>(c));
+	v = vorrq_u32(v, PackChannel32<bByte, Fmt::BBits, Fmt::BShift>(c));
+	v = vorrq_u32(v, PackChannel32<3, Fmt::ABits, Fmt::AShift>(c));
+	return vmovn_u32(v);
+}
+
+template <typename Fmt, bool BGRA>
+static u32 ConvertPack32To16_NEON(u16 *dst, const u32 *src, u32 numPixels) {
+	const u32 blocks = numPixels / 8;
+	for (u32 i = 0; i < blocks; ++i) {
+		const uint16x4_t c1 = PackPixels32<Fmt, BGRA>(vld1q_u32(src + i * 8 + 0));
+		const uint16x4_t c2 = PackPixels32<Fmt, BGRA>(vld1q_u32(src + i * 8 + 4));
+		vst1q_u16(dst + i * 8, vcombine_u16(c1, c2));
+	}
+	return blocks * 8;
+}
+
+#endif
+
+template <typename Fmt, bool BGRA>
+static u32 ConvertExpand16To32(u32 *dst, const u16 *src, u32 numPixels) {
 	u32 i = 0;
+#if defined(_M_SSE)
+	if (cpu_info.bAVX2)
+		i = ConvertExpand16To32_AVX2<Fmt, BGRA>(dst, src, numPixels);
+	i += ConvertExpand16To32_SSE2<Fmt, BGRA>(dst + i, src + i, numPixels - i);
+#elif PPSSPP_ARCH(ARM_NEON)
+	i = ConvertExpand16To32_NEON<Fmt, BGRA>(dst, src, numPixels);
 #endif
-	for (; i < numPixels; i++) {
-		dst[i] = RGBA8888toRGBA5551(src[i]);
-	}
+	return i;
 }
 
+template <typename Fmt, bool BGRA>
+static u32 ConvertPack32To16(u16 *dst, const u32 *src, u32 numPixels) {
+	u32 i = 0;
 #if defined(_M_SSE)
-#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
-[[gnu::target("sse4.1")]]
+	if (cpu_info.bAVX2)
+		i = ConvertPack32To16_AVX2<Fmt, BGRA>(dst, src, numPixels);
+	i += ConvertPack32To16_SSE2<Fmt, BGRA>(dst + i, src + i, numPixels - i);
+#elif PPSSPP_ARCH(ARM_NEON)
+	i = ConvertPack32To16_NEON<Fmt, BGRA>(dst, src, numPixels);
 #endif
-static inline void ConvertBGRA8888ToRGBA5551_SSE4(__m128i *dstp, const __m128i *srcp, u32 sseChunks) {
-	const __m128i maskAG = _mm_set1_epi32(0x8000F800);
-	const __m128i maskRB = _mm_set1_epi32(0x00F800F8);
-	const __m128i mask = _mm_set1_epi32(0x0000FFFF);
+	return i;
+}
 
-	for (u32 i = 0; i < sseChunks; i += 2) {
-		__m128i c1 = _mm_load_si128(&srcp[i + 0]);
-		__m128i c2 = _mm_load_si128(&srcp[i + 1]);
-		__m128i ag, rb;
+#if defined(_M_SSE)
+COLORCONV_TARGET("avx2") static u32 ConvertBGRA8888ToRGBA8888_AVX2(u32 *dst, const u32 *src, u32 numPixels) {
+	const __m256i maskGA = _mm256_set1_epi32(0xFF00FF00);
+	const u32 blocks = numPixels / 8;
+	for (u32 i = 0; i < blocks; ++i) {
+		__m256i c = _mm256_loadu_si256((const __m256i *)src + i);
+		__m256i rb = _mm256_andnot_si256(maskGA, c);
+		c = _mm256_and_si256(c, maskGA);
+		c = _mm256_or_si256(c, _mm256_or_si256(_mm256_slli_epi32(rb, 16), _mm256_srli_epi32(rb, 16)));
+		_mm256_storeu_si256((__m256i *)dst + i, c);
+	}
+	return blocks * 8;
+}
+
+// Packs 4 pixels into 12 bytes. RIndex is the byte that becomes the first output byte.
+template <int RIndex>
+COLORCONV_TARGET("ssse3") static u32 ConvertToRGB888_SSSE3(u8 *dst, const u32 *src, u32 numPixels) {
+	const int BIndex = 2 - RIndex;
+	const __m128i shuffle = _mm_setr_epi8(
+		RIndex, 1, BIndex, 4 + RIndex, 5, 4 + BIndex, 8 + RIndex, 9, 8 + BIndex, 12 + RIndex, 13, 12 + BIndex,
+		-1, -1, -1, -1);
+	const u32 blocks = numPixels / 4;
+	for (u32 i = 0; i < blocks; ++i) {
+		const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src + i), shuffle);
+		_mm_storel_epi64((__m128i *)(dst + i * 12), c);
+		const u32 last = (u32)_mm_cvtsi128_si32(_mm_srli_si128(c, 8));
+		memcpy(dst + i * 12 + 8, &last, 4);
+	}
+	return blocks * 4;
+}
+#endif
 
-		ag = _mm_and_si128(c1, maskAG);
-		ag = _mm_or_si128(_mm_srli_epi32(ag, 16), _mm_srli_epi32(ag, 6));
-		rb = _mm_and_si128(c1, maskRB);
-		rb = _mm_or_si128(_mm_srli_epi32(rb, 19), _mm_slli_epi32(rb, 7));
-		c1 = _mm_and_si128(_mm_or_si128(ag, rb), mask);
+void ConvertBGRA8888ToRGBA8888(u32 *dst, const u32 *src, u32 numPixels) {
+#ifdef _M_SSE
+	u32 i = 0;
+	if (cpu_info.bAVX2)
+		i = ConvertBGRA8888ToRGBA8888_AVX2(dst, src, numPixels);
 
-		ag = _mm_and_si128(c2, maskAG);
-		ag = _mm_or_si128(_mm_srli_epi32(ag, 16), _mm_srli_epi32(ag, 6));
-		rb = _mm_and_si128(c2, maskRB);
-		rb = _mm_or_si128(_mm_srli_epi32(rb, 19), _mm_slli_epi32(rb, 7));
-		c2 = _mm_and_si128(_mm_or_si128(ag, rb), mask);
+	const __m128i maskGA = _mm_set1_epi32(0xFF00FF00);
+	for (; i + 4 <= numPixels; i += 4) {
+		__m128i c = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i rb = _mm_andnot_si128(maskGA, c);
+		c = _mm_and_si128(c, maskGA);
 
-		_mm_store_si128(&dstp[i / 2], _mm_packus_epi32(c1, c2));
+		__m128i b = _mm_srli_epi32(rb, 16);
+		__m128i r = _mm_slli_epi32(rb, 16);
+		c = _mm_or_si128(_mm_or_si128(c, r), b);
+		_mm_storeu_si128((__m128i *)(dst + i), c);
 	}
-}
+#elif PPSSPP_ARCH(ARM_NEON)
+	u32 i = 0;
+	for (; i + 16 <= numPixels; i += 16) {
+		uint8x16x4_t c = vld4q_u8((const u8 *)(src + i));
+		uint8x16_t r = c.val[0];
+		c.val[0] = c.val[2];
+		c.val[2] = r;
+		vst4q_u8((u8 *)(dst + i), c);
+	}
+#else
+	u32 i = 0;
 #endif
+	for (; i < numPixels; i++) {
+		const u32 c = src[i];
+		dst[i] = ((c >> 16) & 0x000000FF) |
+			(c & 0xFF00FF00) |
+			((c << 16) & 0x00FF0000);
+	}
+}
 
-void ConvertBGRA8888ToRGBA5551(u16 *dst, const u32 *src, u32 numPixels) {
+void ConvertBGRA8888ToRGB888(u8 *dst, const u32 *src, u32 numPixels) {
 #if defined(_M_SSE)
-	const __m128i *srcp = (const __m128i *)src;
-	__m128i *dstp = (__m128i *)dst;
-	u32 sseChunks = (numPixels / 4) & ~1;
-	// SSE 4.1 required for _mm_packus_epi32.
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst & 0xF) || !cpu_info.bSSE4_1) {
-		sseChunks = 0;
-	} else {
-		ConvertBGRA8888ToRGBA5551_SSE4(dstp, srcp, sseChunks);
+	u32 x = cpu_info.bSSSE3 ? ConvertToRGB888_SSSE3<2>(dst, src, numPixels) : 0;
+#elif PPSSPP_ARCH(ARM_NEON)
+	u32 x = 0;
+	for (; x + 16 <= numPixels; x += 16) {
+		const uint8x16x4_t c = vld4q_u8((const u8 *)(src + x));
+		uint8x16x3_t res;
+		res.val[0] = c.val[2];
+		res.val[1] = c.val[1];
+		res.val[2] = c.val[0];
+		vst3q_u8(dst + x * 3, res);
 	}
-
-	// The remainder starts right after those done via SSE.
-	u32 i = sseChunks * 4;
 #else
-	u32 i = 0;
+	u32 x = 0;
 #endif
+	for (; x < numPixels; ++x) {
+		uint32_t c = src[x];
+		dst[x * 3 + 0] = (c >> 16) & 0xFF;
+		dst[x * 3 + 1] = (c >> 8) & 0xFF;
+		dst[x * 3 + 2] = (c >> 0) & 0xFF;
+	}
+}
+
+void ConvertRGBA8888ToRGBA5551(u16 *dst, const u32 *src, u32 numPixels) {
+	u32 i = ConvertPack32To16<FormatRGBA5551, false>(dst, src, numPixels);
+	for (; i < numPixels; i++) {
+		dst[i] = RGBA8888toRGBA5551(src[i]);
+	}
+}
+
+void ConvertBGRA8888ToRGBA5551(u16 *dst, const u32 *src, u32 numPixels) {
+	u32 i = ConvertPack32To16<FormatRGBA5551, true>(dst, src, numPixels);
 	for (; i < numPixels; i++) {
 		dst[i] = BGRA8888toRGBA5551(src[i]);
 	}
 }
 
 void ConvertBGRA8888ToRGB565(u16 *dst, const u32 *src, u32 numPixels) {
-	for (u32 i = 0; i < numPixels; i++) {
+	u32 i = ConvertPack32To16<FormatRGB565, true>(dst, src, numPixels);
+	for (; i < numPixels; i++) {
 		dst[i] = BGRA8888toRGB565(src[i]);
 	}
 }
 
 void ConvertBGRA8888ToRGBA4444(u16 *dst, const u32 *src, u32 numPixels) {
-	for (u32 i = 0; i < numPixels; i++) {
+	u32 i = ConvertPack32To16<FormatRGBA4444, true>(dst, src, numPixels);
+	for (; i < numPixels; i++) {
 		dst[i] = BGRA8888toRGBA4444(src[i]);
 	}
 }
 
 void ConvertRGBA8888ToRGB565(u16 *dst, const u32 *src, u32 numPixels) {
-	for (u32 x = 0; x < numPixels; ++x) {
+	u32 x = ConvertPack32To16<FormatRGB565, false>(dst, src, numPixels);
+	for (; x < numPixels; ++x) {
 		dst[x] = RGBA8888toRGB565(src[x]);
 	}
 }
 
 void ConvertRGBA8888ToRGBA4444(u16 *dst, const u32 *src, u32 numPixels) {
-	for (u32 x = 0; x < numPixels; ++x) {
+	u32 x = ConvertPack32To16<FormatRGBA4444, false>(dst, src, numPixels);
+	for (; x < numPixels; ++x) {
 		dst[x] = RGBA8888toRGBA4444(src[x]);
 	}
 }
 
 void ConvertRGBA8888ToRGB888(u8 *dst, const u32 *src, u32 numPixels) {
-	for (uint32_t x = 0; x < numPixels; ++x) {
+#if defined(_M_SSE)
+	u32 x = cpu_info.bSSSE3 ? ConvertToRGB888_SSSE3<0>(dst, src, numPixels) : 0;
+#elif PPSSPP_ARCH(ARM_NEON)
+	u32 x = 0;
+	for (; x + 16 <= numPixels; x += 16) {
+		const uint8x16x4_t c = vld4q_u8((const u8 *)(src + x));
+		uint8x16x3_t res;
+		res.val[0] = c.val[0];
+		res.val[1] = c.val[1];
+		res.val[2] = c.val[2];
+		vst3q_u8(dst + x * 3, res);
+	}
+#else
+	u32 x = 0;
+#endif
+	for (; x < numPixels; ++x) {
 		memcpy(dst + x * 3, src + x, 3);
 	}
 }
 
 void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
-#ifdef _M_SSE
-	const __m128i mask5 = _mm_set1_epi16(0x001f);
-	const __m128i mask6 = _mm_set1_epi16(0x003f);
-	const __m128i mask8 = _mm_set1_epi16(0x00ff);
-
-	const __m128i *srcp = (const __m128i *)src;
-	__m128i *dstp = (__m128i *)dst32;
-	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst32 & 0xF)) {
-		sseChunks = 0;
-	}
-	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
-
-		// Swizzle, resulting in RR00 RR00.
-		__m128i r = _mm_and_si128(c, mask5);
-		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
-		r = _mm_and_si128(r, mask8);
-
-		// This one becomes 00GG 00GG.
-		__m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), mask6);
-		g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
-		g = _mm_slli_epi16(g, 8);
-
-		// Almost done, we aim for BB00 BB00 again here.
-		__m128i b = _mm_and_si128(_mm_srli_epi16(c, 11), mask5);
-		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
-		b = _mm_and_si128(b, mask8);
-
-		// Always set alpha to 00FF 00FF.
-		__m128i a = _mm_slli_epi16(mask8, 8);
-
-		// Now combine them, RRGG RRGG and BBAA BBAA, and then interleave.
-		const __m128i rg = _mm_or_si128(r, g);
-		const __m128i ba = _mm_or_si128(b, a);
-		_mm_store_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
-		_mm_store_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
-	}
-	u32 i = sseChunks * 8;
-#else
-	u32 i = 0;
-#endif
+	u32 i = ConvertExpand16To32<FormatRGB565, false>(dst32, src, numPixels);
 
 	u8 *dst = (u8 *)dst32;
 	for (u32 x = i; x < numPixels; x++) {
@@ -267,48 +533,7 @@ void ConvertRGB565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 }
 
 void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
-#ifdef _M_SSE
-	const __m128i mask5 = _mm_set1_epi16(0x001f);
-	const __m128i mask8 = _mm_set1_epi16(0x00ff);
-
-	const __m128i *srcp = (const __m128i *)src;
-	__m128i *dstp = (__m128i *)dst32;
-	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst32 & 0xF)) {
-		sseChunks = 0;
-	}
-	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
-
-		// Swizzle, resulting in RR00 RR00.
-		__m128i r = _mm_and_si128(c, mask5);
-		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
-		r = _mm_and_si128(r, mask8);
-
-		// This one becomes 00GG 00GG.
-		__m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), mask5);
-		g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
-		g = _mm_slli_epi16(g, 8);
-
-		// Almost done, we aim for BB00 BB00 again here.
-		__m128i b = _mm_and_si128(_mm_srli_epi16(c, 10), mask5);
-		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
-		b = _mm_and_si128(b, mask8);
-
-		// 1 bit A to 00AA 00AA.
-		__m128i a = _mm_srai_epi16(c, 15);
-		a = _mm_slli_epi16(a, 8);
-
-		// Now combine them, RRGG RRGG and BBAA BBAA, and then interleave.
-		const __m128i rg = _mm_or_si128(r, g);
-		const __m128i ba = _mm_or_si128(b, a);
-		_mm_store_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
-		_mm_store_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
-	}
-	u32 i = sseChunks * 8;
-#else
-	u32 i = 0;
-#endif
+	u32 i = ConvertExpand16To32<FormatRGBA5551, false>(dst32, src, numPixels);
 
 	u8 *dst = (u8 *)dst32;
 	for (u32 x = i; x < numPixels; x++) {
@@ -321,43 +546,7 @@ void ConvertRGBA5551ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 }
 
 void ConvertRGBA4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
-#ifdef _M_SSE
-	const __m128i mask4 = _mm_set1_epi16(0x000f);
-
-	const __m128i *srcp = (const __m128i *)src;
-	__m128i *dstp = (__m128i *)dst32;
-	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst32 & 0xF)) {
-		sseChunks = 0;
-	}
-	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
-
-		// Let's just grab R000 R000, without swizzling yet.
-		__m128i r = _mm_and_si128(c, mask4);
-		// And then 00G0 00G0.
-		__m128i g = _mm_and_si128(_mm_srli_epi16(c, 4), mask4);
-		g = _mm_slli_epi16(g, 8);
-		// Now B000 B000.
-		__m128i b = _mm_and_si128(_mm_srli_epi16(c, 8), mask4);
-		// And lastly 00A0 00A0.  No mask needed, we have a wall.
-		__m128i a = _mm_srli_epi16(c, 12);
-		a = _mm_slli_epi16(a, 8);
-
-		// We swizzle after combining - R0G0 R0G0 and B0A0 B0A0 -> RRGG RRGG and BBAA BBAA.
-		__m128i rg = _mm_or_si128(r, g);
-		__m128i ba = _mm_or_si128(b, a);
-		rg = _mm_or_si128(rg, _mm_slli_epi16(rg, 4));
-		ba = _mm_or_si128(ba, _mm_slli_epi16(ba, 4));
-
-		// And then we can store.
-		_mm_store_si128(&dstp[i * 2 + 0], _mm_unpacklo_epi16(rg, ba));
-		_mm_store_si128(&dstp[i * 2 + 1], _mm_unpackhi_epi16(rg, ba));
-	}
-	u32 i = sseChunks * 8;
-#else
-	u32 i = 0;
-#endif
+	u32 i = ConvertExpand16To32<FormatRGBA4444, false>(dst32, src, numPixels);
 
 	u8 *dst = (u8 *)dst32;
 	for (u32 x = i; x < numPixels; x++) {
@@ -370,8 +559,10 @@ void ConvertRGBA4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 }
 
 void ConvertBGR565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
+	u32 i = ConvertExpand16To32<FormatBGR565, false>(dst32, src, numPixels);
+
 	u8 *dst = (u8 *)dst32;
-	for (u32 x = 0; x < numPixels; x++) {
+	for (u32 x = i; x < numPixels; x++) {
 		u16 col = src[x];
 		dst[x * 4] = Convert5To8((col >> 11) & 0x1f);
 		dst[x * 4 + 1] = Convert6To8((col >> 5) & 0x3f);
@@ -381,8 +572,10 @@ void ConvertBGR565ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 }
 
 void ConvertABGR1555ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
+	u32 i = ConvertExpand16To32<FormatABGR1555, false>(dst32, src, numPixels);
+
 	u8 *dst = (u8 *)dst32;
-	for (u32 x = 0; x < numPixels; x++) {
+	for (u32 x = i; x < numPixels; x++) {
 		u16 col = src[x];
 		dst[x * 4] = Convert5To8((col >> 11) & 0x1f);
 		dst[x * 4 + 1] = Convert5To8((col >> 6) & 0x1f);
@@ -392,8 +585,10 @@ void ConvertABGR1555ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 }
 
 void ConvertABGR4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
+	u32 i = ConvertExpand16To32<FormatABGR4444, false>(dst32, src, numPixels);
+
 	u8 *dst = (u8 *)dst32;
-	for (u32 x = 0; x < numPixels; x++) {
+	for (u32 x = i; x < numPixels; x++) {
 		u16 col = src[x];
 		dst[x * 4] = Convert4To8(col >> 12);
 		dst[x * 4 + 1] = Convert4To8((col >> 8) & 0xf);
@@ -403,7 +598,8 @@ void ConvertABGR4444ToRGBA8888(u32 *dst32, const u16 *src, u32 numPixels) {
 }
 
 void ConvertRGBA4444ToBGRA8888(u32 *dst, const u16 *src, u32 numPixels) {
-	for (u32 x = 0; x < numPixels; x++) {
+	u32 x = ConvertExpand16To32<FormatRGBA4444, true>(dst, src, numPixels);
+	for (; x < numPixels; x++) {
 		u16 c = src[x];
 		u32 r = Convert4To8(c & 0x000f);
 		u32 g = Convert4To8((c >> 4) & 0x000f);
@@ -415,7 +611,8 @@ void ConvertRGBA4444ToBGRA8888(u32 *dst, const u16 *src, u32 numPixels) {
 }
 
 void ConvertRGBA5551ToBGRA8888(u32 *dst, const u16 *src, u32 numPixels) {
-	for (u32 x = 0; x < numPixels; x++) {
+	u32 x = ConvertExpand16To32<FormatRGBA5551, true>(dst, src, numPixels);
+	for (; x < numPixels; x++) {
 		u16 c = src[x];
 		u32 r = Convert5To8(c & 0x001f);
 		u32 g = Convert5To8((c >> 5) & 0x001f);
@@ -428,7 +625,8 @@ void ConvertRGBA5551ToBGRA8888(u32 *dst, const u16 *src, u32 numPixels) {
 }
 
 void ConvertRGB565ToBGRA8888(u32 *dst, const u16 *src, u32 numPixels) {
-	for (u32 x = 0; x < numPixels; x++) {
+	u32 x = ConvertExpand16To32<FormatRGB565, true>(dst, src, numPixels);
+	for (; x < numPixels; x++) {
 		u16 c = src[x];
 		u32 r = Convert5To8(c & 0x001f);
 		u32 g = Convert6To8((c >> 5) & 0x003f);
@@ -445,40 +643,35 @@ void ConvertRGBA4444ToABGR4444(u16 *dst, const u16 *src, u32 numPixels) {
 	const __m128i *srcp = (const __m128i *)src;
 	__m128i *dstp = (__m128i *)dst;
 	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst & 0xF)) {
-		sseChunks = 0;
-	}
 	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
 		__m128i v = _mm_srli_epi16(c, 12);
 		v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi16(c, 4), mask0040));
 		v = _mm_or_si128(v, _mm_slli_epi16(_mm_and_si128(c, mask0040), 4));
 		v = _mm_or_si128(v, _mm_slli_epi16(c, 12));
-		_mm_store_si128(&dstp[i], v);
+		_mm_storeu_si128(&dstp[i], v);
 	}
 	// The remainder is done in chunks of 2, SSE was chunks of 8.
 	u32 i = sseChunks * 8 / 2;
 #elif PPSSPP_ARCH(ARM_NEON)
 	const uint16x8_t mask0040 = vdupq_n_u16(0x00F0);
 
-	if (((uintptr_t)dst & 15) == 0 && ((uintptr_t)src & 15) == 0) {
-		u32 simdable = (numPixels / 8) * 8;
-		for (u32 i = 0; i < simdable; i += 8) {
-			uint16x8_t c = vld1q_u16(src);
+	u32 simdable = (numPixels / 8) * 8;
+	for (u32 i = 0; i < simdable; i += 8) {
+		uint16x8_t c = vld1q_u16(src);
 
-			const uint16x8_t a = vshrq_n_u16(c, 12);
-			const uint16x8_t b = vandq_u16(vshrq_n_u16(c, 4), mask0040);
-			const uint16x8_t g = vshlq_n_u16(vandq_u16(c, mask0040), 4);
-			const uint16x8_t r = vshlq_n_u16(c, 12);
+		const uint16x8_t a = vshrq_n_u16(c, 12);
+		const uint16x8_t b = vandq_u16(vshrq_n_u16(c, 4), mask0040);
+		const uint16x8_t g = vshlq_n_u16(vandq_u16(c, mask0040), 4);
+		const uint16x8_t r = vshlq_n_u16(c, 12);
 
-			uint16x8_t res = vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a));
-			vst1q_u16(dst, res);
+		uint16x8_t res = vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a));
+		vst1q_u16(dst, res);
 
-			src += 8;
-			dst += 8;
-		}
-		numPixels -= simdable;
+		src += 8;
+		dst += 8;
 	}
+	numPixels -= simdable;
 	u32 i = 0;  // already moved the pointers forward
 #else
 	u32 i = 0;
@@ -512,16 +705,13 @@ void ConvertRGBA5551ToABGR1555(u16 *dst, const u16 *src, u32 numPixels) {
 	const __m128i *srcp = (const __m128i *)src;
 	__m128i *dstp = (__m128i *)dst;
 	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst & 0xF)) {
-		sseChunks = 0;
-	}
 	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
 		__m128i v = _mm_srli_epi16(c, 15);
 		v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi16(c, 9), maskB));
 		v = _mm_or_si128(v, _mm_and_si128(_mm_slli_epi16(c, 1), maskG));
 		v = _mm_or_si128(v, _mm_slli_epi16(c, 11));
-		_mm_store_si128(&dstp[i], v);
+		_mm_storeu_si128(&dstp[i], v);
 	}
 	// The remainder is done in chunks of 2, SSE was chunks of 8.
 	u32 i = sseChunks * 8 / 2;
@@ -529,24 +719,22 @@ void ConvertRGBA5551ToABGR1555(u16 *dst, const u16 *src, u32 numPixels) {
 	const uint16x8_t maskB = vdupq_n_u16(0x003E);
 	const uint16x8_t maskG = vdupq_n_u16(0x07C0);
 
-	if (((uintptr_t)dst & 15) == 0 && ((uintptr_t)src & 15) == 0) {
-		u32 simdable = (numPixels / 8) * 8;
-		for (u32 i = 0; i < simdable; i += 8) {
-			uint16x8_t c = vld1q_u16(src);
+	u32 simdable = (numPixels / 8) * 8;
+	for (u32 i = 0; i < simdable; i += 8) {
+		uint16x8_t c = vld1q_u16(src);
 
-			const uint16x8_t a = vshrq_n_u16(c, 15);
-			const uint16x8_t b = vandq_u16(vshrq_n_u16(c, 9), maskB);
-			const uint16x8_t g = vandq_u16(vshlq_n_u16(c, 1), maskG);
-			const uint16x8_t r = vshlq_n_u16(c, 11);
+		const uint16x8_t a = vshrq_n_u16(c, 15);
+		const uint16x8_t b = vandq_u16(vshrq_n_u16(c, 9), maskB);
+		const uint16x8_t g = vandq_u16(vshlq_n_u16(c, 1), maskG);
+		const uint16x8_t r = vshlq_n_u16(c, 11);
 
-			uint16x8_t res = vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a));
-			vst1q_u16(dst, res);
+		uint16x8_t res = vorrq_u16(vorrq_u16(r, g), vorrq_u16(b, a));
+		vst1q_u16(dst, res);
 
-			src += 8;
-			dst += 8;
-		}
-		numPixels -= simdable;
+		src += 8;
+		dst += 8;
 	}
+	numPixels -= simdable;
 	u32 i = 0;
 #else
 	u32 i = 0;
@@ -579,38 +767,33 @@ void ConvertRGB565ToBGR565(u16 *dst, const u16 *src, u32 numPixels) {
 	const __m128i *srcp = (const __m128i *)src;
 	__m128i *dstp = (__m128i *)dst;
 	u32 sseChunks = numPixels / 8;
-	if (((intptr_t)src & 0xF) || ((intptr_t)dst & 0xF)) {
-		sseChunks = 0;
-	}
 	for (u32 i = 0; i < sseChunks; ++i) {
-		const __m128i c = _mm_load_si128(&srcp[i]);
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
 		__m128i v = _mm_srli_epi16(c, 11);
 		v = _mm_or_si128(v, _mm_and_si128(c, maskG));
 		v = _mm_or_si128(v, _mm_slli_epi16(c, 11));
-		_mm_store_si128(&dstp[i], v);
+		_mm_storeu_si128(&dstp[i], v);
 	}
 	// The remainder is done in chunks of 2, SSE was chunks of 8.
 	u32 i = sseChunks * 8 / 2;
 #elif PPSSPP_ARCH(ARM_NEON)
 	const uint16x8_t maskG = vdupq_n_u16(0x07E0);
 
-	if (((uintptr_t)dst & 15) == 0 && ((uintptr_t)src & 15) == 0) {
-		u32 simdable = (numPixels / 8) * 8;
-		for (u32 i = 0; i < simdable; i += 8) {
-			uint16x8_t c = vld1q_u16(src);
+	u32 simdable = (numPixels / 8) * 8;
+	for (u32 i = 0; i < simdable; i += 8) {
+		uint16x8_t c = vld1q_u16(src);
 
-			const uint16x8_t b = vshrq_n_u16(c, 11);
-			const uint16x8_t g = vandq_u16(c, maskG);
-			const uint16x8_t r = vshlq_n_u16(c, 11);
+		const uint16x8_t b = vshrq_n_u16(c, 11);
+		const uint16x8_t g = vandq_u16(c, maskG);
+		const uint16x8_t r = vshlq_n_u16(c, 11);
 
-			uint16x8_t res = vorrq_u16(vorrq_u16(r, g), b);
-			vst1q_u16(dst, res);
+		uint16x8_t res = vorrq_u16(vorrq_u16(r, g), b);
+		vst1q_u16(dst, res);
 
-			src += 8;
-			dst += 8;
-		}
-		numPixels -= simdable;
+		src += 8;
+		dst += 8;
 	}
+	numPixels -= simdable;
 
 	u32 i = 0;
 #else
@@ -636,9 +819,34 @@ void ConvertRGB565ToBGR565(u16 *dst, const u16 *src, u32 numPixels) {
 }
 
 void ConvertBGRA5551ToABGR1555(u16 *dst, const u16 *src, u32 numPixels) {
+#ifdef _M_SSE
+	const __m128i *srcp = (const __m128i *)src;
+	__m128i *dstp = (__m128i *)dst;
+	u32 sseChunks = numPixels / 8;
+	for (u32 i = 0; i < sseChunks; ++i) {
+		const __m128i c = _mm_loadu_si128(&srcp[i]);
+		_mm_storeu_si128(&dstp[i], _mm_or_si128(_mm_srli_epi16(c, 15), _mm_slli_epi16(c, 1)));
+	}
+	// The remainder is done in chunks of 2, SSE was chunks of 8.
+	u32 i = sseChunks * 8 / 2;
+#elif PPSSPP_ARCH(ARM_NEON)
+	u32 simdable = (numPixels / 8) * 8;
+	for (u32 i = 0; i < simdable; i += 8) {
+		uint16x8_t c = vld1q_u16(src);
+		vst1q_u16(dst, vorrq_u16(vshrq_n_u16(c, 15), vshlq_n_u16(c, 1)));
+
+		src += 8;
+		dst += 8;
+	}
+	numPixels -= simdable;
+	u32 i = 0;
+#else
+	u32 i = 0;
+#endif
+
 	const u32 *src32 = (const u32 *)src;
 	u32 *dst32 = (u32 *)dst;
-	for (u32 i = 0; i < numPixels / 2; i++) {
+	for (; i < numPixels / 2; i++) {
 		const u32 c = src32[i];
 		dst32[i] = ((c >> 15) & 0x00010001) | ((c << 1) & 0xFFFEFFFE);
 	}
@@ -4,6 +4,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 
 #include <inttypes.h>
 
@@ -159,34 +160,72 @@ static std::string EscapeComments(const std::string &value) {
 	return result;
 }
 
+static std::string LowerKey(const char *key) {
+	std::string lower = key;
+	for (char &c : lower) {
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+	}
+	return lower;
+}
+
+ParsedIniLine::ParsedIniLine(const std::string &line) : line_(line) {
+	Parse();
+}
+
+void ParsedIniLine::Parse() {
+	key_.clear();
+	value_.clear();
+	comment_.clear();
+	if (!ParseLine(line_, &key_, &value_, &comment_)) {
+		key_.clear();
+		value_.clear();
+		comment_.clear();
+	}
+}
+
+void ParsedIniLine::SetValue(const char *key, const char *newValue) {
+	// Change the value - keep the key and comment
+	line_ = StripSpaces(key) + " = " + EscapeComments(newValue) + comment_;
+	Parse();
+}
+
 void Section::Clear() {
-	lines.clear();
+	lines_.clear();
+	index_.clear();
 }
 
-std::string* Section::GetLine(const char* key, std::string* valueOut, std::string* commentOut)
-{
-	for (std::vector<std::string>::iterator iter = lines.begin(); iter != lines.end(); ++iter)
-	{
-		std::string& line = *iter;
-		std::string lineKey;
-		ParseLine(line, &lineKey, valueOut, commentOut);
-		if (!strcasecmp(lineKey.c_str(), key))
-			return &line;
+void Section::AddLine(const std::string &line) {
+	lines_.emplace_back(line);
+	const std::string &key = lines_.back().Key();
+	if (!key.empty()) {
+		// Like a linear search, the first line with a given key wins.
+		index_.emplace(LowerKey(key.c_str()), lines_.size() - 1);
 	}
-	return 0;
 }
 
-const std::string* Section::GetLine(const char* key, std::string* valueOut, std::string* commentOut) const
-{
-	for (std::vector<std::string>::const_iterator iter = lines.begin(); iter != lines.end(); ++iter)
-	{
-		const std::string& line = *iter;
-		std::string lineKey;
-		ParseLine(line, &lineKey, valueOut, commentOut);
-		if (!strcasecmp(lineKey.c_str(), key))
-			return &line;
+void Section::RebuildIndex() {
+	index_.clear();
+	for (size_t i = 0; i < lines_.size(); i++) {
+		const std::string &key = lines_[i].Key();
+		if (!key.empty()) {
+			index_.emplace(LowerKey(key.c_str()), i);
+		}
 	}
-	return 0;
+}
+
+ParsedIniLine *Section::GetLine(const char *key) {
+	auto iter = index_.find(LowerKey(key));
+	if (iter == index_.end())
+		return nullptr;
+	return &lines_[iter->second];
+}
+
+const ParsedIniLine *Section::GetLine(const char *key) const {
+	auto iter = index_.find(LowerKey(key));
+	if (iter == index_.end())
+		return nullptr;
+	return &lines_[iter->second];
 }
 
 void Section::Set(const char* key, uint32_t newValue) {
@@ -211,17 +250,15 @@ void Section::Set(const char* key, int newValue) {
 
 void Section::Set(const char* key, const char* newValue)
 {
-	std::string value, commented;
-	std::string* line = GetLine(key, &value, &commented);
+	ParsedIniLine *line = GetLine(key);
 	if (line)
 	{
-		// Change the value - keep the key and comment
-		*line = StripSpaces(key) + " = " + EscapeComments(newValue) + commented;
+		line->SetValue(key, newValue);
 	}
 	else
 	{
 		// The key did not already exist in this section - let's add it.
-		lines.emplace_back(std::string(key) + " = " + EscapeComments(newValue));
+		AddLine(std::string(key) + " = " + EscapeComments(newValue));
 	}
 }
 
@@ -235,7 +272,7 @@ void Section::Set(const char* key, const std::string& newValue, const std::strin
 
 bool Section::Get(const char* key, std::string* value, const char* defaultValue) const
 {
-	const std::string* line = GetLine(key, value, 0);
+	const ParsedIniLine *line = GetLine(key);
 	if (!line)
 	{
 		if (defaultValue)
@@ -244,6 +281,7 @@ bool Section::Get(const char* key, std::string* value, const char* defaultValue)
 		}
 		return false;
 	}
+	*value = line->Value();
 	return true;
 }
 
@@ -287,7 +325,7 @@ void Section::Set(const char* key, const std::vector<std::string>& newValues)
 }
 
 void Section::AddComment(const std::string &comment) {
-	lines.emplace_back("# " + comment);
+	AddLine("# " + comment);
 }
 
 bool Section::Get(const char* key, std::vector<std::string>& values) const
@@ -380,24 +418,16 @@ bool Section::Get(const char* key, double* value, double defaultValue) const
 
 bool Section::Exists(const char *key) const
 {
-	for (std::vector<std::string>::const_iterator iter = lines.begin(); iter != lines.end(); ++iter)
-	{
-		std::string lineKey;
-		ParseLine(*iter, &lineKey, NULL, NULL);
-		if (!strcasecmp(lineKey.c_str(), key))
-			return true;
-	}
-	return false;
+	return GetLine(key) != nullptr;
 }
 
 std::map<std::string, std::string> Section::ToMap() const
 {
 	std::map<std::string, std::string> outMap;
-	for (std::vector<std::string>::const_iterator iter = lines.begin(); iter != lines.end(); ++iter)
+	for (const ParsedIniLine &line : lines_)
 	{
-		std::string lineKey, lineValue;
-		if (ParseLine(*iter, &lineKey, &lineValue, NULL)) {
-			outMap[lineKey] = lineValue;
+		if (!line.Key().empty()) {
+			outMap[line.Key()] = line.Value();
 		}
 	}
 	return outMap;
@@ -406,16 +436,13 @@ std::map<std::string, std::string> Section::ToMap() const
 
 bool Section::Delete(const char *key)
 {
-	std::string* line = GetLine(key, 0, 0);
-	for (std::vector<std::string>::iterator liter = lines.begin(); liter != lines.end(); ++liter)
-	{
-		if (line == &*liter)
-		{
-			lines.erase(liter);
-			return true;
-		}
-	}
-	return false;
+	ParsedIniLine *line = GetLine(key);
+	if (!line)
+		return false;
+	lines_.erase(lines_.begin() + (line - &lines_[0]));
+	// Indices have shifted, and a later line with the same key may now be the first.
+	RebuildIndex();
+	return true;
 }
 
 // IniFile
@@ -467,10 +494,10 @@ bool IniFile::Exists(const char* sectionName, const char* key) const {
 void IniFile::SetLines(const char* sectionName, const std::vector<std::string> &lines)
 {
 	Section* section = GetOrCreateSection(sectionName);
-	section->lines.clear();
-	for (std::vector<std::string>::const_iterator iter = lines.begin(); iter != lines.end(); ++iter)
+	section->Clear();
+	for (const std::string &line : lines)
 	{
-		section->lines.push_back(*iter);
+		section->AddLine(line);
 	}
 }
 
@@ -479,16 +506,7 @@ bool IniFile::DeleteKey(const char* sectionName, const char* key)
 	Section* section = GetSection(sectionName);
 	if (!section)
 		return false;
-	std::string* line = section->GetLine(key, 0, 0);
-	for (std::vector<std::string>::iterator liter = section->lines.begin(); liter != section->lines.end(); ++liter)
-	{
-		if (line == &(*liter))
-		{
-			section->lines.erase(liter);
-			return true;
-		}
-	}
-	return false; //shouldn't happen
+	return section->Delete(key);
 }
 
 // Return a list of all keys in a section
@@ -498,12 +516,10 @@ bool IniFile::GetKeys(const char* sectionName, std::vector<std::string>& keys) c
 	if (!section)
 		return false;
 	keys.clear();
-	for (std::vector<std::string>::const_iterator liter = section->lines.begin(); liter != section->lines.end(); ++liter)
+	for (const ParsedIniLine &line : section->lines_)
 	{
-		std::string key;
-		ParseLine(*liter, &key, 0, 0);
-		if (!key.empty())
-			keys.push_back(key);
+		if (!line.Key().empty())
+			keys.push_back(line.Key());
 	}
 	return true;
 }
@@ -516,9 +532,9 @@ bool IniFile::GetLines(const char* sectionName, std::vector<std::string>& lines,
 		return false;
 
 	lines.clear();
-	for (std::vector<std::string>::const_iterator iter = section->lines.begin(); iter != section->lines.end(); ++iter)
+	for (const ParsedIniLine &parsedLine : section->lines_)
 	{
-		std::string line = StripSpaces(*iter);
+		std::string line = StripSpaces(parsedLine.ToString());
 
 		if (remove_comments)
 		{
@@ -557,9 +573,7 @@ bool IniFile::Load(const Path &path)
 	if (!File::ReadFileToString(true, path, data)) {
 		return false;
 	}
-	std::stringstream sstream(data);
-	bool success = Load(sstream);
-	return success;
+	return LoadFromBuffer(data.data(), data.size());
 }
 
 bool IniFile::LoadFromVFS(VFSInterface &vfs, const std::string &filename) {
@@ -567,11 +581,9 @@ bool IniFile::LoadFromVFS(VFSInterface &vfs, const std::string &filename) {
 	uint8_t *data = vfs.ReadFile(filename.c_str(), &size);
 	if (!data)
 		return false;
-	std::string str((const char*)data, size);
+	bool success = LoadFromBuffer((const char *)data, size);
 	delete [] data;
-
-	std::stringstream sstream(str);
-	return Load(sstream);
+	return success;
 }
 
 bool IniFile::Load(std::istream &in) {
@@ -583,44 +595,62 @@ bool IniFile::Load(std::istream &in) {
 	{
 		in.getline(templine, MAX_BYTES);
 		std::string line = templine;
+		AddLoadedLine(line);
+	}
+
+	delete[] templine;
+	return true;
+}
+
+// Splits lines directly out of the buffer, instead of copying it all into a stringstream.
+bool IniFile::LoadFromBuffer(const char *data, size_t size) {
+	std::string line;
+	size_t pos = 0;
+	while (pos < size) {
+		const char *start = data + pos;
+		const char *end = (const char *)memchr(start, '\n', size - pos);
+		size_t len = end ? end - start : size - pos;
+		line.assign(start, len);
+		AddLoadedLine(line);
+		pos += len + 1;
+	}
+	return true;
+}
+
+void IniFile::AddLoadedLine(std::string &line) {
+	// Remove UTF-8 byte order marks.
+	if (line.size() >= 3 && !line.compare(0, 3, "\xEF\xBB\xBF")) {
+		line.erase(0, 3);
+	}
 
-		// Remove UTF-8 byte order marks.
-		if (line.substr(0, 3) == "\xEF\xBB\xBF") {
-			line = line.substr(3);
-		}
-		 
 #ifndef _WIN32
-		// Check for CRLF eol and convert it to LF
-		if (!line.empty() && line.at(line.size()-1) == '\r') {
-			line.erase(line.size()-1);
-		}
+	// Check for CRLF eol and convert it to LF
+	if (!line.empty() && line.at(line.size()-1) == '\r') {
+		line.erase(line.size()-1);
+	}
 #endif
 
-		if (!line.empty()) {
-			size_t sectionNameEnd = std::string::npos;
-			if (line[0] == '[') {
-				sectionNameEnd = line.find(']');
-			}
+	if (!line.empty()) {
+		size_t sectionNameEnd = std::string::npos;
+		if (line[0] == '[') {
+			sectionNameEnd = line.find(']');
+		}
 
-			if (sectionNameEnd != std::string::npos) {
-				// New section!
-				std::string sub = line.substr(1, sectionNameEnd - 1);
-				sections.push_back(std::unique_ptr<Section>(new Section(sub)));
-
-				if (sectionNameEnd + 1 < line.size()) {
-					sections.back()->comment = line.substr(sectionNameEnd + 1);
-				}
-			} else {
-				if (sections.empty()) {
-					sections.push_back(std::unique_ptr<Section>(new Section("")));
-				}
-				sections.back()->lines.push_back(line);
+		if (sectionNameEnd != std::string::npos) {
+			// New section!
+			std::string sub = line.substr(1, sectionNameEnd - 1);
+			sections.push_back(std::unique_ptr<Section>(new Section(sub)));
+
+			if (sectionNameEnd + 1 < line.size()) {
+				sections.back()->comment = line.substr(sectionNameEnd + 1);
+			}
+		} else {
+			if (sections.empty()) {
+				sections.push_back(std::unique_ptr<Section>(new Section("")));
 			}
+			sections.back()->AddLine(line);
 		}
 	}
-
-	delete[] templine;
-	return true;
 }
 
 bool IniFile::Save(const Path &filename)
@@ -635,12 +665,12 @@ bool IniFile::Save(const Path &filename)
 	fprintf(file, "\xEF\xBB\xBF");
 
 	for (const auto &section : sections) {
-		if (!section->name().empty() && (!section->lines.empty() || !section->comment.empty())) {
+		if (!section->name().empty() && (!section->lines_.empty() || !section->comment.empty())) {
 			fprintf(file, "[%s]%s\n", section->name().c_str(), section->comment.c_str());
 		}
 
-		for (const std::string &s : section->lines) {
-			fprintf(file, "%s\n", s.c_str());
+		for (const ParsedIniLine &line : section->lines_) {
+			fprintf(file, "%s\n", line.ToString().c_str());
 		}
 	}
 
@@ -8,6 +8,7 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
 
@@ -15,6 +16,31 @@
 
 class VFSInterface;
 
+// A line of an ini file, parsed once when added. The original text is kept so that
+// formatting and comments survive a load/save round trip. Lines that aren't key/value
+// pairs (comments, blank lines) just have an empty key.
+class ParsedIniLine {
+public:
+	ParsedIniLine() {}
+	explicit ParsedIniLine(const std::string &line);
+
+	const std::string &Key() const { return key_; }
+	const std::string &Value() const { return value_; }
+	const std::string &Comment() const { return comment_; }
+	const std::string &ToString() const { return line_; }
+
+	// Replaces the value, keeping any trailing comment.
+	void SetValue(const char *key, const char *newValue);
+
+private:
+	void Parse();
+
+	std::string line_;
+	std::string key_;
+	std::string value_;
+	std::string comment_;
+};
+
 class Section {
 	friend class IniFile;
 
@@ -29,8 +55,8 @@ class Section {
 
 	std::map<std::string, std::string> ToMap() const;
 
-	std::string *GetLine(const char* key, std::string* valueOut, std::string* commentOut);
-	const std::string *GetLine(const char* key, std::string* valueOut, std::string* commentOut) const;
+	ParsedIniLine *GetLine(const char *key);
+	const ParsedIniLine *GetLine(const char *key) const;
 
 	void Set(const char* key, const char* newValue);
 	void Set(const char* key, const std::string& newValue, const std::string& defaultValue);
@@ -80,7 +106,12 @@ class Section {
 	}
 
 protected:
-	std::vector<std::string> lines;
+	void AddLine(const std::string &line);
+	void RebuildIndex();
+
+	std::vector<ParsedIniLine> lines_;
+	// Lowercased key -> index of the first line with that key. Keys are case insensitive.
+	std::unordered_map<std::string, size_t> index_;
 	std::string name_;
 	std::string comment;
 };
@@ -153,6 +184,9 @@ class IniFile {
 	Section* GetOrCreateSection(const char* section);
 
 private:
+	bool LoadFromBuffer(const char *data, size_t size);
+	void AddLoadedLine(std::string &line);
+
 	std::vector<std::unique_ptr<Section>> sections;
 
 	const Section* GetSection(const char* section) const;
@@ -54,6 +54,11 @@ class VFSBackend : public VFSInterface {
 	virtual size_t Read(VFSOpenFile *vfsOpenFile, void *buffer, size_t length) = 0;
 	virtual void CloseFile(VFSOpenFile *vfsOpenFile) = 0;
 
+	// Optional. If the entire contents of an open file are directly accessible in memory (like an
+	// uncompressed file in a memory-mapped zip), returns a pointer to them, valid until CloseFile.
+	// Otherwise returns nullptr, and Read has to be used.
+	virtual const uint8_t *GetMappedData(VFSOpenFile *vfsOpenFile) { return nullptr; }
+
 	// Filter support is optional but nice to have
 	virtual bool GetFileInfo(const char *path, File::FileInfo *info) = 0;
 	virtual std::string toString() const = 0;
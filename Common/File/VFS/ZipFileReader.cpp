@@ -1,20 +1,79 @@
+#include "ppsspp_config.h"
+
 #include <algorithm>
 #include <ctype.h>
 #include <set>
 #include <cstdio>
 #include <cstring>
 
+#ifdef _WIN32
+#include "Common/CommonWindows.h"
+#include "Common/Data/Encoding/Utf8.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef SHARED_LIBZIP
 #include <zip.h>
 #else
 #include "ext/libzip/zip.h"
 #endif
 
+#include "zlib.h"
+
 #include "Common/Common.h"
 #include "Common/Log.h"
 #include "Common/File/VFS/ZipFileReader.h"
 #include "Common/StringUtils.h"
 
+static const uint16_t MAPPED_METHOD_NONE = 0xFFFF;
+static const uint16_t ZIP_METHOD_STORE = 0;
+static const uint16_t ZIP_METHOD_DEFLATE = 8;
+static const size_t MAX_POOLED_INFLATERS = 8;
+
+static std::string LowerName(const char *name) {
+	std::string lower = name;
+	for (char &c : lower) {
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+	}
+	return lower;
+}
+
+static inline uint16_t ReadLE16(const uint8_t *p) {
+	return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t ReadLE32(const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+class ZipFileReaderFileReference : public VFSFileReference {
+public:
+	int zi;
+};
+
+class ZipFileReaderOpenFile : public VFSOpenFile {
+public:
+	~ZipFileReaderOpenFile() {
+		// Needs to be closed properly and unlocked.
+		_dbg_assert_(zf == nullptr);
+		_dbg_assert_(inflater == nullptr);
+	}
+	ZipFileReaderFileReference *reference;
+	zip_file_t *zf = nullptr;
+
+	// Used instead of zf when reading straight from the mapped archive.
+	const uint8_t *data = nullptr;
+	uint32_t compressedSize = 0;
+	uint32_t size = 0;
+	uint32_t pos = 0;
+	z_stream *inflater = nullptr;  // Only for deflated files.
+};
+
 ZipFileReader *ZipFileReader::Create(const Path &zipFile, const char *inZipPath, bool logErrors) {
 	int error = 0;
 	zip *zip_file;
@@ -44,22 +103,242 @@ ZipFileReader *ZipFileReader::Create(const Path &zipFile, const char *inZipPath,
 	if (!path.empty() && path.back() != '/') {
 		path.push_back('/');
 	}
-	return new ZipFileReader(zip_file, path);
+	ZipFileReader *reader = new ZipFileReader(zip_file, path);
+	reader->BuildIndex();
+	// If mapping fails, everything still works through libzip, just serialized.
+	reader->MapArchive(zipFile);
+	return reader;
 }
 
 ZipFileReader::~ZipFileReader() {
 	std::lock_guard<std::mutex> guard(lock_);
 	zip_close(zip_file_);
+	UnmapArchive();
+	for (z_stream *stream : inflaters_) {
+		inflateEnd(stream);
+		delete stream;
+	}
+}
+
+void ZipFileReader::BuildIndex() {
+	int numFiles = zip_get_num_files(zip_file_);
+	index_.reserve(numFiles);
+	for (int i = 0; i < numFiles; i++) {
+		const char *name = zip_get_name(zip_file_, i, 0);
+		if (name) {
+			// Like zip_name_locate, the first entry with a name wins.
+			index_.emplace(LowerName(name), i);
+		}
+	}
+}
+
+int ZipFileReader::LocateFile(const std::string &path) {
+	auto iter = index_.find(LowerName(path.c_str()));
+	return iter != index_.end() ? iter->second : -1;
+}
+
+bool ZipFileReader::MapArchive(const Path &zipFile) {
+#if PPSSPP_PLATFORM(UWP)
+	return false;
+#elif defined(_WIN32)
+	HANDLE file = CreateFileW(ConvertUTF8ToWString(zipFile.ToString()).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || (uint64_t)fileSize.QuadPart > (size_t)-1) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+	// The view keeps the mapping alive.
+	void *base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!base)
+		return false;
+	mapBase_ = (const uint8_t *)base;
+	mapSize_ = (size_t)fileSize.QuadPart;
+#else
+	int fd = zipFile.Type() == PathType::CONTENT_URI ? File::OpenFD(zipFile, File::OPEN_READ) : open(zipFile.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return false;
+	}
+	void *base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return false;
+	mapBase_ = (const uint8_t *)base;
+	mapSize_ = (size_t)st.st_size;
+#endif
+
+	std::vector<std::string> names;
+	if (!ParseCentralDirectory(&names) || (int)mapped_.size() != zip_get_num_files(zip_file_)) {
+		// Zip64, or something else we don't handle. Just use libzip.
+		mapped_.clear();
+		UnmapArchive();
+		return false;
+	}
+
+	// Make sure our view of the archive matches libzip's indices.
+	for (size_t i = 0; i < mapped_.size(); i++) {
+		const char *name = zip_get_name(zip_file_, (zip_uint64_t)i, ZIP_FL_ENC_RAW);
+		if (!name || names[i] != name) {
+			mapped_[i].method = MAPPED_METHOD_NONE;
+		}
+	}
+	return true;
+}
+
+void ZipFileReader::UnmapArchive() {
+	if (!mapBase_)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(mapBase_);
+#else
+	munmap((void *)mapBase_, mapSize_);
+#endif
+	mapBase_ = nullptr;
+	mapSize_ = 0;
+}
+
+bool ZipFileReader::ParseCentralDirectory(std::vector<std::string> *names) {
+	// Find the end of central directory record. It's at the very end, unless there's a comment.
+	const size_t eocdSize = 22;
+	if (mapSize_ < eocdSize)
+		return false;
+	size_t searchEnd = mapSize_ > 0xFFFF + eocdSize ? mapSize_ - 0xFFFF - eocdSize : 0;
+	const uint8_t *eocd = nullptr;
+	for (size_t pos = mapSize_ - eocdSize + 1; pos-- > searchEnd; ) {
+		if (ReadLE32(mapBase_ + pos) == 0x06054b50) {
+			eocd = mapBase_ + pos;
+			break;
+		}
+	}
+	if (!eocd)
+		return false;
+
+	uint16_t count = ReadLE16(eocd + 10);
+	uint32_t cdSize = ReadLE32(eocd + 12);
+	uint32_t cdOffset = ReadLE32(eocd + 16);
+	if (count == 0xFFFF || cdOffset == 0xFFFFFFFF || (uint64_t)cdOffset + cdSize > mapSize_) {
+		// Zip64.
+		return false;
+	}
+
+	const uint8_t *p = mapBase_ + cdOffset;
+	const uint8_t *end = p + cdSize;
+	mapped_.reserve(count);
+	names->reserve(count);
+	for (uint16_t i = 0; i < count; i++) {
+		if (p + 46 > end || ReadLE32(p) != 0x02014b50)
+			return false;
+		uint16_t flags = ReadLE16(p + 8);
+		MappedEntry entry;
+		entry.method = ReadLE16(p + 10);
+		entry.compressedSize = ReadLE32(p + 20);
+		entry.size = ReadLE32(p + 24);
+		uint16_t nameLen = ReadLE16(p + 28);
+		uint16_t extraLen = ReadLE16(p + 30);
+		uint16_t commentLen = ReadLE16(p + 32);
+		entry.localHeaderOffset = ReadLE32(p + 42);
+		if (p + 46 + nameLen > end)
+			return false;
+		names->push_back(std::string((const char *)p + 46, nameLen));
+
+		bool encrypted = (flags & 1) != 0;
+		bool zip64 = entry.compressedSize == 0xFFFFFFFF || entry.size == 0xFFFFFFFF || entry.localHeaderOffset == 0xFFFFFFFF;
+		if (encrypted || zip64 || (entry.method != ZIP_METHOD_STORE && entry.method != ZIP_METHOD_DEFLATE)) {
+			entry.method = MAPPED_METHOD_NONE;
+		}
+		mapped_.push_back(entry);
+		p += 46 + nameLen + extraLen + commentLen;
+	}
+	return true;
+}
+
+// Returns nullptr if the local header looks wrong, in which case we fall back to libzip.
+const uint8_t *ZipFileReader::GetEntryData(const MappedEntry &entry) {
+	// The local header is only read here, rather than for all files up front, to avoid touching
+	// pages all over the archive on open.
+	const size_t localHeaderSize = 30;
+	if ((uint64_t)entry.localHeaderOffset + localHeaderSize > mapSize_)
+		return nullptr;
+	const uint8_t *header = mapBase_ + entry.localHeaderOffset;
+	if (ReadLE32(header) != 0x04034b50)
+		return nullptr;
+	uint64_t dataOffset = (uint64_t)entry.localHeaderOffset + localHeaderSize + ReadLE16(header + 26) + ReadLE16(header + 28);
+	if (dataOffset + entry.compressedSize > mapSize_)
+		return nullptr;
+	return mapBase_ + dataOffset;
+}
+
+z_stream *ZipFileReader::AllocInflater() {
+	{
+		std::lock_guard<std::mutex> guard(inflaterLock_);
+		if (!inflaters_.empty()) {
+			z_stream *stream = inflaters_.back();
+			inflaters_.pop_back();
+			inflateReset(stream);
+			return stream;
+		}
+	}
+
+	z_stream *stream = new z_stream{};
+	// Negative window bits means raw deflate data, without a zlib header, which is what zips contain.
+	if (inflateInit2(stream, -MAX_WBITS) != Z_OK) {
+		delete stream;
+		return nullptr;
+	}
+	return stream;
+}
+
+void ZipFileReader::FreeInflater(z_stream *stream) {
+	std::lock_guard<std::mutex> guard(inflaterLock_);
+	if (inflaters_.size() < MAX_POOLED_INFLATERS) {
+		inflaters_.push_back(stream);
+	} else {
+		inflateEnd(stream);
+		delete stream;
+	}
 }
 
 uint8_t *ZipFileReader::ReadFile(const char *path, size_t *size) {
 	std::string temp_path = inZipPath_ + path;
 
+	int zi = LocateFile(temp_path);
+	if (zi < 0) {
+		ERROR_LOG(IO, "Error opening %s from ZIP", temp_path.c_str());
+		return 0;
+	}
+
+	if (!mapped_.empty()) {
+		ZipFileReaderFileReference reference;
+		reference.zi = zi;
+		size_t fileSize = 0;
+		VFSOpenFile *openFile = OpenFileForRead(&reference, &fileSize);
+		if (!openFile) {
+			ERROR_LOG(IO, "Error opening %s from ZIP", temp_path.c_str());
+			return 0;
+		}
+		uint8_t *contents = new uint8_t[fileSize + 1];
+		size_t readSize = Read(openFile, contents, fileSize);
+		CloseFile(openFile);
+		contents[readSize] = 0;
+		*size = readSize;
+		return contents;
+	}
+
 	std::lock_guard<std::mutex> guard(lock_);
 	// Figure out the file size first.
 	struct zip_stat zstat;
-	zip_stat(zip_file_, temp_path.c_str(), ZIP_FL_NOCASE | ZIP_FL_UNCHANGED, &zstat);
-	zip_file *file = zip_fopen(zip_file_, temp_path.c_str(), ZIP_FL_NOCASE | ZIP_FL_UNCHANGED);
+	zip_stat_index(zip_file_, zi, ZIP_FL_UNCHANGED, &zstat);
+	zip_file *file = zip_fopen_index(zip_file_, zi, ZIP_FL_UNCHANGED);
 	if (!file) {
 		ERROR_LOG(IO, "Error opening %s from ZIP", temp_path.c_str());
 		return 0;
@@ -190,9 +469,10 @@ bool ZipFileReader::GetFileInfo(const char *path, File::FileInfo *info) {
 	info->isWritable = false;
 	info->size = 0;
 
+	int zi = LocateFile(temp_path);
 	{
 		std::lock_guard<std::mutex> guard(lock_);
-		if (0 != zip_stat(zip_file_, temp_path.c_str(), ZIP_FL_NOCASE | ZIP_FL_UNCHANGED, &zstat)) {
+		if (zi < 0 || 0 != zip_stat_index(zip_file_, zi, ZIP_FL_UNCHANGED, &zstat)) {
 			// ZIP files do not have real directories, so we'll end up here if we
 			// try to stat one. For now that's fine.
 			info->exists = false;
@@ -213,24 +493,8 @@ bool ZipFileReader::GetFileInfo(const char *path, File::FileInfo *info) {
 	return true;
 }
 
-class ZipFileReaderFileReference : public VFSFileReference {
-public:
-	int zi;
-};
-
-class ZipFileReaderOpenFile : public VFSOpenFile {
-public:
-	~ZipFileReaderOpenFile() {
-		// Needs to be closed properly and unlocked.
-		_dbg_assert_(zf == nullptr);
-	}
-	ZipFileReaderFileReference *reference;
-	zip_file_t *zf = nullptr;
-};
-
 VFSFileReference *ZipFileReader::GetFile(const char *path) {
-	std::lock_guard<std::mutex> guard(lock_);
-	int zi = zip_name_locate(zip_file_, path, ZIP_FL_NOCASE);
+	int zi = LocateFile(path);
 	if (zi < 0) {
 		// Not found.
 		return nullptr;
@@ -242,6 +506,12 @@ VFSFileReference *ZipFileReader::GetFile(const char *path) {
 
 bool ZipFileReader::GetFileInfo(VFSFileReference *vfsReference, File::FileInfo *fileInfo) {
 	ZipFileReaderFileReference *reference = (ZipFileReaderFileReference *)vfsReference;
+	if (!mapped_.empty() && mapped_[reference->zi].method != MAPPED_METHOD_NONE) {
+		*fileInfo = File::FileInfo{};
+		fileInfo->size = mapped_[reference->zi].size;
+		return fileInfo->size != 0;
+	}
+
 	// If you crash here, you called this while having the lock held by having the file open.
 	// Don't do that, check the info before you open the file.
 	std::lock_guard<std::mutex> guard(lock_);
@@ -263,15 +533,41 @@ void ZipFileReader::ReleaseFile(VFSFileReference *vfsReference) {
 
 VFSOpenFile *ZipFileReader::OpenFileForRead(VFSFileReference *vfsReference, size_t *size) {
 	ZipFileReaderFileReference *reference = (ZipFileReaderFileReference *)vfsReference;
+	*size = 0;
+
+	if (!mapped_.empty() && mapped_[reference->zi].method != MAPPED_METHOD_NONE) {
+		const MappedEntry &entry = mapped_[reference->zi];
+		const uint8_t *data = GetEntryData(entry);
+		if (data) {
+			z_stream *inflater = nullptr;
+			if (entry.method == ZIP_METHOD_DEFLATE) {
+				inflater = AllocInflater();
+				if (!inflater) {
+					return nullptr;
+				}
+				inflater->next_in = (Bytef *)data;
+				inflater->avail_in = entry.compressedSize;
+			}
+			// No lock needed, any number of these can be open at once.
+			ZipFileReaderOpenFile *openFile = new ZipFileReaderOpenFile();
+			openFile->reference = reference;
+			openFile->data = data;
+			openFile->compressedSize = entry.compressedSize;
+			openFile->size = entry.size;
+			openFile->inflater = inflater;
+			*size = entry.size;
+			return openFile;
+		}
+	}
+
 	ZipFileReaderOpenFile *openFile = new ZipFileReaderOpenFile();
 	openFile->reference = reference;
-	*size = 0;
-	// We only allow one file to be open for read concurrently. It's possible that this can be improved,
-	// especially if we only access by index like this.
+	// We only allow one file to be open for read concurrently through libzip.
 	lock_.lock();
 	zip_stat_t zstat;
 	if (zip_stat_index(zip_file_, reference->zi, 0, &zstat) != 0) {
 		lock_.unlock();
+		delete openFile;
 		return nullptr;
 	}
 
@@ -279,6 +575,7 @@ VFSOpenFile *ZipFileReader::OpenFileForRead(VFSFileReference *vfsReference, size
 	if (!openFile->zf) {
 		WARN_LOG(G3D, "File with index %d not found in zip", reference->zi);
 		lock_.unlock();
+		delete openFile;
 		return nullptr;
 	}
 
@@ -289,6 +586,16 @@ VFSOpenFile *ZipFileReader::OpenFileForRead(VFSFileReference *vfsReference, size
 
 void ZipFileReader::Rewind(VFSOpenFile *vfsOpenFile) {
 	ZipFileReaderOpenFile *openFile = (ZipFileReaderOpenFile *)vfsOpenFile;
+	if (openFile->data) {
+		openFile->pos = 0;
+		if (openFile->inflater) {
+			inflateReset(openFile->inflater);
+			openFile->inflater->next_in = (Bytef *)openFile->data;
+			openFile->inflater->avail_in = openFile->compressedSize;
+		}
+		return;
+	}
+
 	// Close and re-open.
 	zip_fclose(openFile->zf);
 	openFile->zf = zip_fopen_index(zip_file_, openFile->reference->zi, 0);
@@ -296,14 +603,57 @@ void ZipFileReader::Rewind(VFSOpenFile *vfsOpenFile) {
 
 size_t ZipFileReader::Read(VFSOpenFile *vfsOpenFile, void *buffer, size_t length) {
 	ZipFileReaderOpenFile *file = (ZipFileReaderOpenFile *)vfsOpenFile;
-	return zip_fread(file->zf, buffer, length);
+	if (!file->data) {
+		return zip_fread(file->zf, buffer, length);
+	}
+
+	length = std::min(length, (size_t)(file->size - file->pos));
+	if (!file->inflater) {
+		memcpy(buffer, file->data + file->pos, length);
+		file->pos += (uint32_t)length;
+		return length;
+	}
+
+	z_stream *stream = file->inflater;
+	stream->next_out = (Bytef *)buffer;
+	stream->avail_out = (uInt)length;
+	while (stream->avail_out > 0) {
+		int result = inflate(stream, Z_NO_FLUSH);
+		if (result == Z_STREAM_END) {
+			break;
+		} else if (result != Z_OK) {
+			ERROR_LOG(IO, "Failed to inflate file with index %d in zip: %d", file->reference->zi, result);
+			break;
+		}
+	}
+	size_t readSize = length - stream->avail_out;
+	file->pos += (uint32_t)readSize;
+	return readSize;
 }
 
 void ZipFileReader::CloseFile(VFSOpenFile *vfsOpenFile) {
 	ZipFileReaderOpenFile *file = (ZipFileReaderOpenFile *)vfsOpenFile;
+	if (file->data) {
+		if (file->inflater) {
+			FreeInflater(file->inflater);
+			file->inflater = nullptr;
+		}
+		delete file;
+		return;
+	}
+
 	_dbg_assert_(file->zf != nullptr);
 	zip_fclose(file->zf);
 	file->zf = nullptr;
 	lock_.unlock();
 	delete file;
 }
+
+const uint8_t *ZipFileReader::GetMappedData(VFSOpenFile *vfsOpenFile) {
+	ZipFileReaderOpenFile *file = (ZipFileReaderOpenFile *)vfsOpenFile;
+	// Only stored files can be handed out directly, deflated ones need to go through Read.
+	if (file->data && !file->inflater) {
+		return file->data;
+	}
+	return nullptr;
+}
@@ -9,6 +9,8 @@
 #include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/File/VFS/VFS.h"
 #include "Common/File/FileUtil.h"
@@ -32,6 +34,7 @@ class ZipFileReader : public VFSBackend {
 	void Rewind(VFSOpenFile *vfsOpenFile) override;
 	size_t Read(VFSOpenFile *vfsOpenFile, void *buffer, size_t length) override;
 	void CloseFile(VFSOpenFile *vfsOpenFile) override;
+	const uint8_t *GetMappedData(VFSOpenFile *vfsOpenFile) override;
 
 	bool GetFileListing(const char *path, std::vector<File::FileInfo> *listing, const char *filter) override;
 	bool GetFileInfo(const char *path, File::FileInfo *info) override;
@@ -44,7 +47,37 @@ class ZipFileReader : public VFSBackend {
 	// Path has to be either an empty string, or a string ending with a /.
 	bool GetZipListings(const std::string &path, std::set<std::string> &files, std::set<std::string> &directories);
 
+	// Entries of the central directory, when the archive could be memory mapped. Files can then be
+	// read without going through libzip, which means without the lock, and concurrently.
+	struct MappedEntry {
+		uint32_t localHeaderOffset;
+		uint32_t compressedSize;
+		uint32_t size;
+		uint16_t method;  // MAPPED_METHOD_NONE if we can't read it directly.
+	};
+
+	int LocateFile(const std::string &path);
+	void BuildIndex();
+	bool MapArchive(const Path &zipFile);
+	void UnmapArchive();
+	bool ParseCentralDirectory(std::vector<std::string> *names);
+	const uint8_t *GetEntryData(const MappedEntry &entry);
+	struct z_stream_s *AllocInflater();
+	void FreeInflater(struct z_stream_s *stream);
+
 	zip *zip_file_ = nullptr;
 	std::mutex lock_;
 	std::string inZipPath_;
+
+	// Lowercased name -> libzip index. zip_name_locate with ZIP_FL_NOCASE is a linear search,
+	// which really adds up with texture packs that have tens of thousands of files.
+	std::unordered_map<std::string, int> index_;
+
+	const uint8_t *mapBase_ = nullptr;
+	size_t mapSize_ = 0;
+	std::vector<MappedEntry> mapped_;  // Same order as the libzip indices.
+
+	// Inflate contexts are somewhat expensive to set up, so they're reused.
+	std::mutex inflaterLock_;
+	std::vector<struct z_stream_s *> inflaters_;
 };
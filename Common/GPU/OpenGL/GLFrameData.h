@@ -42,6 +42,9 @@ struct GLQueueProfileContext {
 	double cpuEndTime;
 	std::string passesString;
 	int commandCounts[25];  // Can't grab count from the enum as it would mean a circular include. Might clean this up later.
+	// Shadowed state (programs, textures, uniforms, vertex attribs, blend color) - GL calls made vs. filtered out.
+	int stateCallsIssued = 0;
+	int stateCallsSkipped = 0;
 };
 
 
@@ -63,6 +66,8 @@ struct GLFrameData {
 	GLDeleter deleter;
 	GLDeleter deleter_prev;
 	std::set<GLPushBuffer *> activePushBuffers;
+	// Only with GLBufferStrategy::PERSISTENT. Signalled when the GPU is done with this frame's push buffers.
+	GLsync pushFence = 0;
 
 	GLQueueProfileContext profile;
 };
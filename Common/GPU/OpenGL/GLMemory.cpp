@@ -15,6 +15,11 @@ void *GLRBuffer::Map(GLBufferStrategy strategy) {
 	_assert_(buffer_ != 0);
 
 	GLbitfield access = GL_MAP_WRITE_BIT;
+#ifndef USING_GLES2
+	if (strategy == GLBufferStrategy::PERSISTENT) {
+		access |= GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	}
+#endif
 	if ((strategy & GLBufferStrategy::MASK_FLUSH) != 0) {
 		access |= GL_MAP_FLUSH_EXPLICIT_BIT;
 	}
@@ -274,6 +279,11 @@ void GLPushBuffer::MapDevice(GLBufferStrategy strategy) {
 void GLPushBuffer::UnmapDevice() {
 	_dbg_assert_msg_(OnRenderThread(), "UnmapDevice must run on render thread");
 
+	// Persistent mappings stay valid while drawing, they're released when the buffers are deleted.
+	if (strategy_ == GLBufferStrategy::PERSISTENT) {
+		return;
+	}
+
 	for (auto &info : buffers_) {
 		if (info.deviceMemory) {
 			// TODO: Technically this can return false?
@@ -22,6 +22,9 @@ enum class GLBufferStrategy {
 	FLUSH_UNMAP = MASK_FLUSH,
 	// Map/unmap, invalidate on map, and explicit flush.
 	FLUSH_INVALIDATE_UNMAP = MASK_FLUSH | MASK_INVALIDATE,
+	// Map once, persistent and coherent (needs buffer storage.) Never unmapped, so the render manager
+	// must use fences to make sure the GPU is done with a frame's buffers before handing them out again.
+	PERSISTENT = 2,
 };
 
 static inline int operator &(const GLBufferStrategy &lhs, const GLBufferStrategy &rhs) {
@@ -55,11 +58,10 @@ class GLRBuffer {
 
 class GLRenderManager;
 
-// Similar to VulkanPushBuffer but is currently less efficient - it collects all the data in
-// RAM then does a big memcpy/buffer upload at the end of the frame. This is at least a lot
-// faster than the hundreds of buffer uploads or memory array buffers we used before.
-// On modern GL we could avoid the copy using glBufferStorage but not sure it's worth the
-// trouble.
+// Similar to VulkanPushBuffer. Depending on the buffer strategy, either collects all the data in
+// RAM then does a big memcpy/buffer upload at the end of the frame, or writes directly into mapped
+// buffers. With GLBufferStrategy::PERSISTENT, the buffers stay mapped for their whole lifetime
+// and there's no copy or map call at all.
 // We need to manage the lifetime of this together with the other resources so its destructor
 // runs on the render thread.
 class GLPushBuffer : public GPUMemoryManager {
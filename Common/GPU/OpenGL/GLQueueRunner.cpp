@@ -867,6 +867,15 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 
 	GLRect2D scissorRc = { -1, -1, -1, -1 };
 
+	bool blendColorSet = false;
+	float blendColor[4]{};
+	// Vertex attrib pointers capture the bound array buffer, so these are only valid together with curArrayBuffer.
+	const GLRInputLayout *curLayout = nullptr;
+	uint32_t curVertexOffset = 0;
+
+	int callsIssued = 0;
+	int callsSkipped = 0;
+
 	CHECK_GL_ERROR_IF_DEBUG();
 	auto &commands = step.commands;
 	for (const auto &c : commands) {
@@ -962,6 +971,7 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 				}
 				if (logicOp != c.logic.logicOp) {
 					glLogicOp(c.logic.logicOp);
+					logicOp = c.logic.logicOp;
 				}
 			} else if (/* !c.logic.enabled && */ logicEnabled) {
 				glDisable(GL_COLOR_LOGIC_OP);
@@ -1011,7 +1021,14 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 			CHECK_GL_ERROR_IF_DEBUG();
 			break;
 		case GLRRenderCommand::BLENDCOLOR:
-			glBlendColor(c.blendColor.color[0], c.blendColor.color[1], c.blendColor.color[2], c.blendColor.color[3]);
+			if (!blendColorSet || memcmp(blendColor, c.blendColor.color, sizeof(blendColor)) != 0) {
+				glBlendColor(c.blendColor.color[0], c.blendColor.color[1], c.blendColor.color[2], c.blendColor.color[3]);
+				memcpy(blendColor, c.blendColor.color, sizeof(blendColor));
+				blendColorSet = true;
+				callsIssued++;
+			} else {
+				callsSkipped++;
+			}
 			break;
 		case GLRRenderCommand::VIEWPORT:
 		{
@@ -1066,8 +1083,11 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 			if (c.uniform4.name) {
 				loc = curProgram->GetUniformLoc(c.uniform4.name);
 			}
-			if (loc >= 0) {
+			if (loc >= 0 && !curProgram->UniformChanged(loc, c.uniform4.v, c.uniform4.count * sizeof(float))) {
+				callsSkipped++;
+			} else if (loc >= 0) {
 				_dbg_assert_(c.uniform4.count >=1 && c.uniform4.count <=4);
+				callsIssued++;
 				switch (c.uniform4.count) {
 				case 1: glUniform1f(loc, c.uniform4.v[0]); break;
 				case 2: glUniform2fv(loc, 1, c.uniform4.v); break;
@@ -1085,8 +1105,11 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 			if (c.uniform4.name) {
 				loc = curProgram->GetUniformLoc(c.uniform4.name);
 			}
-			if (loc >= 0) {
+			if (loc >= 0 && !curProgram->UniformChanged(loc, c.uniform4.v, c.uniform4.count * sizeof(float))) {
+				callsSkipped++;
+			} else if (loc >= 0) {
 				_dbg_assert_(c.uniform4.count >=1 && c.uniform4.count <=4);
+				callsIssued++;
 				switch (c.uniform4.count) {
 				case 1: glUniform1uiv(loc, 1, (GLuint *)c.uniform4.v); break;
 				case 2: glUniform2uiv(loc, 1, (GLuint *)c.uniform4.v); break;
@@ -1104,8 +1127,11 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 			if (c.uniform4.name) {
 				loc = curProgram->GetUniformLoc(c.uniform4.name);
 			}
-			if (loc >= 0) {
+			if (loc >= 0 && !curProgram->UniformChanged(loc, c.uniform4.v, c.uniform4.count * sizeof(float))) {
+				callsSkipped++;
+			} else if (loc >= 0) {
 				_dbg_assert_(c.uniform4.count >=1 && c.uniform4.count <=4);
+				callsIssued++;
 				switch (c.uniform4.count) {
 				case 1: glUniform1iv(loc, 1, (GLint *)c.uniform4.v); break;
 				case 2: glUniform2iv(loc, 1, (GLint *)c.uniform4.v); break;
@@ -1137,11 +1163,10 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 					loc = curProgram->GetUniformLoc(c.uniformStereoMatrix4.name);
 				}
 				if (loc >= 0) {
-					if (GetVRFBOIndex() == 0) {
-						glUniformMatrix4fv(loc, 1, false, c.uniformStereoMatrix4.mData);
-					} else {
-						glUniformMatrix4fv(loc, 1, false, c.uniformStereoMatrix4.mData + 16);
-					}
+					const float *m = GetVRFBOIndex() == 0 ? c.uniformStereoMatrix4.mData : c.uniformStereoMatrix4.mData + 16;
+					glUniformMatrix4fv(loc, 1, false, m);
+					// Keep the shadow in sync, this differs per eye so always set it.
+					curProgram->UniformChanged(loc, m, 16 * sizeof(float));
 				}
 				if (GetVRFBOIndex() == 1 || GetVRPassesCount() == 1) {
 					// Only delete the data if we're rendering the only or the second eye.
@@ -1159,8 +1184,11 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 			if (c.uniformMatrix4.name) {
 				loc = curProgram->GetUniformLoc(c.uniformMatrix4.name);
 			}
-			if (loc >= 0) {
+			if (loc >= 0 && !curProgram->UniformChanged(loc, c.uniformMatrix4.m, sizeof(c.uniformMatrix4.m))) {
+				callsSkipped++;
+			} else if (loc >= 0) {
 				glUniformMatrix4fv(loc, 1, false, c.uniformMatrix4.m);
+				callsIssued++;
 			}
 			CHECK_GL_ERROR_IF_DEBUG();
 			break;
@@ -1176,6 +1204,9 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 				if (curTex[slot] != c.texture.texture) {
 					glBindTexture(c.texture.texture->target, c.texture.texture->texture);
 					curTex[slot] = c.texture.texture;
+					callsIssued++;
+				} else {
+					callsSkipped++;
 				}
 			} else {
 				glBindTexture(GL_TEXTURE_2D, 0);  // Which target? Well we only use this one anyway...
@@ -1232,6 +1263,9 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 						glDisable(GL_CLIP_DISTANCE0 + (GLenum)i);
 					clipDistanceEnabled[i] = c.program.program->use_clip_distance[i];
 				}
+				callsIssued++;
+			} else {
+				callsSkipped++;
 			}
 			CHECK_GL_ERROR_IF_DEBUG();
 			break;
@@ -1244,14 +1278,23 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 			if (buf != curArrayBuffer) {
 				glBindBuffer(GL_ARRAY_BUFFER, buf);
 				curArrayBuffer = buf;
+				curLayout = nullptr;
 			}
 			if (attrMask != layout->semanticsMask_) {
 				EnableDisableVertexArrays(attrMask, layout->semanticsMask_);
 				attrMask = layout->semanticsMask_;
 			}
-			for (size_t i = 0; i < layout->entries.size(); i++) {
-				auto &entry = layout->entries[i];
-				glVertexAttribPointer(entry.location, entry.count, entry.type, entry.normalized, entry.stride, (const void *)(c.draw.vertexOffset + entry.offset));
+			// Consecutive draws from the same spot in the push buffer (common with indexed draws) don't need new pointers.
+			if (layout != curLayout || c.draw.vertexOffset != curVertexOffset) {
+				for (size_t i = 0; i < layout->entries.size(); i++) {
+					auto &entry = layout->entries[i];
+					glVertexAttribPointer(entry.location, entry.count, entry.type, entry.normalized, entry.stride, (const void *)(c.draw.vertexOffset + entry.offset));
+				}
+				curLayout = layout;
+				curVertexOffset = c.draw.vertexOffset;
+				callsIssued += (int)layout->entries.size();
+			} else {
+				callsSkipped += (int)layout->entries.size();
 			}
 			if (c.draw.indexBuffer) {
 				GLuint buf = c.draw.indexBuffer->buffer_;
@@ -1428,6 +1471,9 @@ void GLQueueRunner::PerformRenderPass(const GLRStep &step, bool first, bool last
 		glActiveTexture(GL_TEXTURE0);
 		activeSlot = 0;  // doesn't matter, just nice.
 	}
+
+	profile.stateCallsIssued += callsIssued;
+	profile.stateCallsSkipped += callsSkipped;
 	CHECK_GL_ERROR_IF_DEBUG();
 
 	// Wipe out the current state.
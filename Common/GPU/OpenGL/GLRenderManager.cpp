@@ -58,10 +58,10 @@ void GLRenderManager::ThreadStart(Draw::DrawContext *draw) {
 	queueRunner_.CreateDeviceObjects();
 	renderThreadId = std::this_thread::get_id();
 
-	if (newInflightFrames_ != -1) {
-		INFO_LOG(G3D, "Updating inflight frames to %d", newInflightFrames_);
-		inflightFrames_ = newInflightFrames_;
-		newInflightFrames_ = -1;
+	int newInflightFrames = newInflightFrames_.exchange(-1);
+	if (newInflightFrames != -1) {
+		INFO_LOG(G3D, "Updating inflight frames to %d", newInflightFrames);
+		inflightFrames_ = newInflightFrames;
 	}
 
 	// Don't save draw, we don't want any thread safety confusion.
@@ -75,7 +75,12 @@ void GLRenderManager::ThreadStart(Draw::DrawContext *draw) {
 	// Notes on buffer mapping:
 	// NVIDIA GTX 9xx / 2017-10 drivers - mapping improves speed, basic unmap seems best.
 	// PowerVR GX6xxx / iOS 10.3 - mapping has little improvement, explicit flush is slower.
-	if (mapBuffers) {
+	if (gl_extensions.ARB_buffer_storage && !gl_extensions.IsGLES && gl_extensions.VersionGEThan(3, 2, 0)) {
+		// Persistent coherent mapping lets the emu thread write straight into GPU-visible memory,
+		// without the copy of SUBDATA or the driver sync of map/unmap. Not on GLES, because of
+		// the same Android task switching issue as described below.
+		bufferStrategy_ = GLBufferStrategy::PERSISTENT;
+	} else if (mapBuffers) {
 		switch (gl_extensions.gpuVendor) {
 		case GPU_VENDOR_NVIDIA:
 			bufferStrategy_ = GLBufferStrategy::FRAME_UNMAP;
@@ -104,6 +109,11 @@ void GLRenderManager::ThreadEnd() {
 	queueRunner_.DestroyDeviceObjects();
 	VLOG("  PULL: Quitting");
 
+	// Nothing more will be drawn, so don't wait on the GPU - just let go of any frames we held on to.
+	while (!pendingFenceFrames_.empty()) {
+		ReleasePendingFenceFrame(false);
+	}
+
 	// Good time to run all the deleters to get rid of leftover objects.
 	for (int i = 0; i < MAX_INFLIGHT_FRAMES; i++) {
 		// Since we're in shutdown, we should skip the GL calls on Android.
@@ -148,6 +158,11 @@ bool GLRenderManager::ThreadFrame() {
 		// push more work when it feels like it, and just start working.
 		if (task->runType == GLRRunType::EXIT) {
 			delete task;
+			// No more presents will come to let go of frames held for their fences, and the emu thread
+			// might be waiting on one of them.
+			while (!pendingFenceFrames_.empty()) {
+				ReleasePendingFenceFrame(true);
+			}
 			// Oh, host wanted out. Let's leave, and also let's notify the host.
 			// This is unlike Vulkan too which can just block on the thread existing.
 			std::unique_lock<std::mutex> lock(syncMutex_);
@@ -188,7 +203,7 @@ std::string GLRenderManager::GetGpuProfileString() const {
 	const GLQueueProfileContext &profile = frameData_[curFrame].profile;
 
 	float cputime_ms = 1000.0f * (profile.cpuEndTime - profile.cpuStartTime);
-	return StringFromFormat("CPU time to run the list: %0.2f ms\n\n%s", cputime_ms, profilePassesString_.c_str());
+	return StringFromFormat("CPU time to run the list: %0.2f ms\nState calls: %d issued, %d skipped\n\n%s", cputime_ms, profileCallsIssued_, profileCallsSkipped_, profilePassesString_.c_str());
 }
 
 void GLRenderManager::BindFramebufferAsRenderTarget(GLRFramebuffer *fb, GLRRenderPassAction color, GLRRenderPassAction depth, GLRRenderPassAction stencil, uint32_t clearColor, float clearDepth, uint8_t clearStencil, const char *tag) {
@@ -400,7 +415,11 @@ void GLRenderManager::Finish() {
 #endif
 
 		frameData.profile.passesString.clear();
+		profileCallsIssued_ = frameData.profile.stateCallsIssued;
+		profileCallsSkipped_ = frameData.profile.stateCallsSkipped;
 	}
+	frameData.profile.stateCallsIssued = 0;
+	frameData.profile.stateCallsSkipped = 0;
 
 	VLOG("PUSH: Finish, pushing task. curFrame = %d", curFrame);
 	GLRRenderThreadTask *task = new GLRRenderThreadTask(GLRRunType::SUBMIT);
@@ -439,6 +458,13 @@ bool GLRenderManager::Run(GLRRenderThreadTask &task) {
 
 	GLFrameData &frameData = frameData_[task.frame];
 
+	if (skipGLCalls_) {
+		// Fences are neither created nor waited on anymore, so nothing else would hand these frames back.
+		while (!pendingFenceFrames_.empty()) {
+			ReleasePendingFenceFrame(false);
+		}
+	}
+
 	if (task.runType == GLRRunType::PRESENT) {
 		bool swapRequest = false;
 		if (!frameData.skipSwap) {
@@ -460,6 +486,18 @@ bool GLRenderManager::Run(GLRRenderThreadTask &task) {
 		}
 		frameData.hasBegun = false;
 
+		if (bufferStrategy_ == GLBufferStrategy::PERSISTENT && !skipGLCalls_) {
+			// The emu thread writes into this frame's push buffers as soon as we let go of it, and they
+			// stay mapped, so hold on to it until the GPU has finished with it. To keep CPU/GPU overlap,
+			// only wait once we have as many frames in flight as allowed.
+			frameData.pushFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			pendingFenceFrames_.push_back(task.frame);
+			while ((int)pendingFenceFrames_.size() >= inflightFrames_) {
+				ReleasePendingFenceFrame(true);
+			}
+			return swapRequest;
+		}
+
 		VLOG("  PULL: Frame %d.readyForFence = true", task.frame);
 
 		{
@@ -521,8 +559,9 @@ bool GLRenderManager::Run(GLRRenderThreadTask &task) {
 	case GLRRunType::SYNC:
 		frameData.hasBegun = false;
 
-		// glFinish is not actually necessary here, and won't be unless we start using
-		// glBufferStorage. Then we need to use fences.
+		// glFinish is not necessary here. With persistently mapped push buffers (glBufferStorage), the
+		// emu thread only appends to the current frame's buffers after a sync, and the per-frame fences
+		// waited on at PRESENT keep it from reusing memory the GPU might still be reading.
 		{
 			std::unique_lock<std::mutex> lock(syncMutex_);
 			syncDone_ = true;
@@ -537,6 +576,31 @@ bool GLRenderManager::Run(GLRRenderThreadTask &task) {
 	return false;
 }
 
+// Render thread.
+void GLRenderManager::ReleasePendingFenceFrame(bool waitForGPU) {
+	int frame = pendingFenceFrames_.front();
+	pendingFenceFrames_.pop_front();
+	GLFrameData &frameData = frameData_[frame];
+
+	if (frameData.pushFence) {
+		if (waitForGPU && !skipGLCalls_) {
+			GLenum result;
+			do {
+				result = glClientWaitSync(frameData.pushFence, GL_SYNC_FLUSH_COMMANDS_BIT, 100 * 1000 * 1000);
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+		if (!skipGLCalls_) {
+			glDeleteSync(frameData.pushFence);
+		}
+		frameData.pushFence = 0;
+	}
+
+	VLOG("  PULL: Frame %d.readyForFence = true (fenced)", frame);
+	std::lock_guard<std::mutex> lock(frameData.fenceMutex);
+	frameData.readyForFence = true;
+	frameData.fenceCondVar.notify_one();
+}
+
 void GLRenderManager::FlushSync() {
 	{
 		VLOG("PUSH: Frame[%d].readyForRun = true (sync)", curFrame_);
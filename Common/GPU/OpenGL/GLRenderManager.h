@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -8,7 +9,9 @@
 #include <string>
 #include <mutex>
 #include <queue>
+#include <deque>
 #include <condition_variable>
+#include <cstring>
 
 #include "Common/GPU/MiscTypes.h"
 #include "Common/Data/Convert/SmallDataConvert.h"
@@ -171,16 +174,44 @@ class GLRProgram {
 		return loc;
 	}
 
+	// Must ONLY be called from GLQueueRunner!
+	// Uniform values are program state, so we can remember the last value written to each location
+	// and skip the glUniform call if it's the same. Returns true if the call is needed.
+	bool UniformChanged(int loc, const void *data, size_t size) {
+		if (loc < 0 || loc >= MAX_SHADOWED_UNIFORM_LOC || size > sizeof(UniformShadow::data)) {
+			return true;
+		}
+		if (loc >= (int)uniformShadow_.size()) {
+			uniformShadow_.resize(loc + 1);
+		}
+		UniformShadow &shadow = uniformShadow_[loc];
+		if (shadow.size == size && memcmp(shadow.data, data, size) == 0) {
+			return false;
+		}
+		memcpy(shadow.data, data, size);
+		shadow.size = (uint8_t)size;
+		return true;
+	}
+
 	void SetDeleteCallback(void(*cb)(void *), void *p) {
 		deleteCallback_ = cb;
 		deleteParam_ = p;
 	}
 
 private:
+	// Locations are usually small and dense, anything beyond this simply isn't filtered.
+	enum { MAX_SHADOWED_UNIFORM_LOC = 256 };
+
+	struct UniformShadow {
+		uint8_t size = 0;
+		float data[16];
+	};
+
 	void(*deleteCallback_)(void *) = nullptr;
 	void *deleteParam_ = nullptr;
 
 	std::unordered_map<std::string, UniformInfo> uniformCache_;
+	std::vector<UniformShadow> uniformShadow_;
 };
 
 class GLRInputLayout {
@@ -839,12 +870,13 @@ class GLRenderManager {
 	}
 
 	// Used during Android-style ugly shutdown. No need to have a way to set it back because we'll be
-	// destroyed.
+	// destroyed. Called from another thread, the render thread then lets go of any frames held for fences.
 	void SetSkipGLCalls() {
 		skipGLCalls_ = true;
 	}
 
 private:
+	void ReleasePendingFenceFrame(bool waitForGPU);
 	bool Run(GLRRenderThreadTask &task);
 
 	// Bad for performance but sometimes necessary for synchronous CPU readbacks (screenshots and whatnot).
@@ -886,16 +918,20 @@ class GLRenderManager {
 	bool syncDone_ = false;
 
 	GLDeleter deleter_;
-	bool skipGLCalls_ = false;
+	std::atomic<bool> skipGLCalls_{ false };
 
 	int curFrame_ = 0;
 
 	std::function<void()> swapFunction_;
 	std::function<void(int)> swapIntervalFunction_;
 	GLBufferStrategy bufferStrategy_ = GLBufferStrategy::SUBDATA;
+	// With GLBufferStrategy::PERSISTENT, presented frames that aren't handed back to the emu thread
+	// until their fence has been waited on. Oldest first, render thread only.
+	std::deque<int> pendingFenceFrames_;
 
-	int inflightFrames_ = MAX_INFLIGHT_FRAMES;
-	int newInflightFrames_ = -1;
+	// Read by both the emu thread (Present) and the render thread (fence waits).
+	std::atomic<int> inflightFrames_{ MAX_INFLIGHT_FRAMES };
+	std::atomic<int> newInflightFrames_{ -1 };
 
 	int swapInterval_ = 0;
 	bool swapIntervalChanged_ = true;
@@ -909,6 +945,8 @@ class GLRenderManager {
 	Draw::DeviceCaps caps_{};
 
 	std::string profilePassesString_;
+	int profileCallsIssued_ = 0;
+	int profileCallsSkipped_ = 0;
 	InvalidationCallback invalidationCallback_;
 
 	uint64_t frameIdGen_ = FRAME_TIME_HISTORY_LENGTH;
@@ -515,8 +515,8 @@ class OpenGLContext : public DrawContext {
 	uint8_t stencilWriteMask_ = 0;
 	uint8_t stencilCompareMask_ = 0;
 
-	// Frames in flight is not such a strict concept as with Vulkan until we start using glBufferStorage and fences.
-	// But might as well have the structure ready, and can't hurt to rotate buffers.
+	// Rotated along with the render manager's frames. With persistently mapped (glBufferStorage) push buffers,
+	// its per-frame fences make sure the GPU is done with a frame's buffers before they're reused.
 	struct FrameData {
 		GLPushBuffer *push;
 	};
@@ -87,6 +87,9 @@ cbuffer data : register(b0) {
 	float4 u_timeDelta;
 	float4 u_setting;
 	float u_video;
+	float4 u_setting1;
+	float4 u_setting2;
+	float4 u_setting3;
 };
 )";
 
@@ -104,6 +107,9 @@ layout (std140, set = 0, binding = 0) uniform Data {
 	vec4 u_timeDelta;
 	vec4 u_setting;
 	float u_video;
+	vec4 u_setting1;
+	vec4 u_setting2;
+	vec4 u_setting3;
 };
 )";
 
@@ -115,6 +121,9 @@ float4 u_time : register(c3);
 float4 u_timeDelta : register(c4);
 float4 u_setting : register(c5);
 float u_video : register(c6);
+float4 u_setting1 : register(c7);
+float4 u_setting2 : register(c8);
+float4 u_setting3 : register(c9);
 )";
 
 // SPIRV-Cross' HLSL output has some deficiencies we need to work around.
@@ -59,6 +59,11 @@ void FrameData::Destroy(VulkanContext *vulkan) {
 	VkDevice device = vulkan->GetDevice();
 	vkDestroyCommandPool(device, cmdPoolInit, nullptr);
 	vkDestroyCommandPool(device, cmdPoolMain, nullptr);
+	for (auto &secondary : secondaryCmds) {
+		vkDestroyCommandPool(device, secondary.pool, nullptr);
+	}
+	secondaryCmds.clear();
+	secondaryCmdsUsed = 0;
 	vkDestroyFence(device, fence, nullptr);
 	vkDestroyQueryPool(device, profile.queryPool, nullptr);
 
@@ -69,6 +74,50 @@ void FrameData::Destroy(VulkanContext *vulkan) {
 	readbacks_.Clear();
 }
 
+VkCommandBuffer FrameData::AllocSecondaryCmd(VulkanContext *vulkan) {
+	// Caps the number of pools we keep around per frame.
+	static const size_t MAX_SECONDARY_CMDS = 32;
+
+	if (secondaryCmdsUsed < secondaryCmds.size()) {
+		return secondaryCmds[secondaryCmdsUsed++].cmd;
+	}
+	if (secondaryCmds.size() >= MAX_SECONDARY_CMDS) {
+		return VK_NULL_HANDLE;
+	}
+
+	VkDevice device = vulkan->GetDevice();
+	SecondaryCmd secondary{};
+	VkCommandPoolCreateInfo cmd_pool_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+	cmd_pool_info.queueFamilyIndex = vulkan->GetGraphicsQueueFamilyIndex();
+	cmd_pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	VkResult res = vkCreateCommandPool(device, &cmd_pool_info, nullptr, &secondary.pool);
+	if (res != VK_SUCCESS) {
+		return VK_NULL_HANDLE;
+	}
+
+	VkCommandBufferAllocateInfo cmd_alloc = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+	cmd_alloc.commandPool = secondary.pool;
+	cmd_alloc.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+	cmd_alloc.commandBufferCount = 1;
+	res = vkAllocateCommandBuffers(device, &cmd_alloc, &secondary.cmd);
+	if (res != VK_SUCCESS) {
+		vkDestroyCommandPool(device, secondary.pool, nullptr);
+		return VK_NULL_HANDLE;
+	}
+	vulkan->SetDebugName(secondary.cmd, VK_OBJECT_TYPE_COMMAND_BUFFER, StringFromFormat("secondaryCmd%d_%d", index, (int)secondaryCmds.size()).c_str());
+
+	secondaryCmds.push_back(secondary);
+	secondaryCmdsUsed++;
+	return secondary.cmd;
+}
+
+void FrameData::ResetSecondaryCmds(VulkanContext *vulkan) {
+	for (size_t i = 0; i < secondaryCmdsUsed; i++) {
+		vkResetCommandPool(vulkan->GetDevice(), secondaryCmds[i].pool, 0);
+	}
+	secondaryCmdsUsed = 0;
+}
+
 void FrameData::AcquireNextImage(VulkanContext *vulkan, FrameDataShared &shared) {
 	_dbg_assert_(!hasAcquired);
 
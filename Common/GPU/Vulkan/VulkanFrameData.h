@@ -19,6 +19,22 @@ enum class VKRRunType {
 	EXIT,
 };
 
+// What VulkanQueueRunner::PreprocessSteps managed to do to a frame's steps.
+struct QueueOptimizeStats {
+	int renderPasses;  // Before optimization.
+	int mergedPasses;
+	int hoistedSteps;
+	int droppedStores;
+};
+
+// Time the render thread spent waiting for pipelines that hadn't finished compiling, and draws
+// that were dropped because their pipeline failed.
+struct PipelineWaitStats {
+	int blockedBinds;
+	double blockedMs;
+	int skippedDraws;
+};
+
 struct QueueProfileContext {
 	bool enabled = false;
 	bool timestampsEnabled = false;
@@ -28,6 +44,8 @@ struct QueueProfileContext {
 	double cpuStartTime;
 	double cpuEndTime;
 	double descWriteTime;
+	QueueOptimizeStats optimizeStats{};
+	PipelineWaitStats pipelineWaitStats{};
 };
 
 class VKRFramebuffer;
@@ -84,6 +102,16 @@ struct FrameData {
 	VkCommandBuffer mainCmd = VK_NULL_HANDLE;
 	VkCommandBuffer presentCmd = VK_NULL_HANDLE;
 
+	// Secondary command buffers for render passes recorded on worker threads. Each gets its own pool,
+	// since a pool can't be used from several threads at once. Allocated from the render thread,
+	// and reset together with cmdPoolMain.
+	struct SecondaryCmd {
+		VkCommandPool pool;
+		VkCommandBuffer cmd;
+	};
+	std::vector<SecondaryCmd> secondaryCmds;
+	size_t secondaryCmdsUsed = 0;
+
 	bool hasInitCommands = false;
 	bool hasMainCommands = false;
 	bool hasPresentCommands = false;
@@ -117,6 +145,10 @@ struct FrameData {
 	// Generally called from the main thread, unlike most of the rest.
 	VkCommandBuffer GetInitCmd(VulkanContext *vulkan);
 
+	// Returns VK_NULL_HANDLE when too many have been used this frame.
+	VkCommandBuffer AllocSecondaryCmd(VulkanContext *vulkan);
+	void ResetSecondaryCmds(VulkanContext *vulkan);
+
 	// This will only submit if we are actually recording init commands.
 	void SubmitPending(VulkanContext *vulkan, FrameSubmitType type, FrameDataShared &shared);
 
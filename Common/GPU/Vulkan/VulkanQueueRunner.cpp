@@ -5,6 +5,7 @@
 #include "Common/GPU/Vulkan/VulkanRenderManager.h"
 #include "Common/VR/PPSSPPVR.h"
 #include "Common/Log.h"
+#include "Common/Thread/ParallelLoop.h"
 #include "Common/TimeUtil.h"
 
 using namespace PPSSPP_VK;
@@ -43,6 +44,28 @@ RenderPassType MergeRPTypes(RenderPassType a, RenderPassType b) {
 	return (RenderPassType)((u32)a | (u32)b);
 }
 
+static bool RectContains(const VkRect2D &outer, const VkRect2D &inner) {
+	return outer.offset.x <= inner.offset.x && outer.offset.y <= inner.offset.y &&
+		outer.offset.x + (int64_t)outer.extent.width >= inner.offset.x + (int64_t)inner.extent.width &&
+		outer.offset.y + (int64_t)outer.extent.height >= inner.offset.y + (int64_t)inner.extent.height;
+}
+
+// Whether the step reads from or writes to fb, other than as a render pass to fb itself.
+static bool StepUsesFramebuffer(const VKRStep *step, VKRFramebuffer *fb) {
+	if (step->dependencies.contains(fb))
+		return true;
+	switch (step->stepType) {
+	case VKRStepType::COPY:
+		return step->copy.src == fb || step->copy.dst == fb;
+	case VKRStepType::BLIT:
+		return step->blit.src == fb || step->blit.dst == fb;
+	case VKRStepType::READBACK:
+		return step->readback.src == fb;
+	default:
+		return false;
+	}
+}
+
 void VulkanQueueRunner::CreateDeviceObjects() {
 	INFO_LOG(G3D, "VulkanQueueRunner::CreateDeviceObjects");
 
@@ -268,7 +291,11 @@ void VulkanQueueRunner::PreprocessSteps(std::vector<VKRStep *> &steps) {
 	//    as early as possible in the frame (Wipeout billboards). This will require taking over more of descriptor management so we can
 	//    substitute descriptors, alternatively using texture array layers creatively.
 
+	optimizeStats_ = {};
 	for (int j = 0; j < (int)steps.size(); j++) {
+		if (steps[j]->stepType == VKRStepType::RENDER) {
+			optimizeStats_.renderPasses++;
+		}
 		if (steps[j]->stepType == VKRStepType::RENDER &&
 			steps[j]->render.framebuffer) {
 			if (steps[j]->render.finalColorLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
@@ -311,6 +338,7 @@ void VulkanQueueRunner::PreprocessSteps(std::vector<VKRStep *> &steps) {
 					steps[i]->render.numReads += steps[j]->render.numReads;
 					// Cheaply skip the first step.
 					steps[j]->stepType = VKRStepType::RENDER_SKIP;
+					optimizeStats_.mergedPasses++;
 					break;
 				} else if (steps[i]->stepType == VKRStepType::COPY &&
 					steps[i]->copy.src == steps[j]->render.framebuffer) {
@@ -336,18 +364,28 @@ void VulkanQueueRunner::PreprocessSteps(std::vector<VKRStep *> &steps) {
 			ApplyRenderPassMerge(steps);
 		}
 	}
+
+	// Must run last, since merges change what the next use of each framebuffer is.
+	ApplyStoreOpOptimization(steps);
 }
 
 void VulkanQueueRunner::RunSteps(std::vector<VKRStep *> &steps, FrameData &frameData, FrameDataShared &frameDataShared, bool keepSteps) {
 	QueueProfileContext *profile = frameData.profile.enabled ? &frameData.profile : nullptr;
 
-	if (profile)
+	if (profile) {
 		profile->cpuStartTime = time_now_d();
+		profile->optimizeStats = optimizeStats_;
+	}
+	pipelineBlockedBinds_ = 0;
+	pipelineBlockedUs_ = 0;
+	pipelineSkippedDraws_ = 0;
 
 	bool emitLabels = vulkan_->Extensions().EXT_debug_utils;
 
 	VkCommandBuffer cmd = frameData.hasPresentCommands ? frameData.presentCmd : frameData.mainCmd;
 
+	RecordRenderPassesInParallel(steps, frameData);
+
 	for (size_t i = 0; i < steps.size(); i++) {
 		const VKRStep &step = *steps[i];
 
@@ -394,7 +432,7 @@ void VulkanQueueRunner::RunSteps(std::vector<VKRStep *> &steps, FrameData &frame
 					vkCmdBeginDebugUtilsLabelEXT(cmd, &labelInfo);
 				}
 			}
-			PerformRenderPass(step, cmd);
+			PerformRenderPass(step, cmd, secondaryCmds_[i]);
 			break;
 		case VKRStepType::COPY:
 			PerformCopy(step, cmd);
@@ -431,8 +469,12 @@ void VulkanQueueRunner::RunSteps(std::vector<VKRStep *> &steps, FrameData &frame
 		steps.clear();
 	}
 
-	if (profile)
+	if (profile) {
 		profile->cpuEndTime = time_now_d();
+		profile->pipelineWaitStats.blockedBinds = pipelineBlockedBinds_;
+		profile->pipelineWaitStats.blockedMs = pipelineBlockedUs_ * 0.001;
+		profile->pipelineWaitStats.skippedDraws = pipelineSkippedDraws_;
+	}
 }
 
 void VulkanQueueRunner::ApplyMGSHack(std::vector<VKRStep *> &steps) {
@@ -742,12 +784,14 @@ void VulkanQueueRunner::ApplyRenderPassMerge(std::vector<VKRStep *> &steps) {
 		}
 	}
 
-	auto mergeRenderSteps = [](VKRStep *dst, VKRStep *src) {
+	auto mergeRenderSteps = [&](VKRStep *dst, VKRStep *src) {
 		// OK. Now, if it's a render, slurp up all the commands and kill the step.
 		// Also slurp up any pretransitions.
 		dst->preTransitions.append(src->preTransitions);
 		dst->commands.insert(dst->commands.end(), src->commands.begin(), src->commands.end());
 		MergeRenderAreaRectInto(&dst->render.renderArea, src->render.renderArea);
+		// Whatever the merged pass read is now read by dst, later optimizations need to see that.
+		dst->dependencies.append(src->dependencies);
 		// So we don't consider it for other things, maybe doesn't matter.
 		src->dependencies.clear();
 		src->stepType = VKRStepType::RENDER_SKIP;
@@ -755,6 +799,17 @@ void VulkanQueueRunner::ApplyRenderPassMerge(std::vector<VKRStep *> &steps) {
 		dst->render.numReads += src->render.numReads;
 		dst->render.pipelineFlags |= src->render.pipelineFlags;
 		dst->render.renderPassType = MergeRPTypes(dst->render.renderPassType, src->render.renderPassType);
+		optimizeStats_.mergedPasses++;
+	};
+	// Copies and blits that don't involve fb, and don't conflict with anything between, can be
+	// moved up before the pass we're merging into. This is what lets us merge across ping-pong
+	// patterns like render A, copy A->B, render C sampling B, render A.
+	auto hoistStep = [&](int &i, int j) {
+		VKRStep *step = steps[j];
+		steps.erase(steps.begin() + j);
+		steps.insert(steps.begin() + i, step);
+		i++;
+		optimizeStats_.hoistedSteps++;
 	};
 	auto renderHasClear = [](const VKRStep *step) {
 		const auto &r = step->render;
@@ -767,6 +822,9 @@ void VulkanQueueRunner::ApplyRenderPassMerge(std::vector<VKRStep *> &steps) {
 		if (steps[i]->stepType == VKRStepType::RENDER && counts[steps[i]->render.framebuffer] > 1) {
 			auto fb = steps[i]->render.framebuffer;
 			TinySet<VKRFramebuffer *, 8> touchedFramebuffers;  // must be the same fast-size as the dependencies TinySet for annoying reasons.
+			// Framebuffers read between i and j, including by i itself. Nothing writing to these can be hoisted.
+			TinySet<VKRFramebuffer *, 8> readFramebuffers;
+			readFramebuffers.append(steps[i]->dependencies);
 			for (int j = i + 1; j < (int)steps.size(); j++) {
 				// If any other passes are reading from this framebuffer as-is, we cancel the scan.
 				if (steps[j]->dependencies.contains(fb)) {
@@ -782,11 +840,13 @@ void VulkanQueueRunner::ApplyRenderPassMerge(std::vector<VKRStep *> &steps) {
 							goto done_fb;
 						} else {
 							// Safe to merge, great.
+							readFramebuffers.append(steps[j]->dependencies);
 							mergeRenderSteps(steps[i], steps[j]);
 						}
 					} else {
 						// Remember the framebuffer this wrote to. We can't merge with later passes that depend on these.
 						touchedFramebuffers.insert(steps[j]->render.framebuffer);
+						readFramebuffers.append(steps[j]->dependencies);
 					}
 					break;
 				case VKRStepType::COPY:
@@ -794,18 +854,29 @@ void VulkanQueueRunner::ApplyRenderPassMerge(std::vector<VKRStep *> &steps) {
 						// Without framebuffer "renaming", we can't merge past a clobbered fb.
 						goto done_fb;
 					}
-					touchedFramebuffers.insert(steps[j]->copy.dst);
+					if (!touchedFramebuffers.contains(steps[j]->copy.src) && !touchedFramebuffers.contains(steps[j]->copy.dst) && !readFramebuffers.contains(steps[j]->copy.dst)) {
+						hoistStep(i, j);
+					} else {
+						touchedFramebuffers.insert(steps[j]->copy.dst);
+						readFramebuffers.insert(steps[j]->copy.src);
+					}
 					break;
 				case VKRStepType::BLIT:
 					if (steps[j]->blit.dst == fb) {
 						// Without framebuffer "renaming", we can't merge past a clobbered fb.
 						goto done_fb;
 					}
-					touchedFramebuffers.insert(steps[j]->blit.dst);
+					if (!touchedFramebuffers.contains(steps[j]->blit.src) && !touchedFramebuffers.contains(steps[j]->blit.dst) && !readFramebuffers.contains(steps[j]->blit.dst)) {
+						hoistStep(i, j);
+					} else {
+						touchedFramebuffers.insert(steps[j]->blit.dst);
+						readFramebuffers.insert(steps[j]->blit.src);
+					}
 					break;
 				case VKRStepType::READBACK:
 					// Not sure this has much effect, when executed READBACK is always the last step
 					// since we stall the GPU and wait immediately after.
+					readFramebuffers.insert(steps[j]->readback.src);
 					break;
 				case VKRStepType::RENDER_SKIP:
 				case VKRStepType::READBACK_IMAGE:
@@ -821,6 +892,42 @@ void VulkanQueueRunner::ApplyRenderPassMerge(std::vector<VKRStep *> &steps) {
 	}
 }
 
+// If the next thing that happens to an attachment is a render pass that clears it or doesn't care
+// about its contents, over at least the same area, there's no need to store it. This saves a lot of
+// bandwidth on tilers. We don't look across frames, so the last pass to each framebuffer always stores.
+void VulkanQueueRunner::ApplyStoreOpOptimization(std::vector<VKRStep *> &steps) {
+	for (int i = 0; i < (int)steps.size(); i++) {
+		VKRStep *step = steps[i];
+		if (step->stepType != VKRStepType::RENDER || !step->render.framebuffer)
+			continue;
+
+		VKRFramebuffer *fb = step->render.framebuffer;
+		for (int j = i + 1; j < (int)steps.size(); j++) {
+			const VKRStep *next = steps[j];
+			if (next->stepType == VKRStepType::RENDER && next->render.framebuffer == fb) {
+				if (next->dependencies.contains(fb) || !RectContains(next->render.renderArea, step->render.renderArea))
+					break;
+				auto &r = step->render;
+				if (next->render.colorLoad != VKRRenderPassLoadAction::KEEP && r.colorStore == VKRRenderPassStoreAction::STORE) {
+					r.colorStore = VKRRenderPassStoreAction::DONT_CARE;
+					optimizeStats_.droppedStores++;
+				}
+				if (next->render.depthLoad != VKRRenderPassLoadAction::KEEP && r.depthStore == VKRRenderPassStoreAction::STORE) {
+					r.depthStore = VKRRenderPassStoreAction::DONT_CARE;
+					optimizeStats_.droppedStores++;
+				}
+				if (next->render.stencilLoad != VKRRenderPassLoadAction::KEEP && r.stencilStore == VKRRenderPassStoreAction::STORE) {
+					r.stencilStore = VKRRenderPassStoreAction::DONT_CARE;
+					optimizeStats_.droppedStores++;
+				}
+				break;
+			}
+			if (StepUsesFramebuffer(next, fb))
+				break;
+		}
+	}
+}
+
 void VulkanQueueRunner::LogSteps(const std::vector<VKRStep *> &steps, bool verbose) {
 	INFO_LOG(G3D, "===================  FRAME  ====================");
 	for (size_t i = 0; i < steps.size(); i++) {
@@ -1123,7 +1230,7 @@ void TransitionFromOptimal(VkCommandBuffer cmd, VkImage colorImage, VkImageLayou
 	}
 }
 
-void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer cmd) {
+void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer cmd, VkCommandBuffer secondary) {
 	for (size_t i = 0; i < step.preTransitions.size(); i++) {
 		const TransitionRequest &iter = step.preTransitions[i];
 		if (iter.aspect == VK_IMAGE_ASPECT_COLOR_BIT && iter.fb->color.layout != iter.targetLayout) {
@@ -1203,8 +1310,28 @@ void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer c
 	// will transition to the desired final layout.
 	//
 	// NOTE: Flushes recordBarrier_.
-	VKRRenderPass *renderPass = PerformBindFramebufferAsRenderTarget(step, cmd);
+	VKRRenderPass *renderPass = PerformBindFramebufferAsRenderTarget(step, cmd, secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+	if (secondary) {
+		vkCmdExecuteCommands(cmd, 1, &secondary);
+	} else {
+		RecordRenderPassCommands(step, renderPass, cmd);
+	}
+	vkCmdEndRenderPass(cmd);
+
+	VKRFramebuffer *fb = step.render.framebuffer;
+	if (fb) {
+		// If the desired final layout aren't the optimal layout for rendering, transition.
+		TransitionFromOptimal(cmd, fb->color.image, step.render.finalColorLayout, fb->depth.image, fb->numLayers, step.render.finalDepthStencilLayout);
+
+		fb->color.layout = step.render.finalColorLayout;
+		fb->depth.layout = step.render.finalDepthStencilLayout;
+	}
+}
 
+// Records the contents of a render pass, which must already have been begun on cmd (or be inherited, for secondaries.)
+// Can run on a worker thread once ResolvePipelines has been called, it then never has to wait for a pipeline.
+void VulkanQueueRunner::RecordRenderPassCommands(const VKRStep &step, VKRRenderPass *renderPass, VkCommandBuffer cmd) {
 	int curWidth = step.render.framebuffer ? step.render.framebuffer->width : vulkan_->GetBackbufferWidth();
 	int curHeight = step.render.framebuffer ? step.render.framebuffer->height : vulkan_->GetBackbufferHeight();
 
@@ -1222,6 +1349,7 @@ void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer c
 	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
 
 	bool pipelineOK = false;
+	int skippedDraws = 0;
 
 	int lastStencilWriteMask = -1;
 	int lastStencilCompareMask = -1;
@@ -1257,7 +1385,17 @@ void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer c
 					graphicsPipeline->Create(vulkan_, renderPass->Get(vulkan_, rpType, fbSampleCount), rpType, fbSampleCount, time_now_d(), -1);
 				}
 
-				VkPipeline pipeline = graphicsPipeline->pipeline[(size_t)rpType]->BlockUntilReady();
+				Promise<VkPipeline> *promise = graphicsPipeline->pipeline[(size_t)rpType];
+				VkPipeline pipeline;
+				if (promise->Ready()) {
+					pipeline = promise->BlockUntilReady();
+				} else {
+					// Still compiling. The compile thread queues these as urgent, but it can still happen.
+					double waitStart = time_now_d();
+					pipeline = promise->BlockUntilReady();
+					pipelineBlockedBinds_++;
+					pipelineBlockedUs_ += (int64_t)((time_now_d() - waitStart) * 1000000.0);
+				}
 
 				if (pipeline != VK_NULL_HANDLE) {
 					vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
@@ -1355,7 +1493,9 @@ void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer c
 			break;
 
 		case VKRRenderCommand::DRAW_INDEXED:
-			if (pipelineOK) {
+			if (!pipelineOK) {
+				skippedDraws++;
+			} else {
 				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &c.drawIndexed.ds, c.drawIndexed.numUboOffsets, c.drawIndexed.uboOffsets);
 				vkCmdBindIndexBuffer(cmd, c.drawIndexed.ibuffer, c.drawIndexed.ioffset, VK_INDEX_TYPE_UINT16);
 				VkDeviceSize voffset = c.drawIndexed.voffset;
@@ -1365,7 +1505,9 @@ void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer c
 			break;
 
 		case VKRRenderCommand::DRAW:
-			if (pipelineOK) {
+			if (!pipelineOK) {
+				skippedDraws++;
+			} else {
 				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &c.draw.ds, c.draw.numUboOffsets, c.draw.uboOffsets);
 				if (c.draw.vbuffer) {
 					vkCmdBindVertexBuffers(cmd, 0, 1, &c.draw.vbuffer, &c.draw.voffset);
@@ -1421,18 +1563,119 @@ void VulkanQueueRunner::PerformRenderPass(const VKRStep &step, VkCommandBuffer c
 			break;
 		}
 	}
-	vkCmdEndRenderPass(cmd);
 
-	if (fb) {
-		// If the desired final layout aren't the optimal layout for rendering, transition.
-		TransitionFromOptimal(cmd, fb->color.image, step.render.finalColorLayout, fb->depth.image, fb->numLayers, step.render.finalDepthStencilLayout);
+	if (skippedDraws) {
+		pipelineSkippedDraws_ += skippedDraws;
+	}
+}
 
-		fb->color.layout = step.render.finalColorLayout;
-		fb->depth.layout = step.render.finalDepthStencilLayout;
+// Does the same on-demand pipeline creation as RecordRenderPassCommands, ahead of time, and waits for
+// every pipeline the step binds. The pipelines are compiled on the same thread pool the recording runs
+// on, so a worker waiting for one could end up waiting on a task queued behind itself.
+void VulkanQueueRunner::ResolvePipelines(const VKRStep &step, VKRRenderPass *renderPass) {
+	const RenderPassType rpType = step.render.renderPassType;
+	VkSampleCountFlagBits fbSampleCount = step.render.framebuffer ? step.render.framebuffer->sampleCount : VK_SAMPLE_COUNT_1_BIT;
+	VKRGraphicsPipeline *lastGraphicsPipeline = nullptr;
+	VKRComputePipeline *lastComputePipeline = nullptr;
+	const auto &commands = step.commands;
+	for (size_t i = 0; i < commands.size(); i++) {
+		const VkRenderData &c = commands[i];
+		if (c.cmd == VKRRenderCommand::BIND_COMPUTE_PIPELINE && c.compute_pipeline.pipeline != lastComputePipeline) {
+			lastComputePipeline = c.compute_pipeline.pipeline;
+			if (lastComputePipeline->pipeline)
+				lastComputePipeline->pipeline->BlockUntilReady();
+			continue;
+		}
+		if (c.cmd != VKRRenderCommand::BIND_GRAPHICS_PIPELINE || c.graphics_pipeline.pipeline == lastGraphicsPipeline)
+			continue;
+		VKRGraphicsPipeline *graphicsPipeline = c.graphics_pipeline.pipeline;
+		if (!graphicsPipeline->pipeline[(size_t)rpType]) {
+			graphicsPipeline->pipeline[(size_t)rpType] = Promise<VkPipeline>::CreateEmpty();
+			graphicsPipeline->Create(vulkan_, renderPass->Get(vulkan_, rpType, fbSampleCount), rpType, fbSampleCount, time_now_d(), -1);
+		}
+		Promise<VkPipeline> *promise = graphicsPipeline->pipeline[(size_t)rpType];
+		if (!promise->Ready()) {
+			double waitStart = time_now_d();
+			promise->BlockUntilReady();
+			pipelineBlockedBinds_++;
+			pipelineBlockedUs_ += (int64_t)((time_now_d() - waitStart) * 1000000.0);
+		}
+		lastGraphicsPipeline = graphicsPipeline;
+	}
+}
+
+// Large render passes are recorded into secondary command buffers on worker threads. All the state tracking
+// (image layouts, barriers, render pass and framebuffer lookup) stays on this thread, in step order, so the
+// workers only translate VkRenderData into vkCmd calls.
+void VulkanQueueRunner::RecordRenderPassesInParallel(const std::vector<VKRStep *> &steps, FrameData &frameData) {
+	secondaryCmds_.assign(steps.size(), VK_NULL_HANDLE);
+	if (!parallelRecording_)
+		return;
+
+	struct Job {
+		const VKRStep *step;
+		VKRRenderPass *renderPass;
+		VkCommandBufferInheritanceInfo inherit;
+		VkCommandBuffer cmd;
+		size_t stepIndex;
+	};
+	std::vector<Job> jobs;
+	for (size_t i = 0; i < steps.size(); i++) {
+		const VKRStep &step = *steps[i];
+		// The backbuffer pass is left alone, it's special in several ways (rotation, present cmdbuf.)
+		if (step.stepType != VKRStepType::RENDER || !step.render.framebuffer || step.commands.size() < MIN_PARALLEL_RENDER_COMMANDS)
+			continue;
+		Job job{};
+		job.step = &step;
+		job.stepIndex = i;
+		jobs.push_back(job);
+	}
+
+	// With just one, we'd only be adding overhead.
+	if (jobs.size() < 2)
+		return;
+
+	for (Job &job : jobs) {
+		const VKRStep &step = *job.step;
+		RPKey key{
+			step.render.colorLoad, step.render.depthLoad, step.render.stencilLoad,
+			step.render.colorStore, step.render.depthStore, step.render.stencilStore,
+		};
+		VKRFramebuffer *fb = step.render.framebuffer;
+		job.renderPass = GetRenderPass(key);
+		job.inherit = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+		job.inherit.renderPass = job.renderPass->Get(vulkan_, step.render.renderPassType, fb->sampleCount);
+		job.inherit.subpass = 0;
+		job.inherit.framebuffer = fb->Get(job.renderPass, step.render.renderPassType);
+		ResolvePipelines(step, job.renderPass);
+		job.cmd = frameData.AllocSecondaryCmd(vulkan_);
+	}
+
+	ParallelRangeLoop(&g_threadManager, [&](int lower, int upper) {
+		for (int i = lower; i < upper; i++) {
+			Job &job = jobs[i];
+			if (!job.cmd)
+				continue;
+			VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+			begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+			begin.pInheritanceInfo = &job.inherit;
+			if (vkBeginCommandBuffer(job.cmd, &begin) != VK_SUCCESS) {
+				job.cmd = VK_NULL_HANDLE;
+				continue;
+			}
+			RecordRenderPassCommands(*job.step, job.renderPass, job.cmd);
+			if (vkEndCommandBuffer(job.cmd) != VK_SUCCESS) {
+				job.cmd = VK_NULL_HANDLE;
+			}
+		}
+	}, 0, (int)jobs.size(), 1, TaskPriority::HIGH);
+
+	for (const Job &job : jobs) {
+		secondaryCmds_[job.stepIndex] = job.cmd;
 	}
 }
 
-VKRRenderPass *VulkanQueueRunner::PerformBindFramebufferAsRenderTarget(const VKRStep &step, VkCommandBuffer cmd) {
+VKRRenderPass *VulkanQueueRunner::PerformBindFramebufferAsRenderTarget(const VKRStep &step, VkCommandBuffer cmd, VkSubpassContents contents) {
 	VKRRenderPass *renderPass;
 	int numClearVals = 0;
 	VkClearValue clearVal[4]{};
@@ -1543,7 +1786,7 @@ VKRRenderPass *VulkanQueueRunner::PerformBindFramebufferAsRenderTarget(const VKR
 	rp_begin.renderArea = rc;
 	rp_begin.clearValueCount = numClearVals;
 	rp_begin.pClearValues = numClearVals ? clearVal : nullptr;
-	vkCmdBeginRenderPass(cmd, &rp_begin, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(cmd, &rp_begin, contents);
 
 	return renderPass;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <mutex>
 #include <condition_variable>
@@ -272,6 +273,11 @@ class VulkanQueueRunner {
 		return found;
 	}
 
+	// Record large render passes on worker threads. On by default.
+	void EnableParallelRecording(bool enable) {
+		parallelRecording_ = enable;
+	}
+
 	void EnableHacks(uint32_t hacks) {
 		hacksEnabled_ = hacks;
 	}
@@ -289,8 +295,11 @@ class VulkanQueueRunner {
 	bool InitBackbufferFramebuffers(int width, int height);
 	bool InitDepthStencilBuffer(VkCommandBuffer cmd);  // Used for non-buffered rendering.
 
-	VKRRenderPass *PerformBindFramebufferAsRenderTarget(const VKRStep &pass, VkCommandBuffer cmd);
-	void PerformRenderPass(const VKRStep &pass, VkCommandBuffer cmd);
+	VKRRenderPass *PerformBindFramebufferAsRenderTarget(const VKRStep &pass, VkCommandBuffer cmd, VkSubpassContents contents);
+	void PerformRenderPass(const VKRStep &pass, VkCommandBuffer cmd, VkCommandBuffer secondary);
+	void RecordRenderPassCommands(const VKRStep &pass, VKRRenderPass *renderPass, VkCommandBuffer cmd);
+	void ResolvePipelines(const VKRStep &pass, VKRRenderPass *renderPass);
+	void RecordRenderPassesInParallel(const std::vector<VKRStep *> &steps, FrameData &frameData);
 	void PerformCopy(const VKRStep &pass, VkCommandBuffer cmd);
 	void PerformBlit(const VKRStep &pass, VkCommandBuffer cmd);
 	void PerformReadback(const VKRStep &pass, VkCommandBuffer cmd, FrameData &frameData);
@@ -307,6 +316,7 @@ class VulkanQueueRunner {
 	void ApplyMGSHack(std::vector<VKRStep *> &steps);
 	void ApplySonicHack(std::vector<VKRStep *> &steps);
 	void ApplyRenderPassMerge(std::vector<VKRStep *> &steps);
+	void ApplyStoreOpOptimization(std::vector<VKRStep *> &steps);
 
 	static void SetupTransitionToTransferSrc(VKRImage &img, VkImageAspectFlags aspect, VulkanBarrier *recordBarrier);
 	static void SetupTransitionToTransferDst(VKRImage &img, VkImageAspectFlags aspect, VulkanBarrier *recordBarrier);
@@ -331,6 +341,20 @@ class VulkanQueueRunner {
 	// TODO: Enable based on compat.ini.
 	uint32_t hacksEnabled_ = 0;
 
+	// From the last PreprocessSteps, only touched on the render thread.
+	QueueOptimizeStats optimizeStats_{};
+
+	// Reset every RunSteps. Atomic since render passes can be recorded on worker threads.
+	std::atomic<int> pipelineBlockedBinds_{};
+	std::atomic<int64_t> pipelineBlockedUs_{};
+	std::atomic<int> pipelineSkippedDraws_{};
+
+	// Render passes with fewer commands than this are always recorded inline.
+	static const size_t MIN_PARALLEL_RENDER_COMMANDS = 256;
+	bool parallelRecording_ = true;
+	// Parallel to the steps passed to RunSteps. VK_NULL_HANDLE means record inline.
+	std::vector<VkCommandBuffer> secondaryCmds_;
+
 	// Compile done notifications.
 	std::mutex compileDoneMutex_;
 	std::condition_variable compileDone_;
@@ -393,6 +393,13 @@ VulkanRenderManager::~VulkanRenderManager() {
 
 	_dbg_assert_(!run_);  // StopThread should already have been called from DestroyBackbuffers.
 
+	{
+		// Background compile tasks call back into us when they finish.
+		std::unique_lock<std::mutex> lock(compileMutex_);
+		CancelBackgroundCompiles();
+		compileCond_.wait(lock, [&] { return backgroundCompilesInFlight_ == 0; });
+	}
+
 	vulkan_->WaitUntilQueueIdle();
 
 	VkDevice device = vulkan_->GetDevice();
@@ -414,7 +421,9 @@ struct SinglePipelineTask {
 
 class CreateMultiPipelinesTask : public Task {
 public:
-	CreateMultiPipelinesTask(VulkanContext *vulkan, std::vector<SinglePipelineTask> tasks) : vulkan_(vulkan), tasks_(tasks) {}
+	// If backgroundOwner is set, this is a speculative batch and it reports back when done.
+	CreateMultiPipelinesTask(VulkanContext *vulkan, std::vector<SinglePipelineTask> tasks, VulkanRenderManager *backgroundOwner = nullptr)
+		: vulkan_(vulkan), tasks_(tasks), backgroundOwner_(backgroundOwner) {}
 	~CreateMultiPipelinesTask() {}
 
 	TaskType Type() const override {
@@ -422,33 +431,66 @@ class CreateMultiPipelinesTask : public Task {
 	}
 
 	TaskPriority Priority() const override {
-		return TaskPriority::HIGH;
+		return backgroundOwner_ ? TaskPriority::LOW : TaskPriority::HIGH;
 	}
 
 	void Run() override {
 		for (auto &task : tasks_) {
 			task.pipeline->Create(vulkan_, task.compatibleRenderPass, task.rpType, task.sampleCount, task.scheduleTime, task.countToCompile);
 		}
+		if (backgroundOwner_) {
+			backgroundOwner_->BackgroundCompileDone();
+		}
 	}
 
 	VulkanContext *vulkan_;
 	std::vector<SinglePipelineTask> tasks_;
+	VulkanRenderManager *backgroundOwner_;
 };
 
 void VulkanRenderManager::CompileThreadFunc() {
 	SetCurrentThreadName("ShaderCompile");
 	while (true) {
 		std::vector<CompileQueueEntry> toCompile;
+		std::vector<std::vector<SinglePipelineTask>> backgroundBatches;
+		// Background compiles only use part of the thread pool, leaving room for urgent ones.
+		int maxBackgroundInFlight = std::max(1, g_threadManager.GetNumLooperThreads() / 2);
 		{
 			std::unique_lock<std::mutex> lock(compileMutex_);
 			// TODO: Should this be while?
 			// It may be beneficial also to unlock and wait a little bit to see if we get some more shaders
 			// so we can do a better job of thread-sorting them.
-			if (compileQueue_.empty() && run_) {
+			bool canStartBackground = !backgroundCompileQueue_.empty() && backgroundCompilesInFlight_ < maxBackgroundInFlight;
+			if (compileQueue_.empty() && !canStartBackground && run_) {
 				compileCond_.wait(lock);
 			}
-			toCompile = std::move(compileQueue_);
+			for (auto &entry : compileQueue_) {
+				if (entry.priority == TaskPriority::HIGH) {
+					toCompile.push_back(entry);
+				} else {
+					entry.graphics->backgroundQueued |= 1 << (int)entry.renderPassType;
+					backgroundCompileQueue_.push_back(entry);
+				}
+			}
 			compileQueue_.clear();
+
+			// Leave the rest of the background queue for when we start again.
+			double scheduleTime = time_now_d();
+			while (run_ && !backgroundCompileQueue_.empty() && backgroundCompilesInFlight_ < maxBackgroundInFlight) {
+				std::vector<SinglePipelineTask> batch;
+				while (!backgroundCompileQueue_.empty() && batch.size() < (size_t)BACKGROUND_COMPILE_BATCH) {
+					const CompileQueueEntry &entry = backgroundCompileQueue_.front();
+					u32 bit = 1 << (int)entry.renderPassType;
+					// If the bit is gone, it was promoted and is already being compiled.
+					if (entry.graphics->backgroundQueued & bit) {
+						entry.graphics->backgroundQueued &= ~bit;
+						batch.push_back(SinglePipelineTask{ entry.graphics, entry.compatibleRenderPass, entry.renderPassType, entry.sampleCount, scheduleTime, (int)backgroundCompileQueue_.size() });
+					}
+					backgroundCompileQueue_.pop_front();
+				}
+				backgroundBatches.push_back(std::move(batch));
+				backgroundCompilesInFlight_++;
+			}
 		}
 		if (!run_) {
 			break;
@@ -496,12 +538,42 @@ void VulkanRenderManager::CompileThreadFunc() {
 			g_threadManager.EnqueueTask(task);
 		}
 
+		// Queued after the urgent ones, and at low priority, so they don't get in their way.
+		for (auto &batch : backgroundBatches) {
+			g_threadManager.EnqueueTask(new CreateMultiPipelinesTask(vulkan_, batch, this));
+		}
+
 		queueRunner_.NotifyCompileDone();
 	}
 }
 
+// A draw needs a pipeline variant that so far was only queued speculatively, claim it so the
+// caller can queue it as urgent. The stale entry stays in the background queue and is skipped.
+bool VulkanRenderManager::PromoteBackgroundCompile(VKRGraphicsPipeline *pipeline, RenderPassType rpType) {
+	u32 bit = 1 << (int)rpType;
+	if (!(pipeline->backgroundQueued & bit))
+		return false;
+	pipeline->backgroundQueued &= ~bit;
+	return true;
+}
+
+// Fulfills the promises of speculative compiles that haven't started, without compiling them.
+// The variants remain, so they're still saved to the pipeline cache.
+void VulkanRenderManager::CancelBackgroundCompiles() {
+	for (auto &entry : backgroundCompileQueue_) {
+		u32 bit = 1 << (int)entry.renderPassType;
+		if (entry.graphics->backgroundQueued & bit) {
+			entry.graphics->backgroundQueued &= ~bit;
+			entry.graphics->pipeline[(size_t)entry.renderPassType]->Post(VK_NULL_HANDLE);
+		}
+	}
+	backgroundCompileQueue_.clear();
+}
+
 void VulkanRenderManager::DrainCompileQueue() {
 	std::unique_lock<std::mutex> lock(compileMutex_);
+	// Nothing will draw with the speculative ones anymore, no point in compiling them now.
+	CancelBackgroundCompiles();
 	compileCond_.notify_all();
 	while (!compileQueue_.empty()) {
 		queueRunner_.WaitForCompileNotification();
@@ -683,6 +755,22 @@ void VulkanRenderManager::BeginFrame(bool enableProfiling, bool enableLogProfile
 			str << line;
 			frameData.profile.profileSummary = str.str();
 		}
+
+		const QueueOptimizeStats &stats = frameData.profile.optimizeStats;
+		char line[256];
+		snprintf(line, sizeof(line), "Render passes: %d (%d merged), steps hoisted: %d, stores dropped: %d\n",
+			stats.renderPasses - stats.mergedPasses, stats.mergedPasses, stats.hoistedSteps, stats.droppedStores);
+		frameData.profile.profileSummary += line;
+
+		const PipelineWaitStats &waitStats = frameData.profile.pipelineWaitStats;
+		int backgroundCompiles;
+		{
+			std::lock_guard<std::mutex> guard(compileMutex_);
+			backgroundCompiles = (int)backgroundCompileQueue_.size();
+		}
+		snprintf(line, sizeof(line), "Pipeline waits: %d (%0.2f ms), draws skipped: %d, background compiles queued: %d\n",
+			waitStats.blockedBinds, waitStats.blockedMs, waitStats.skippedDraws, backgroundCompiles);
+		frameData.profile.profileSummary += line;
 	}
 
 	// Must be after the fence - this performs deletes.
@@ -751,7 +839,10 @@ VKRGraphicsPipeline *VulkanRenderManager::CreateGraphicsPipeline(VKRGraphicsPipe
 			}
 
 			pipeline->pipeline[i] = Promise<VkPipeline>::CreateEmpty();
-			compileQueue_.push_back(CompileQueueEntry(pipeline, compatibleRenderPass->Get(vulkan_, rpType, sampleCount), rpType, sampleCount));
+			CompileQueueEntry entry(pipeline, compatibleRenderPass->Get(vulkan_, rpType, sampleCount), rpType, sampleCount);
+			// Only a guess that these will be needed, so don't let them delay pipelines that are.
+			entry.priority = cacheLoad ? TaskPriority::LOW : TaskPriority::HIGH;
+			compileQueue_.push_back(entry);
 			needsCompile = true;
 		}
 		if (needsCompile)
@@ -822,6 +913,9 @@ void VulkanRenderManager::EndCurRenderStep() {
 			_assert_(renderPass);
 			compileQueue_.push_back(CompileQueueEntry(pipeline, renderPass->Get(vulkan_, rpType, sampleCount), rpType, sampleCount));
 			needsCompile = true;
+		} else if (PromoteBackgroundCompile(pipeline, rpType)) {
+			compileQueue_.push_back(CompileQueueEntry(pipeline, renderPass->Get(vulkan_, rpType, sampleCount), rpType, sampleCount));
+			needsCompile = true;
 		}
 	}
 	if (needsCompile)
@@ -1424,6 +1518,7 @@ void VulkanRenderManager::Run(VKRRenderThreadTask &task) {
 		// Effectively resets both main and present command buffers, since they both live in this pool.
 		// We always record main commands first, so we don't need to reset the present command buffer separately.
 		vkResetCommandPool(vulkan_->GetDevice(), frameData.cmdPoolMain, 0);
+		frameData.ResetSecondaryCmds(vulkan_);
 
 		VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
 		begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
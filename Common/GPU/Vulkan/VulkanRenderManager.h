@@ -11,6 +11,7 @@
 #include <mutex>
 #include <thread>
 #include <queue>
+#include <deque>
 
 #include "Common/Math/Statistics.h"
 #include "Common/Thread/Promise.h"
@@ -137,6 +138,8 @@ struct VKRGraphicsPipeline {
 
 	VKRGraphicsPipelineDesc *desc = nullptr;
 	Promise<VkPipeline> *pipeline[(size_t)RenderPassType::TYPE_COUNT]{};
+	// Variants waiting in the background compile queue, one bit per RenderPassType. Protected by compileMutex_.
+	u32 backgroundQueued = 0;
 
 	VkSampleCountFlagBits SampleCount() const { return sampleCount_; }
 
@@ -178,6 +181,8 @@ struct CompileQueueEntry {
 	VKRGraphicsPipeline *graphics = nullptr;
 	VKRComputePipeline *compute = nullptr;
 	VkSampleCountFlagBits sampleCount;
+	// HIGH: needed by a draw in the current frame. LOW: speculative, from loading the pipeline cache.
+	TaskPriority priority = TaskPriority::HIGH;
 };
 
 class VulkanRenderManager {
@@ -240,6 +245,13 @@ class VulkanRenderManager {
 		compileMutex_.unlock();
 	}
 
+	// Called by background compile tasks when they finish, so the compile thread can hand out more.
+	void BackgroundCompileDone() {
+		std::lock_guard<std::mutex> guard(compileMutex_);
+		backgroundCompilesInFlight_--;
+		compileCond_.notify_one();
+	}
+
 	void BindPipeline(VKRGraphicsPipeline *pipeline, PipelineFlags flags, VkPipelineLayout pipelineLayout) {
 		_dbg_assert_(curRenderStep_ && curRenderStep_->stepType == VKRStepType::RENDER);
 		_dbg_assert_(pipeline != nullptr);
@@ -463,6 +475,9 @@ class VulkanRenderManager {
 
 	void ThreadFunc();
 	void CompileThreadFunc();
+	// These require compileMutex_ to be held.
+	bool PromoteBackgroundCompile(VKRGraphicsPipeline *pipeline, RenderPassType rpType);
+	void CancelBackgroundCompiles();
 
 	void Run(VKRRenderThreadTask &task);
 
@@ -527,6 +542,11 @@ class VulkanRenderManager {
 	std::condition_variable compileCond_;
 	std::mutex compileMutex_;
 	std::vector<CompileQueueEntry> compileQueue_;
+	// Speculative compiles, handed to the thread manager a few at a time so they never delay urgent ones much.
+	// Entries move back to compileQueue_ if a draw ends up needing them first.
+	std::deque<CompileQueueEntry> backgroundCompileQueue_;
+	int backgroundCompilesInFlight_ = 0;
+	static const int BACKGROUND_COMPILE_BATCH = 4;
 
 	// Thread for measuring presentation delay.
 	std::thread presentWaitThread_;
@@ -33,6 +33,7 @@
 #include "Common/TimeUtil.h"
 #include "Common/File/FileUtil.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ThreadUtil.h"
 
 // Don't need to savestate this.
 const char *hleCurrentThreadName = nullptr;
@@ -77,6 +78,70 @@ bool GenericLogEnabled(LogLevel level, LogType type) {
 
 LogManager *LogManager::logManager_ = NULL;
 
+// Bounded lock-free multi-producer, single-consumer queue of log messages.
+// Each slot carries a sequence number that tells producers and the consumer whose turn it is,
+// so pushing only costs a CAS on the write position (D. Vyukov's bounded queue).
+class LogQueue {
+public:
+	explicit LogQueue(size_t capacity) : slots_(new Slot[capacity]), mask_(capacity - 1) {
+		_dbg_assert_((capacity & mask_) == 0);
+		for (size_t i = 0; i < capacity; i++) {
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	~LogQueue() {
+		delete[] slots_;
+	}
+
+	// Returns false if the queue is full.
+	bool Push(LogMessage &&message) {
+		size_t pos = writePos_.load(std::memory_order_relaxed);
+		Slot *slot;
+		while (true) {
+			slot = &slots_[pos & mask_];
+			size_t seq = slot->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (writePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = writePos_.load(std::memory_order_relaxed);
+			}
+		}
+		slot->message = std::move(message);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Must only be called by one thread at a time.
+	bool Pop(LogMessage *message) {
+		Slot *slot = &slots_[readPos_ & mask_];
+		size_t seq = slot->sequence.load(std::memory_order_acquire);
+		if ((intptr_t)seq - (intptr_t)(readPos_ + 1) < 0)
+			return false;
+		*message = std::move(slot->message);
+		slot->sequence.store(readPos_ + mask_ + 1, std::memory_order_release);
+		readPos_++;
+		return true;
+	}
+
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		LogMessage message;
+	};
+
+	Slot *slots_;
+	size_t mask_;
+	std::atomic<size_t> writePos_{};
+	size_t readPos_ = 0;
+};
+
+// Must be a power of two.
+static const size_t LOG_QUEUE_SIZE = 4096;
+
 // NOTE: Needs to be kept in sync with the LogType enum.
 static const char *g_logTypeNames[] = {
 	"SYSTEM",
@@ -157,6 +222,11 @@ LogManager::LogManager(bool *enabledSetting) {
 }
 
 LogManager::~LogManager() {
+	// Stops the writer thread and delivers anything still queued.
+	SetAsync(false);
+	DrainQueue();
+	delete queue_;
+
 	for (int i = 0; i < (int)LogType::NUMBER_OF_LOGS; ++i) {
 #if !defined(MOBILE_DEVICE) || defined(_DEBUG)
 		RemoveListener(fileLog_);
@@ -192,7 +262,91 @@ void LogManager::ChangeFileLog(const char *filename) {
 	}
 }
 
+void LogManager::SetAsync(bool async) {
+	std::unique_lock<std::mutex> guard(writerLock_);
+	if (async == writerRunning_)
+		return;
+
+	if (async) {
+		// The queue is kept around once created, since other threads may still be pushing to it.
+		if (!queue_)
+			queue_ = new LogQueue(LOG_QUEUE_SIZE);
+		writerRunning_ = true;
+		async_ = true;
+		writerThread_ = std::thread([this] { WriterThreadFunc(); });
+	} else {
+		async_ = false;
+		// Let logging threads that already saw async_ set finish their push, so nothing
+		// can land in the queue after the final drain below.
+		while (pushers_ != 0)
+			std::this_thread::yield();
+		writerRunning_ = false;
+		writerCond_.notify_one();
+		guard.unlock();
+		writerThread_.join();
+		// Catch anything that was pushed while we were switching over.
+		DrainQueue();
+	}
+}
+
+void LogManager::WriterThreadFunc() {
+	SetCurrentThreadName("LogWriter");
+
+	std::unique_lock<std::mutex> guard(writerLock_);
+	while (writerRunning_) {
+		// Polling keeps the logging threads from having to signal on every message.
+		writerCond_.wait_for(guard, std::chrono::milliseconds(10));
+		guard.unlock();
+		DrainQueue();
+		guard.lock();
+	}
+}
+
+void LogManager::Flush() {
+	if (async_)
+		DrainQueue();
+}
+
+void LogManager::DrainQueue() {
+	if (!queue_)
+		return;
+
+	std::lock_guard<std::mutex> drainGuard(drainLock_);
+	std::lock_guard<std::mutex> listeners_lock(listeners_lock_);
+
+	LogMessage message;
+	bool any = false;
+	while (queue_->Pop(&message)) {
+		for (auto &iter : listeners_) {
+			iter->Log(message);
+		}
+		any = true;
+	}
+
+	uint32_t dropped = droppedCount_;
+	if (dropped != droppedReported_) {
+		LogMessage note;
+		note.level = LogLevel::LWARNING;
+		note.log = log_[(size_t)LogType::SYSTEM].m_shortName;
+		GetTimeFormatted(note.timestamp);
+		snprintf(note.header, sizeof(note.header), "LogManager %c[%s]:", level_to_char[(int)note.level], note.log);
+		note.msg = StringFromFormat("%u log messages dropped, log queue was full\n", dropped - droppedReported_);
+		for (auto &iter : listeners_) {
+			iter->Log(note);
+		}
+		droppedReported_ = dropped;
+		any = true;
+	}
+
+	if (any) {
+		for (auto &iter : listeners_) {
+			iter->Flush();
+		}
+	}
+}
+
 void LogManager::SaveConfig(Section *section) {
+	section->Set("AsyncWriter", IsAsync());
 	for (int i = 0; i < (int)LogType::NUMBER_OF_LOGS; i++) {
 		section->Set((std::string(log_[i].m_shortName) + "Enabled").c_str(), log_[i].enabled);
 		section->Set((std::string(log_[i].m_shortName) + "Level").c_str(), (int)log_[i].level);
@@ -200,6 +354,10 @@ void LogManager::SaveConfig(Section *section) {
 }
 
 void LogManager::LoadConfig(const Section *section, bool debugDefaults) {
+	bool async = false;
+	section->Get("AsyncWriter", &async, false);
+	SetAsync(async);
+
 	for (int i = 0; i < (int)LogType::NUMBER_OF_LOGS; i++) {
 		bool enabled = false;
 		int level = 0;
@@ -261,9 +419,25 @@ void LogManager::Log(LogLevel level, LogType type, const char *file, int line, c
 	message.msg[neededBytes] = '\n';
 	va_end(args_copy);
 
+	if (async_) {
+		// Check again after announcing ourselves, SetAsync(false) waits for pushers_ to drop to zero.
+		pushers_++;
+		if (async_) {
+			if (!queue_->Push(std::move(message)))
+				droppedCount_++;
+			pushers_--;
+			// Errors often come right before a crash, so get them (and everything before them) out now.
+			if (level <= LogLevel::LERROR)
+				DrainQueue();
+			return;
+		}
+		pushers_--;
+	}
+
 	std::lock_guard<std::mutex> listeners_lock(listeners_lock_);
 	for (auto &iter : listeners_) {
 		iter->Log(message);
+		iter->Flush();
 	}
 }
 
@@ -316,6 +490,13 @@ void FileLogListener::Log(const LogMessage &message) {
 
 	std::lock_guard<std::mutex> lk(m_log_lock);
 	fprintf(fp_, "%s %s %s", message.timestamp, message.header, message.msg.c_str());
+}
+
+void FileLogListener::Flush() {
+	if (!IsEnabled() || !IsValid())
+		return;
+
+	std::lock_guard<std::mutex> lk(m_log_lock);
 	fflush(fp_);
 }
 
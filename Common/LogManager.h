@@ -19,7 +19,10 @@
 
 #include "ppsspp_config.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <cstdarg>
 #include <cstdio>
@@ -48,6 +51,8 @@ class LogListener {
 	virtual ~LogListener() {}
 
 	virtual void Log(const LogMessage &msg) = 0;
+	// Called after a message or a batch of messages has been delivered.
+	virtual void Flush() {}
 };
 
 class FileLogListener : public LogListener {
@@ -56,6 +61,7 @@ class FileLogListener : public LogListener {
 	~FileLogListener();
 
 	void Log(const LogMessage &msg) override;
+	void Flush() override;
 
 	bool IsValid() { if (!fp_) return false; else return true; }
 	bool IsEnabled() const { return m_enable; }
@@ -104,6 +110,7 @@ struct LogChannel {
 };
 
 class ConsoleListener;
+class LogQueue;
 
 class LogManager {
 private:
@@ -124,6 +131,23 @@ class LogManager {
 	std::mutex listeners_lock_;
 	std::vector<LogListener*> listeners_;
 
+	// Asynchronous mode. Messages are formatted on the logging thread, then queued
+	// and delivered to the listeners in batches by a writer thread.
+	void WriterThreadFunc();
+	void DrainQueue();
+
+	LogQueue *queue_ = nullptr;
+	std::atomic<bool> async_{};
+	// Logging threads currently between checking async_ and pushing to the queue.
+	std::atomic<int> pushers_{};
+	std::atomic<uint32_t> droppedCount_{};
+	uint32_t droppedReported_ = 0;
+	std::mutex drainLock_;
+	std::thread writerThread_;
+	std::mutex writerLock_;
+	std::condition_variable writerCond_;
+	bool writerRunning_ = false;
+
 public:
 	void AddListener(LogListener *listener);
 	void RemoveListener(LogListener *listener);
@@ -182,6 +206,14 @@ class LogManager {
 
 	void ChangeFileLog(const char *filename);
 
+	// In async mode, log calls only format and enqueue the message. If the queue is full,
+	// messages are dropped and counted rather than stalling the caller.
+	void SetAsync(bool async);
+	bool IsAsync() const { return async_; }
+	// Delivers any queued messages right away. Call before anything that might not return, like a crash.
+	void Flush();
+	uint32_t GetDroppedCount() const { return droppedCount_; }
+
 	void SaveConfig(Section *section);
 	void LoadConfig(const Section *section, bool debugDefaults);
 };
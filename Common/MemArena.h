@@ -40,12 +40,20 @@ class MemArena {
 	void ReleaseSpace();
 	void *CreateView(s64 offset, size_t size, void *base = 0);
 	void ReleaseView(s64 offset, void *view, size_t size);
+	// After fork(), gives this process a private copy of the memory, so it stops being shared with the parent.
+	// Existing views still point at the old memory and must be recreated at the same addresses.
+	// Returns false where unsupported.
+	bool Unshare();
 
 	// This only finds 1 GB in 32-bit
 	u8 *Find4GBBase();
 	bool NeedsProbing();
 
+	// Only a hint, ignored where unsupported. Must be set before roundup() and GrabMemSpace().
+	void SetHugePages(bool enable) { hugePages_ = enable; }
+
 private:
+	bool hugePages_ = false;
 #ifdef _WIN32
 	HANDLE hMemoryMapping;
 	SYSTEM_INFO sysInfo;
@@ -54,5 +62,6 @@ class MemArena {
 	vm_address_t vm_mem;  // same type as vm_address_t
 #else
 	int fd = -1;
+	size_t size_ = 0;
 #endif
 };
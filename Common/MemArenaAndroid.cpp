@@ -133,6 +133,11 @@ void MemArena::ReleaseView(s64 offset, void* view, size_t size) {
 	munmap(view, size);
 }
 
+bool MemArena::Unshare() {
+	// Not implemented, fork() isn't used on Android.
+	return false;
+}
+
 u8* MemArena::Find4GBBase() {
 #if PPSSPP_ARCH(64BIT)
 	// We should probably just go look in /proc/self/maps for some free space.
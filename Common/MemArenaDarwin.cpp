@@ -84,6 +84,11 @@ void MemArena::ReleaseView(s64 offset, void* view, size_t size) {
 	vm_deallocate(mach_task_self(), addr, size);
 }
 
+bool MemArena::Unshare() {
+	// Not implemented yet. vm_remap() mirrors would need to be copied into a new region.
+	return false;
+}
+
 bool MemArena::NeedsProbing() {
 #if PPSSPP_PLATFORM(IOS) && PPSSPP_ARCH(64BIT)
 	return true;
@@ -63,6 +63,11 @@ void MemArena::ReleaseView(s64 offset, void *view, size_t size) {
 		printf("Failed to unmap view...\n");
 }
 
+bool MemArena::Unshare() {
+	// There's no fork() on Switch.
+	return false;
+}
+
 u8 *MemArena::Find4GBBase() {
 	memorySrcBase = (uintptr_t)memalign(0x1000, 0x10000000);
 
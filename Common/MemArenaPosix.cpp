@@ -25,7 +25,9 @@
 #include <unistd.h>
 #include <cerrno>
 #include <cstring>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #ifndef MAP_NORESERVE
 // Not implemented on BSDs
@@ -37,6 +39,9 @@
 #include "Common/MemoryUtil.h"
 #include "Common/MemArena.h"
 
+// Transparent huge pages need the file offset and address of a view to agree modulo this size.
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
 static const std::string tmpfs_location = "/dev/shm";
 static const std::string tmpfs_ram_temp_file = "/dev/shm/gc_mem.tmp";
 
@@ -44,6 +49,8 @@ static const std::string tmpfs_ram_temp_file = "/dev/shm/gc_mem.tmp";
 std::string ram_temp_file = "/tmp/gc_mem.tmp";
 
 size_t MemArena::roundup(size_t x) {
+	if (hugePages_)
+		return (x + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
 	return x;
 }
 
@@ -51,9 +58,54 @@ bool MemArena::NeedsProbing() {
 	return false;
 }
 
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+// Explicit hugetlb (MFD_HUGETLB) isn't usable here, since every view would need a 2MB aligned address,
+// and the scratchpad lives at 0x00010000. Instead we rely on transparent huge pages for shmem, which
+// the kernel only honors for memfd when shmem_enabled allows it.
+static int CreateHugePageMemFd() {
+	int memfd = memfd_create("ppsspp_ram", MFD_CLOEXEC);
+	if (memfd < 0) {
+		WARN_LOG(MEMMAP, "memfd_create failed, not using huge pages: %s", strerror(errno));
+		return -1;
+	}
+
+	char mode[128]{};
+	FILE *f = File::OpenCFile(Path("/sys/kernel/mm/transparent_hugepage/shmem_enabled"), "r");
+	if (f) {
+		if (!fgets(mode, sizeof(mode), f))
+			mode[0] = '\0';
+		fclose(f);
+		mode[strcspn(mode, "\n")] = '\0';
+	}
+	if (strstr(mode, "[never]") || strstr(mode, "[deny]") || !mode[0]) {
+		WARN_LOG(MEMMAP, "Huge pages requested, but shmem THP is disabled (shmem_enabled: %s)", mode[0] ? mode : "missing");
+	} else {
+		INFO_LOG(MEMMAP, "Using memfd with transparent huge pages (shmem_enabled: %s)", mode);
+	}
+	return memfd;
+}
+#endif
+
 bool MemArena::GrabMemSpace(size_t size) {
 #ifndef NO_MMAP
 	constexpr mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+	size_ = size;
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+	if (hugePages_) {
+		fd = CreateHugePageMemFd();
+		if (fd >= 0) {
+			if (ftruncate(fd, size) != 0) {
+				ERROR_LOG(MEMMAP, "Failed to ftruncate memfd %d to size %08x", (int)fd, (int)size);
+			}
+			return true;
+		}
+		// The layout from roundup() is still valid, it just wastes some address space.
+		hugePages_ = false;
+	}
+#else
+	hugePages_ = false;
+#endif
 
 	// Try a few times in case multiple instances are started near each other.
 	char ram_temp_filename[128]{};
@@ -125,6 +177,11 @@ void *MemArena::CreateView(s64 offset, size_t size, void *base)
 		NOTICE_LOG(MEMMAP, "mmap on %s (fd: %d) failed: %s", ram_temp_file.c_str(), (int)fd, strerror(errno));
 		return 0;
 	}
+#ifdef MADV_HUGEPAGE
+	if (hugePages_ && size >= HUGE_PAGE_SIZE && madvise(retval, size, MADV_HUGEPAGE) != 0) {
+		DEBUG_LOG(MEMMAP, "madvise(MADV_HUGEPAGE) failed: %s", strerror(errno));
+	}
+#endif
 	return retval;
 #endif
 }
@@ -135,6 +192,43 @@ void MemArena::ReleaseView(s64 offset, void* view, size_t size) {
 #endif
 }
 
+bool MemArena::Unshare() {
+#ifndef NO_MMAP
+	int oldFd = fd;
+	// GrabMemSpace() may fall back from huge pages, but the layout from roundup() must not change.
+	bool hugePages = hugePages_;
+	if (!GrabMemSpace(size_)) {
+		fd = oldFd;
+		return false;
+	}
+	hugePages_ = hugePages;
+
+	// Skip writing zero blocks, which keeps the new file as sparse as the old one.
+	const size_t BLOCK_SIZE = 1024 * 1024;
+	std::vector<u8> buffer(BLOCK_SIZE);
+	for (size_t pos = 0; pos < size_; pos += BLOCK_SIZE) {
+		size_t len = std::min(BLOCK_SIZE, size_ - pos);
+		if (pread(oldFd, buffer.data(), len, pos) != (ssize_t)len) {
+			ERROR_LOG(MEMMAP, "Failed to read shared memory at %08x: %s", (int)pos, strerror(errno));
+			close(fd);
+			fd = oldFd;
+			return false;
+		}
+		bool zero = true;
+		for (size_t i = 0; i < len && zero; i += sizeof(u64))
+			zero = *(const u64 *)&buffer[i] == 0;
+		if (!zero && pwrite(fd, buffer.data(), len, pos) != (ssize_t)len) {
+			ERROR_LOG(MEMMAP, "Failed to copy shared memory at %08x: %s", (int)pos, strerror(errno));
+			close(fd);
+			fd = oldFd;
+			return false;
+		}
+	}
+	close(oldFd);
+#endif
+	return true;
+}
+
 u8* MemArena::Find4GBBase() {
 	// Now, create views in high memory where there's plenty of space.
 #if PPSSPP_ARCH(64BIT) && !defined(USE_ASAN)
@@ -61,6 +61,11 @@ void MemArena::ReleaseView(s64 offset, void* view, size_t size) {
 #endif
 }
 
+bool MemArena::Unshare() {
+	// There's no fork() on Windows.
+	return false;
+}
+
 bool MemArena::NeedsProbing() {
 #if PPSSPP_ARCH(32BIT)
 	return true;
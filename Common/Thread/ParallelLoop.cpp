@@ -3,6 +3,7 @@
 
 #include "Common/Thread/ParallelLoop.h"
 #include "Common/CPUDetect.h"
+#include "Common/TimeUtil.h"
 
 class LoopRangeTask : public Task {
 public:
@@ -43,7 +44,7 @@ WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::
 	} else if (range <= minSize) {
 		// Single background task.
 		WaitableCounter *waitableCounter = new WaitableCounter(1);
-		threadMan->EnqueueTaskOnThread(0, new LoopRangeTask(waitableCounter, loop, lower, upper, priority));
+		threadMan->EnqueueTaskOnThread(0, new LoopRangeTask(waitableCounter, loop, lower, upper, priority), true);
 		return waitableCounter;
 	} else {
 		// Split the range between threads. Allow for some fractional bits.
@@ -70,7 +71,7 @@ WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::
 				// Let's do the stragglers on the current thread.
 				break;
 			}
-			threadMan->EnqueueTaskOnThread(i, new LoopRangeTask(waitableCounter, loop, start, end, priority));
+			threadMan->EnqueueTaskOnThread(i, new LoopRangeTask(waitableCounter, loop, start, end, priority), true);
 			counter += delta;
 			if ((counter >> fractionalBits) >= upper) {
 				break;
@@ -88,25 +89,180 @@ WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::
 	}
 }
 
-void ParallelRangeLoop(ThreadManager *threadMan, const std::function<void(int, int)> &loop, int lower, int upper, int minSize, TaskPriority priority) {
-	if (cpu_info.num_cores == 1 || (minSize >= (upper - lower) && upper > lower)) {
-		// "Optimization" for single-core devices, or minSize larger than the range.
-		// No point in adding threading overhead, let's just do it inline (since this is the blocking variant).
-		loop(lower, upper);
+// Latch for the blocking loop. Lives on the caller's stack, so the last Count() must be done
+// with it before the waiter can see it finished - hence done_ is only touched under the lock.
+class LoopLatch {
+public:
+	explicit LoopLatch(int count) : count_(count) {}
+
+	void Count() {
+		if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			std::lock_guard<std::mutex> guard(mutex_);
+			done_ = true;
+			cond_.notify_one();
+		}
+	}
+
+	void Wait() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		cond_.wait(lock, [&] { return done_; });
+	}
+
+private:
+	std::atomic<int> count_;
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	bool done_ = false;
+};
+
+class LoopChunkTask : public Task {
+public:
+	TaskType Type() const override {
+		return TaskType::CPU_COMPUTE;
+	}
+
+	TaskPriority Priority() const override {
+		return priority_;
+	}
+
+	void Run() override {
+		func_(ctx_, lower_, upper_);
+		latch_->Count();
+	}
+
+	void Release() override;
+
+	ParallelLoopFunc func_ = nullptr;
+	void *ctx_ = nullptr;
+	LoopLatch *latch_ = nullptr;
+	int lower_ = 0;
+	int upper_ = 0;
+	TaskPriority priority_ = TaskPriority::NORMAL;
+	bool pooled_ = false;
+};
+
+// Fixed pool, so steady state loops never hit the allocator. Overflow (deeply nested loops) falls back to new.
+static const int LOOP_TASK_POOL_SIZE = 256;
+static LoopChunkTask g_loopTaskPool[LOOP_TASK_POOL_SIZE];
+static LoopChunkTask *g_loopTaskFree[LOOP_TASK_POOL_SIZE];
+static int g_loopTaskFreeCount = -1;
+static std::mutex g_loopTaskPoolLock;
+
+static LoopChunkTask *AllocLoopTask() {
+	{
+		std::lock_guard<std::mutex> guard(g_loopTaskPoolLock);
+		if (g_loopTaskFreeCount < 0) {
+			for (int i = 0; i < LOOP_TASK_POOL_SIZE; i++) {
+				g_loopTaskPool[i].pooled_ = true;
+				g_loopTaskFree[i] = &g_loopTaskPool[i];
+			}
+			g_loopTaskFreeCount = LOOP_TASK_POOL_SIZE;
+		}
+		if (g_loopTaskFreeCount > 0) {
+			return g_loopTaskFree[--g_loopTaskFreeCount];
+		}
+	}
+	return new LoopChunkTask();
+}
+
+void LoopChunkTask::Release() {
+	if (!pooled_) {
+		delete this;
 		return;
 	}
+	std::lock_guard<std::mutex> guard(g_loopTaskPoolLock);
+	g_loopTaskFree[g_loopTaskFreeCount++] = this;
+}
+
+// Loops whose estimated total is below this just run inline, threading would cost more than it saves.
+static const double MIN_PARALLEL_LOOP_NS = 20000.0;
+// With a cost estimate, aim for chunks of roughly this much work. Idle threads steal the extras.
+static const double TARGET_LOOP_CHUNK_NS = 50000.0;
+static const int MAX_LOOP_CHUNKS_PER_THREAD = 4;
+
+// Returns this pool's estimate for the call site, starting over if another pool had the slot.
+static std::atomic<float> *GetLoopCostSlot(ParallelLoopCost *cost, uint32_t managerId) {
+	int slot = managerId % ParallelLoopCost::MAX_MANAGERS;
+	if (cost->managerId[slot].load(std::memory_order_relaxed) != managerId) {
+		cost->nsPerItem[slot].store(0.0f, std::memory_order_relaxed);
+		cost->managerId[slot].store(managerId, std::memory_order_relaxed);
+	}
+	return &cost->nsPerItem[slot];
+}
 
+static void RunLoopChunkTimed(ParallelLoopFunc func, void *ctx, int lower, int upper, std::atomic<float> *nsPerItem) {
+	if (!nsPerItem) {
+		func(ctx, lower, upper);
+		return;
+	}
+	double start = time_now_d();
+	func(ctx, lower, upper);
+	float sample = (float)((time_now_d() - start) * 1e9 / (upper - lower));
+	float prev = nsPerItem->load(std::memory_order_relaxed);
+	// Smooth a bit, since a single chunk can be disturbed by the OS.
+	nsPerItem->store(prev <= 0.0f ? sample : (prev * 3.0f + sample) * 0.25f, std::memory_order_relaxed);
+}
+
+void ParallelRangeLoopImpl(ThreadManager *threadMan, ParallelLoopFunc func, void *ctx, int lower, int upper, int minSize, TaskPriority priority, ParallelLoopCost *cost) {
+	int range = upper - lower;
+	if (range <= 0) {
+		return;
+	}
 	if (minSize < 1) {
 		// There's no obvious value to default to.
 		minSize = 1;
 	}
 
-	WaitableCounter *counter = ParallelRangeLoopWaitable(threadMan, loop, lower, upper, minSize, priority);
-	// TODO: Optimize using minSize. We'll just compute whether there's a remainer, remove it from the call to ParallelRangeLoopWaitable,
-	// and process the remainder right here. If there's no remainer, we'll steal a whole chunk.
-	if (counter) {
-		counter->WaitAndRelease();
+	int numThreads = threadMan->GetNumLooperThreads();
+	if (cpu_info.num_cores == 1 || numThreads <= 1 || minSize >= range) {
+		// "Optimization" for single-core devices, or minSize larger than the range.
+		// No point in adding threading overhead, let's just do it inline (since this is the blocking variant).
+		func(ctx, lower, upper);
+		return;
+	}
+
+	int maxChunks = range / minSize;
+	int numChunks = std::min(numThreads, maxChunks);
+	std::atomic<float> *costSlot = cost ? GetLoopCostSlot(cost, threadMan->GetId()) : nullptr;
+	float nsPerItem = costSlot ? costSlot->load(std::memory_order_relaxed) : 0.0f;
+	if (nsPerItem > 0.0f) {
+		double totalNs = (double)nsPerItem * range;
+		if (totalNs < MIN_PARALLEL_LOOP_NS) {
+			numChunks = 1;
+		} else {
+			int wanted = (int)(totalNs / TARGET_LOOP_CHUNK_NS);
+			numChunks = std::max(2, std::min(wanted, numThreads * MAX_LOOP_CHUNKS_PER_THREAD));
+			numChunks = std::min(numChunks, maxChunks);
+		}
+	}
+
+	if (numChunks <= 1) {
+		// Keep measuring, so that we notice if the loop becomes more expensive.
+		RunLoopChunkTimed(func, ctx, lower, upper, costSlot);
+		return;
+	}
+
+	// The calling thread does the last chunk itself, so only numChunks - 1 go on the pool.
+	LoopLatch latch(numChunks - 1);
+	int64_t delta = ((int64_t)range << 8) / numChunks;
+	int64_t counter = (int64_t)lower << 8;
+	for (int i = 0; i < numChunks - 1; i++) {
+		LoopChunkTask *task = AllocLoopTask();
+		task->func_ = func;
+		task->ctx_ = ctx;
+		task->latch_ = &latch;
+		task->lower_ = (int)(counter >> 8);
+		task->upper_ = (int)((counter + delta) >> 8);
+		task->priority_ = priority;
+		threadMan->EnqueueTaskOnThread(i % numThreads, task, true);
+		counter += delta;
+	}
+
+	int selfLower = (int)(counter >> 8);
+	if (selfLower < upper) {
+		RunLoopChunkTimed(func, ctx, selfLower, upper, costSlot);
 	}
+	latch.Wait();
 }
 
 // NOTE: Supports a max of 2GB.
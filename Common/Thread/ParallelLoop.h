@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <type_traits>
 
 #include "Common/Thread/ThreadManager.h"
 
@@ -38,8 +41,44 @@ struct WaitableCounter : public Waitable {
 // Note that upper bounds are non-inclusive: range is [lower, upper)
 WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::function<void(int, int)> &loop, int lower, int upper, int minSize, TaskPriority priority);
 
+// Measured cost of a parallel loop call site, used to pick chunk sizes. Shared between calls,
+// but kept separately for each ThreadManager (by GetId()) so one pool's timings don't decide for another.
+// Direct mapped, a pool that collides with another just measures again.
+struct ParallelLoopCost {
+	enum { MAX_MANAGERS = 4 };
+	std::atomic<uint32_t> managerId[MAX_MANAGERS]{};
+	std::atomic<float> nsPerItem[MAX_MANAGERS]{};
+};
+
+typedef void (*ParallelLoopFunc)(void *ctx, int lower, int upper);
+
+// Blocking loop without allocations: chunk tasks are pooled, the latch is on the stack, and ctx is only
+// accessed until this returns. Prefer the ParallelRangeLoop template below, which fills in func/ctx.
+// Without a cost (nullptr), the range is just split evenly between the threads.
+void ParallelRangeLoopImpl(ThreadManager *threadMan, ParallelLoopFunc func, void *ctx, int lower, int upper, int minSize, TaskPriority priority, ParallelLoopCost *cost);
+
 // Note that upper bounds are non-inclusive: range is [lower, upper)
-void ParallelRangeLoop(ThreadManager *threadMan, const std::function<void(int, int)> &loop, int lower, int upper, int minSize, TaskPriority priority = TaskPriority::NORMAL);
+// Takes any callable directly (no std::function). Each lambda type is unique to its call site, so it gets its own
+// cost estimate, and loops that turn out to be tiny run inline while expensive ones get split into more chunks.
+// A std::function could come from anywhere, so those don't get an estimate.
+template <typename F>
+void ParallelRangeLoop(ThreadManager *threadMan, F &&loop, int lower, int upper, int minSize, TaskPriority priority = TaskPriority::NORMAL) {
+	typedef typename std::remove_reference<F>::type Func;
+	static ParallelLoopCost cost;
+	const bool sharedType = std::is_same<typename std::remove_cv<Func>::type, std::function<void(int, int)>>::value;
+	ParallelLoopFunc func = [](void *ctx, int l, int h) {
+		(*(Func *)ctx)(l, h);
+	};
+	ParallelRangeLoopImpl(threadMan, func, (void *)std::addressof(loop), lower, upper, minSize, priority, sharedType ? nullptr : &cost);
+}
+
+// Plain functions would all share a single cost estimate, so they don't get one. Prefer lambdas for anything hot.
+inline void ParallelRangeLoop(ThreadManager *threadMan, void (*loop)(int, int), int lower, int upper, int minSize, TaskPriority priority = TaskPriority::NORMAL) {
+	ParallelLoopFunc func = [](void *ctx, int l, int h) {
+		((void (*)(int, int))ctx)(l, h);
+	};
+	ParallelRangeLoopImpl(threadMan, func, (void *)loop, lower, upper, minSize, priority, nullptr);
+}
 
 // Common utilities for large (!) memory copies.
 // Will only fall back to threads if it seems to make sense.
@@ -101,6 +101,17 @@ class Promise {
 		}
 	}
 
+	// Like Poll, but works for any T. If this returns true, BlockUntilReady won't block.
+	bool Ready() {
+		std::lock_guard<std::mutex> guard(readyMutex_);
+		if (!ready_ && rx_->Poll(&data_)) {
+			rx_->Release();
+			rx_ = nullptr;
+			ready_ = true;
+		}
+		return ready_;
+	}
+
 	T BlockUntilReady() {
 		std::lock_guard<std::mutex> guard(readyMutex_);
 		if (ready_) {
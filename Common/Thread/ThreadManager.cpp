@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <algorithm>
 #include <thread>
+#include <chrono>
 #include <deque>
 #include <condition_variable>
 #include <mutex>
@@ -20,8 +21,15 @@
 // * For some tasks, splitting the input values up linearly between the threads
 //   is not fair. However, we ignore that for now.
 
+// * Idle workers steal independent tasks (see EnqueueTaskOnThread) from busy workers of the same type,
+//   so one slow chunk of a parallel loop doesn't hold up the rest. Compute workers spin briefly
+//   before sleeping, since parallel loops tend to come in bursts.
+
 const int MAX_CORES_TO_USE = 16;
 const int MIN_IO_BLOCKING_THREADS = 4;
+const int SPIN_ITERATIONS_BEFORE_SLEEP = 64;
+// After this many steals in a row fail on busy locks, go back to sleeping (with a timeout) instead of spinning.
+const int MAX_FAILED_STEALS_BEFORE_SLEEP = 16;
 static constexpr size_t TASK_PRIORITY_COUNT = (size_t)TaskPriority::COUNT;
 
 struct GlobalThreadContext {
@@ -32,24 +40,34 @@ struct GlobalThreadContext {
 	std::atomic<int> io_queue_size;
 	std::vector<TaskThreadContext *> threads_;
 
+	// Number of tasks waiting in steal_queues, per thread type.
+	std::atomic<int> compute_stealable;
+	std::atomic<int> io_stealable;
+
 	std::atomic<int> roundRobin;
 };
 
 struct TaskThreadContext {
 	std::atomic<int> queue_size;
 	std::deque<Task *> private_queue[TASK_PRIORITY_COUNT];
+	// Tasks that other threads of the same type may take over. Also protected by mutex.
+	std::deque<Task *> steal_queue[TASK_PRIORITY_COUNT];
+	std::atomic<int> steal_queue_size;
 	std::thread thread; // the worker thread
 	std::condition_variable cond; // used to signal new work
 	std::mutex mutex; // protects the local queue.
 	int index;
 	TaskType type;
 	std::atomic<bool> cancelled;
+	std::atomic<bool> sleeping;
 	char name[16];
 };
 
 ThreadManager::ThreadManager() : global_(new GlobalThreadContext()) {
 	global_->compute_queue_size = 0;
 	global_->io_queue_size = 0;
+	global_->compute_stealable = 0;
+	global_->io_stealable = 0;
 	global_->roundRobin = 0;
 }
 
@@ -93,10 +111,15 @@ void ThreadManager::Teardown() {
 			for (Task *task : threadCtx->private_queue[i]) {
 				TeardownTask(task, true);
 			}
+			for (Task *task : threadCtx->steal_queue[i]) {
+				TeardownTask(task, true);
+			}
 		}
 		delete threadCtx;
 	}
 	global_->threads_.clear();
+	global_->compute_stealable = 0;
+	global_->io_stealable = 0;
 
 	if (global_->compute_queue_size > 0 || global_->io_queue_size > 0) {
 		WARN_LOG(SYSTEM, "ThreadManager::Teardown() with tasks still enqueued");
@@ -128,6 +151,73 @@ bool ThreadManager::TeardownTask(Task *task, bool enqueue) {
 	return false;
 }
 
+static std::atomic<int> &StealableCount(GlobalThreadContext *global, TaskType type) {
+	return type == TaskType::CPU_COMPUTE ? global->compute_stealable : global->io_stealable;
+}
+
+// Takes the most important task from the thread's own queues. Must hold thread->mutex.
+static Task *PopLocalTask(GlobalThreadContext *global, TaskThreadContext *thread, size_t maxPriority = TASK_PRIORITY_COUNT) {
+	for (size_t p = 0; p < maxPriority; ++p) {
+		if (!thread->private_queue[p].empty()) {
+			Task *task = thread->private_queue[p].front();
+			thread->private_queue[p].pop_front();
+			return task;
+		}
+		if (!thread->steal_queue[p].empty()) {
+			Task *task = thread->steal_queue[p].front();
+			thread->steal_queue[p].pop_front();
+			thread->steal_queue_size--;
+			StealableCount(global, thread->type)--;
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+// Looks through the other threads of the same type for a task we can take over.
+static Task *StealTask(GlobalThreadContext *global, TaskThreadContext *thread) {
+	if (StealableCount(global, thread->type) == 0)
+		return nullptr;
+
+	const size_t count = global->threads_.size();
+	for (size_t i = 1; i < count; ++i) {
+		TaskThreadContext *victim = global->threads_[(thread->index + i) % count];
+		if (victim->type != thread->type || victim->steal_queue_size == 0)
+			continue;
+
+		// Don't wait around for a busy lock, there might be other victims.
+		std::unique_lock<std::mutex> lock(victim->mutex, std::try_to_lock);
+		if (!lock.owns_lock())
+			continue;
+
+		for (size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+			if (victim->steal_queue[p].empty())
+				continue;
+
+			Task *task = victim->steal_queue[p].front();
+			victim->steal_queue[p].pop_front();
+			victim->steal_queue_size--;
+			victim->queue_size--;
+			StealableCount(global, thread->type)--;
+			// We'll run it, so it's counted as ours now.
+			thread->queue_size++;
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+// Wakes up a sleeping thread of the given type, so it can steal newly queued work.
+static void WakeSleepingThread(GlobalThreadContext *global, TaskType type, const TaskThreadContext *except) {
+	for (TaskThreadContext *thread : global->threads_) {
+		if (thread == except || thread->type != type || !thread->sleeping)
+			continue;
+		std::unique_lock<std::mutex> lock(thread->mutex);
+		thread->cond.notify_one();
+		return;
+	}
+}
+
 static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thread) {
 	if (thread->type == TaskType::CPU_COMPUTE) {
 		snprintf(thread->name, sizeof(thread->name), "PoolWorker %d", thread->index);
@@ -145,6 +235,7 @@ static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thr
 	const auto global_queue_size = [isCompute, &global]() -> int {
 		return isCompute ? global->compute_queue_size.load() : global->io_queue_size.load();
 	};
+	int failedSteals = 0;
 
 	while (!thread->cancelled) {
 		Task *task = nullptr;
@@ -168,11 +259,9 @@ static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thr
 				} else if (thread->queue_size != 0) {
 					// Check the thread, as we prefer a HIGH thread task to a global NORMAL task.
 					std::unique_lock<std::mutex> lock(thread->mutex);
-					if (!thread->private_queue[p].empty()) {
-						task = thread->private_queue[p].front();
-						thread->private_queue[p].pop_front();
+					task = PopLocalTask(global, thread, p + 1);
+					if (task)
 						break;
-					}
 				}
 			}
 		}
@@ -180,24 +269,51 @@ static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thr
 		if (!task) {
 			// We didn't have any global, do we have anything on the thread?
 			std::unique_lock<std::mutex> lock(thread->mutex);
-			for (size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
-				if (thread->private_queue[p].empty())
-					continue;
+			task = PopLocalTask(global, thread);
+		}
 
-				task = thread->private_queue[p].front();
-				thread->private_queue[p].pop_front();
-				break;
+		if (!task) {
+			task = StealTask(global, thread);
+			if (!task && StealableCount(global, thread->type) != 0)
+				failedSteals++;
+		}
+		// Stealable work we keep failing to take shouldn't keep us from sleeping.
+		const bool stealBackoff = failedSteals >= MAX_FAILED_STEALS_BEFORE_SLEEP;
+
+		if (!task && isCompute && !stealBackoff) {
+			// More work is often right around the corner, so avoid the sleep/wake roundtrip for a little while.
+			bool found = false;
+			for (int i = 0; i < SPIN_ITERATIONS_BEFORE_SLEEP && !found && !thread->cancelled; ++i) {
+				found = thread->queue_size != 0 || global_queue_size() != 0 || StealableCount(global, thread->type) != 0;
+				if (!found)
+					std::this_thread::yield();
 			}
+			if (found)
+				continue;
+		}
+
+		if (!task) {
+			std::unique_lock<std::mutex> lock(thread->mutex);
+			task = PopLocalTask(global, thread);
 
-			// We must check both queue and single again, while locked.
+			// We must check all the queues again, while locked. Setting sleeping first makes sure
+			// anyone queueing stealable work after our check will notify us.
+			thread->sleeping = true;
 			bool wait = !thread->cancelled && !task && global_queue_size() == 0;
 
-			if (wait)
+			if (wait && StealableCount(global, thread->type) == 0) {
 				thread->cond.wait(lock);
+			} else if (wait && stealBackoff) {
+				// Nobody will notify us about the stealable tasks already queued, so retry them after a bit.
+				thread->cond.wait_for(lock, std::chrono::milliseconds(1));
+				failedSteals = 0;
+			}
+			thread->sleeping = false;
 		}
 		// The task itself takes care of notifying anyone waiting on it. Not the
 		// responsibility of the ThreadManager (although it could be!).
 		if (task) {
+			failedSteals = 0;
 			task->Run();
 			task->Release();
 			// Reduce the queue size once complete.
@@ -212,12 +328,15 @@ static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thr
 	}
 }
 
-void ThreadManager::Init(int numRealCores, int numLogicalCoresPerCpu) {
+void ThreadManager::Init(int numRealCores, int numLogicalCoresPerCpu, int maxComputeThreads) {
 	if (IsInitialized()) {
 		Teardown();
 	}
 
-	numComputeThreads_ = std::min(numRealCores * numLogicalCoresPerCpu, MAX_CORES_TO_USE);
+	static std::atomic<uint32_t> nextId{ 1 };
+	id_ = nextId++;
+
+	numComputeThreads_ = std::min(numRealCores * numLogicalCoresPerCpu, maxComputeThreads > 0 ? maxComputeThreads : MAX_CORES_TO_USE);
 	// Double it for the IO blocking threads.
 	int numThreads = numComputeThreads_ + std::max(MIN_IO_BLOCKING_THREADS, numComputeThreads_);
 	numThreads_ = numThreads;
@@ -227,6 +346,9 @@ void ThreadManager::Init(int numRealCores, int numLogicalCoresPerCpu) {
 	for (int i = 0; i < numThreads; i++) {
 		TaskThreadContext *thread = new TaskThreadContext();
 		thread->cancelled.store(false);
+		thread->sleeping.store(false);
+		thread->steal_queue_size.store(0);
+		thread->queue_size.store(0);
 		thread->type = i < numComputeThreads_ ? TaskType::CPU_COMPUTE : TaskType::IO_BLOCKING;
 		thread->index = i;
 		thread->thread = std::thread(&WorkerThreadFunc, global_, thread);
@@ -298,18 +420,34 @@ void ThreadManager::EnqueueTask(Task *task) {
 	chosenThread->cond.notify_one();
 }
 
-void ThreadManager::EnqueueTaskOnThread(int threadNum, Task *task) {
+void ThreadManager::EnqueueTaskOnThread(int threadNum, Task *task, bool stealable) {
 	_assert_msg_(task->Type() != TaskType::DEDICATED_THREAD, "Dedicated thread tasks can't be put on specific threads");
 
 	_assert_msg_(threadNum >= 0 && threadNum < (int)global_->threads_.size(), "Bad threadnum or not initialized");
 	TaskThreadContext *thread = global_->threads_[threadNum];
 	size_t queueIndex = (size_t)task->Priority();
+	// Only threads of the task's type can steal it, so there's no point if the target is another type.
+	stealable = stealable && task->Type() == thread->type;
 
+	// If the thread is already busy, someone else might get to it first.
+	bool wakeThief = stealable && thread->queue_size.load() != 0;
 	thread->queue_size++;
 
-	std::unique_lock<std::mutex> lock(thread->mutex);
-	thread->private_queue[queueIndex].push_back(task);
-	thread->cond.notify_one();
+	{
+		std::unique_lock<std::mutex> lock(thread->mutex);
+		if (stealable) {
+			thread->steal_queue[queueIndex].push_back(task);
+			thread->steal_queue_size++;
+			StealableCount(global_, thread->type)++;
+		} else {
+			thread->private_queue[queueIndex].push_back(task);
+		}
+		thread->cond.notify_one();
+	}
+
+	if (wakeThief) {
+		WakeSleepingThread(global_, thread->type, thread);
+	}
 }
 
 int ThreadManager::GetNumLooperThreads() const {
@@ -55,10 +55,12 @@ class ThreadManager {
 	// The distinction here is to be able to take hyper-threading into account.
 	// It gets even trickier when you think about mobile chips with BIG/LITTLE, but we'll
 	// just ignore it and let the OS handle it.
-	void Init(int numCores, int numLogicalCoresPerCpu);
+	// maxComputeThreads overrides the usual cap on compute threads (0 keeps it), mainly for benchmarking big pools.
+	void Init(int numCores, int numLogicalCoresPerCpu, int maxComputeThreads = 0);
 	void EnqueueTask(Task *task);
-	// Use enforceSequence if this must run after all previously queued tasks.
-	void EnqueueTaskOnThread(int threadNum, Task *task);
+	// Tasks queued on a thread run in order on that thread, unless stealable is set, in which case
+	// an idle thread of the same type may take it over. Use that for independent chunks of work.
+	void EnqueueTaskOnThread(int threadNum, Task *task, bool stealable = false);
 	void Teardown();
 
 	bool IsInitialized() const;
@@ -72,6 +74,12 @@ class ThreadManager {
 	// for I/O bounds tasks, that can be run concurrently with those.
 	int GetNumLooperThreads() const;
 
+	// Unique for each Init(), so per-pool state kept elsewhere (like parallel loop cost estimates)
+	// doesn't carry over to a different pool at the same address. 0 before Init().
+	uint32_t GetId() const {
+		return id_;
+	}
+
 private:
 	bool TeardownTask(Task *task, bool enqueue);
 
@@ -80,6 +88,7 @@ class ThreadManager {
 
 	int numThreads_ = 0;
 	int numComputeThreads_ = 0;
+	uint32_t id_ = 0;
 
 	friend struct TaskThreadContext;
 };
@@ -1,16 +1,22 @@
 #include <algorithm>
+#include <cstdlib>
+
+#include "ext/xxhash.h"
 
 #include "Common/UI/IconCache.h"
 #include "Common/UI/Context.h"
 #include "Common/TimeUtil.h"
 #include "Common/Data/Format/PNGLoad.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Common/Log.h"
 
-#define ICON_CACHE_VERSION 1
+#define ICON_CACHE_VERSION 2
 #define MK_FOURCC(str) (str[0] | ((uint8_t)str[1] << 8) | ((uint8_t)str[2] << 16) | ((uint8_t)str[3] << 24))
 
 #define MAX_RUNTIME_CACHE_SIZE (1024 * 1024 * 4)
 #define MAX_SAVED_CACHE_SIZE (1024 * 1024 * 1)
+// Decoded icons are uncompressed RGBA, so cap how many we keep around as textures.
+#define MAX_TEXTURE_MEMORY (1024 * 1024 * 32)
 
 const uint32_t ICON_CACHE_MAGIC = MK_FOURCC("pICN");
 
@@ -19,16 +25,73 @@ IconCache g_iconCache;
 struct DiskCacheHeader {
 	uint32_t magic;
 	uint32_t version;
+	uint32_t blobCount;
 	uint32_t entryCount;
 };
 
-struct DiskCacheEntry {
-	uint32_t keyLen;
+// Each distinct image is only stored once, the entries refer to them by content hash.
+struct DiskCacheBlob {
+	uint64_t hash;
 	uint32_t dataLen;
 	IconFormat format;
+};
+
+struct DiskCacheEntry {
+	uint64_t hash;
+	uint32_t keyLen;
+	uint32_t padding;
 	double insertedTimestamp;
 };
 
+class IconDecodeTask : public Task {
+public:
+	IconDecodeTask(IconCache *cache, uint64_t hash, IconFormat format, const std::string &data)
+		: cache_(cache), hash_(hash), format_(format), data_(data) {}
+
+	TaskType Type() const override { return TaskType::CPU_COMPUTE; }
+	TaskPriority Priority() const override { return TaskPriority::NORMAL; }
+
+	void Run() override {
+		int width = 0;
+		int height = 0;
+		unsigned char *buffer = nullptr;
+
+		switch (format_) {
+		case IconFormat::PNG:
+		{
+			int result = pngLoadPtr((const unsigned char *)data_.data(), data_.size(), &width, &height, &buffer);
+			if (result != 1) {
+				ERROR_LOG(G3D, "IconCache: Failed to load png (%d bytes)", (int)data_.size());
+				free(buffer);
+				buffer = nullptr;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		cache_->FinishDecode(hash_, buffer, width, height);
+	}
+
+private:
+	IconCache *cache_;
+	uint64_t hash_;
+	IconFormat format_;
+	std::string data_;
+};
+
+static uint64_t HashIconData(const std::string &data) {
+	return XXH3_64bits(data.data(), data.size());
+}
+
+IconCache::~IconCache() {
+	// Textures are owned by the draw context, which is gone by now.
+	for (auto &iter : blobs_) {
+		free(iter.second.pixels);
+	}
+}
+
 void IconCache::SaveToFile(FILE *file) {
 	std::unique_lock<std::mutex> lock(lock_);
 
@@ -38,19 +101,27 @@ void IconCache::SaveToFile(FILE *file) {
 	DiskCacheHeader header;
 	header.magic = ICON_CACHE_MAGIC;
 	header.version = ICON_CACHE_VERSION;
+	header.blobCount = (uint32_t)blobs_.size();
 	header.entryCount = (uint32_t)cache_.size();
 
 	fwrite(&header, 1, sizeof(header), file);
 
+	for (auto &iter : blobs_) {
+		DiskCacheBlob blobHeader{};
+		blobHeader.hash = iter.first;
+		blobHeader.dataLen = (uint32_t)iter.second.data.size();
+		blobHeader.format = iter.second.format;
+		fwrite(&blobHeader, 1, sizeof(blobHeader), file);
+		fwrite(iter.second.data.data(), 1, iter.second.data.size(), file);
+	}
+
 	for (auto &iter : cache_) {
-		DiskCacheEntry entryHeader;
+		DiskCacheEntry entryHeader{};
+		entryHeader.hash = iter.second.hash;
 		entryHeader.keyLen = (uint32_t)iter.first.size();
-		entryHeader.dataLen = (uint32_t)iter.second.data.size();
-		entryHeader.format = iter.second.format;
 		entryHeader.insertedTimestamp = iter.second.insertedTimeStamp;
 		fwrite(&entryHeader, 1, sizeof(entryHeader), file);
 		fwrite(iter.first.c_str(), 1, iter.first.size(), file);
-		fwrite(iter.second.data.data(), 1, iter.second.data.size(), file);
 	}
 }
 
@@ -67,42 +138,58 @@ bool IconCache::LoadFromFile(FILE *file) {
 
 	double now = time_now_d();
 
+	// Blobs are only kept if an entry refers to them, so stash them here first.
+	std::map<uint64_t, std::pair<IconFormat, std::string>> loadedBlobs;
+	for (uint32_t i = 0; i < header.blobCount; i++) {
+		DiskCacheBlob blobHeader;
+		if (fread(&blobHeader, 1, sizeof(blobHeader), file) != sizeof(blobHeader)) {
+			return false;
+		}
+		if (blobHeader.dataLen > MAX_RUNTIME_CACHE_SIZE) {
+			// Probably a corrupted file.
+			return false;
+		}
+
+		std::string data;
+		data.resize(blobHeader.dataLen);
+		size_t len = fread(&data[0], 1, blobHeader.dataLen, file);
+		if (len != (size_t)blobHeader.dataLen) {
+			// Truncated file. The entries come after the blobs, so there's nothing more to recover.
+			return false;
+		}
+		loadedBlobs[blobHeader.hash] = std::make_pair(blobHeader.format, std::move(data));
+	}
+
 	for (uint32_t i = 0; i < header.entryCount; i++) {
 		DiskCacheEntry entryHeader;
 		if (fread(&entryHeader, 1, sizeof(entryHeader), file) != sizeof(entryHeader)) {
 			break;
 		}
 
-		std::string key;
-		key.resize(entryHeader.keyLen, 0);
 		if (entryHeader.keyLen > 0x1000) {
 			// Let's say this is invalid, probably a corrupted file.
 			break;
 		}
 
-		fread(&key[0], 1, entryHeader.keyLen, file);
+		std::string key;
+		key.resize(entryHeader.keyLen, 0);
+		if (fread(&key[0], 1, entryHeader.keyLen, file) != entryHeader.keyLen) {
+			break;
+		}
 
 		// Check if we already have the entry somehow.
 		if (cache_.find(key) != cache_.end()) {
-			// Seek past the data and go to the next entry.
-			fseek(file, entryHeader.dataLen, SEEK_CUR);
 			continue;
 		}
 
-		std::string data;
-		data.resize(entryHeader.dataLen);
-		size_t len = fread(&data[0], 1, entryHeader.dataLen, file);
-		if (len != (size_t)entryHeader.dataLen) {
-			// Stop reading and don't use this entry. Seems the file is truncated, but we'll recover.
-			break;
+		auto blobIter = loadedBlobs.find(entryHeader.hash);
+		if (blobIter == loadedBlobs.end()) {
+			continue;
 		}
 
-		Entry entry{};
-		entry.data = data;
-		entry.format = entryHeader.format;
-		entry.insertedTimeStamp = entryHeader.insertedTimestamp;
-		entry.usedTimeStamp = now;
-		cache_.insert(std::pair<std::string, Entry>(key, entry));
+		// AddEntry only consumes the data if the blob isn't already present, so copy it.
+		std::string data = blobIter->second.second;
+		AddEntry(key, entryHeader.hash, blobIter->second.first, std::move(data), entryHeader.insertedTimestamp, now);
 	}
 
 	return true;
@@ -110,7 +197,7 @@ bool IconCache::LoadFromFile(FILE *file) {
 
 void IconCache::ClearTextures() {
 	std::unique_lock<std::mutex> lock(lock_);
-	for (auto &iter : cache_) {
+	for (auto &iter : blobs_) {
 		if (iter.second.texture) {
 			iter.second.texture->Release();
 			iter.second.texture = nullptr;
@@ -121,6 +208,10 @@ void IconCache::ClearTextures() {
 void IconCache::ClearData() {
 	ClearTextures();
 	std::unique_lock<std::mutex> lock(lock_);
+	for (auto &iter : blobs_) {
+		free(iter.second.pixels);
+	}
+	blobs_.clear();
 	cache_.clear();
 }
 
@@ -129,7 +220,7 @@ void IconCache::FrameUpdate() {
 	// Remove old textures after a while.
 	double now = time_now_d();
 	if (now > lastUpdate_ + 2.0) {
-		for (auto &iter : cache_) {
+		for (auto &iter : blobs_) {
 			double useAge = now - iter.second.usedTimeStamp;
 			if (useAge > 5.0) {
 				// Release the texture after a few seconds of no use.
@@ -140,6 +231,7 @@ void IconCache::FrameUpdate() {
 				}
 			}
 		}
+		DecimateTextures(MAX_TEXTURE_MEMORY);
 		lastUpdate_ = now;
 	}
 
@@ -149,11 +241,35 @@ void IconCache::FrameUpdate() {
 	}
 }
 
+void IconCache::AddEntry(const std::string &key, uint64_t hash, IconFormat format, std::string &&data, double insertedTime, double usedTime) {
+	// Call this under the lock.
+	auto blobIter = blobs_.find(hash);
+	if (blobIter == blobs_.end()) {
+		blobIter = blobs_.emplace(hash, Blob{ std::move(data), format, nullptr, nullptr, 0, 0, 0, usedTime, false, false }).first;
+	}
+	blobIter->second.refCount++;
+	cache_.emplace(key, Entry{ hash, insertedTime, usedTime });
+}
+
+void IconCache::RemoveEntry(std::map<std::string, Entry>::iterator iter) {
+	// Call this under the lock.
+	auto blobIter = blobs_.find(iter->second.hash);
+	if (blobIter != blobs_.end() && --blobIter->second.refCount <= 0) {
+		if (blobIter->second.texture) {
+			blobIter->second.texture->Release();
+		}
+		free(blobIter->second.pixels);
+		// If it's still decoding, FinishDecode will notice that the blob is gone.
+		blobs_.erase(blobIter);
+	}
+	cache_.erase(iter);
+}
+
 void IconCache::Decimate(int64_t maxSize) {
 	// Call this under the lock.
 
 	int64_t totalSize = 0;
-	for (auto &iter : cache_) {
+	for (auto &iter : blobs_) {
 		totalSize += iter.second.data.size();
 	}
 
@@ -162,35 +278,86 @@ void IconCache::Decimate(int64_t maxSize) {
 	}
 
 	// Create a list of all the entries, sort by date. Then delete until we reach the desired size.
+	// Deduplicated data is only freed once the last entry referring to it is gone.
 	struct SortEntry {
 		std::string key;
 		double usedTimestamp;
-		size_t size;
 	};
 
 	std::vector<SortEntry> sortEntries;
-	for (auto iter : cache_) {
-		sortEntries.push_back({ iter.first, iter.second.usedTimeStamp, iter.second.data.size() });
+	sortEntries.reserve(cache_.size());
+	for (auto &iter : cache_) {
+		sortEntries.push_back({ iter.first, iter.second.usedTimeStamp });
 	}
 
 	std::sort(sortEntries.begin(), sortEntries.end(), [](const SortEntry &a, const SortEntry &b) {
-		// Oldest should be last in the lsit.
+		// Oldest should be last in the list.
 		return a.usedTimestamp > b.usedTimestamp;
 	});
 
 	while (totalSize > maxSize && !sortEntries.empty()) {
-		totalSize -= sortEntries.back().size;
 		auto iter = cache_.find(sortEntries.back().key);
 		if (iter != cache_.end()) {
-			if (iter->second.texture) {
-				iter->second.texture->Release();
+			auto blobIter = blobs_.find(iter->second.hash);
+			if (blobIter != blobs_.end() && blobIter->second.refCount == 1) {
+				totalSize -= blobIter->second.data.size();
 			}
-			cache_.erase(iter);
+			RemoveEntry(iter);
 		}
 		sortEntries.pop_back();
 	}
 }
 
+void IconCache::DecimateTextures(int64_t maxSize) {
+	// Call this under the lock.
+
+	int64_t totalSize = 0;
+	std::vector<std::pair<double, uint64_t>> textures;
+	for (auto &iter : blobs_) {
+		if (iter.second.texture) {
+			totalSize += (int64_t)iter.second.width * iter.second.height * 4;
+			textures.emplace_back(iter.second.usedTimeStamp, iter.first);
+		}
+	}
+
+	if (totalSize <= maxSize) {
+		return;
+	}
+
+	// Release the least recently used textures first. The image data stays, so they can be re-decoded.
+	std::sort(textures.begin(), textures.end());
+	for (auto &tex : textures) {
+		if (totalSize <= maxSize) {
+			break;
+		}
+		Blob &blob = blobs_[tex.second];
+		blob.texture->Release();
+		blob.texture = nullptr;
+		totalSize -= (int64_t)blob.width * blob.height * 4;
+	}
+}
+
+void IconCache::FinishDecode(uint64_t hash, uint8_t *pixels, int width, int height) {
+	std::unique_lock<std::mutex> lock(lock_);
+	auto iter = blobs_.find(hash);
+	if (iter == blobs_.end()) {
+		// Got removed while we were decoding.
+		free(pixels);
+		return;
+	}
+
+	Blob &blob = iter->second;
+	blob.decoding = false;
+	if (!pixels) {
+		blob.badData = true;
+		return;
+	}
+	free(blob.pixels);
+	blob.pixels = pixels;
+	blob.width = width;
+	blob.height = height;
+}
+
 bool IconCache::GetDimensions(const std::string &key, int *width, int *height) {
 	std::unique_lock<std::mutex> lock(lock_);
 	auto iter = cache_.find(key);
@@ -199,14 +366,15 @@ bool IconCache::GetDimensions(const std::string &key, int *width, int *height) {
 		return false;
 	}
 
-	if (iter->second.texture) {
-		// TODO: Store the width/height in the cache.
-		*width = iter->second.texture->Width();
-		*height = iter->second.texture->Height();
-		return true;
-	} else {
+	auto blobIter = blobs_.find(iter->second.hash);
+	if (blobIter == blobs_.end() || blobIter->second.width == 0) {
+		// Not decoded yet.
 		return false;
 	}
+
+	*width = blobIter->second.width;
+	*height = blobIter->second.height;
+	return true;
 }
 
 bool IconCache::Contains(const std::string &key) {
@@ -232,8 +400,6 @@ void IconCache::Cancel(const std::string &key) {
 }
 
 bool IconCache::InsertIcon(const std::string &key, IconFormat format, std::string &&data) {
-	std::unique_lock<std::mutex> lock(lock_);
-
 	if (key.empty()) {
 		return false;
 	}
@@ -244,6 +410,11 @@ bool IconCache::InsertIcon(const std::string &key, IconFormat format, std::strin
 		return false;
 	}
 
+	// Hash outside the lock, it's the most expensive part.
+	uint64_t hash = HashIconData(data);
+
+	std::unique_lock<std::mutex> lock(lock_);
+
 	if (cache_.find(key) != cache_.end()) {
 		// Already have this entry.
 		return false;
@@ -256,7 +427,7 @@ bool IconCache::InsertIcon(const std::string &key, IconFormat format, std::strin
 	pending_.erase(key);
 
 	double now = time_now_d();
-	cache_.emplace(key, Entry{ std::move(data), format, nullptr, now, now, false });
+	AddEntry(key, hash, format, std::move(data), now, now);
 	return true;
 }
 
@@ -268,57 +439,56 @@ Draw::Texture *IconCache::BindIconTexture(UIContext *context, const std::string
 		return nullptr;
 	}
 
-	if (iter->second.texture) {
-		context->GetDrawContext()->BindTexture(0, iter->second.texture);
-		iter->second.usedTimeStamp = time_now_d();
-		return iter->second.texture;
-	}
-
-	if (iter->second.badData) {
+	auto blobIter = blobs_.find(iter->second.hash);
+	if (blobIter == blobs_.end()) {
 		return nullptr;
 	}
 
-	// OK, don't have a texture. Upload it!
-	int width = 0;
-	int height = 0;
-	Draw::DataFormat dataFormat;
-	unsigned char *buffer = nullptr;
+	double now = time_now_d();
+	Blob &blob = blobIter->second;
+	iter->second.usedTimeStamp = now;
+	blob.usedTimeStamp = now;
 
-	switch (iter->second.format) {
-	case IconFormat::PNG:
-	{
-		int result = pngLoadPtr((const unsigned char *)iter->second.data.data(), iter->second.data.size(), &width,
-			&height, &buffer);
+	if (blob.texture) {
+		context->GetDrawContext()->BindTexture(0, blob.texture);
+		return blob.texture;
+	}
 
-		if (result != 1) {
-			ERROR_LOG(G3D, "IconCache: Failed to load png (%d bytes) for key %s", (int)iter->second.data.size(), key.c_str());
-			iter->second.badData = true;
-			return nullptr;
-		}
-		dataFormat = Draw::DataFormat::R8G8B8A8_UNORM;
-		break;
+	if (blob.badData) {
+		return nullptr;
 	}
-	default:
+
+	if (!blob.pixels) {
+		// Kick off a decode on a worker thread, and upload when it's done.
+		if (!blob.decoding) {
+			blob.decoding = true;
+			g_threadManager.EnqueueTask(new IconDecodeTask(this, blobIter->first, blob.format, blob.data));
+		}
 		return nullptr;
 	}
 
+	// OK, got decoded pixels but no texture. Upload it!
 	Draw::TextureDesc iconDesc{};
-	iconDesc.width = width;
-	iconDesc.height = height;
+	iconDesc.width = blob.width;
+	iconDesc.height = blob.height;
 	iconDesc.depth = 1;
-	iconDesc.initData.push_back((const uint8_t *)buffer);
+	iconDesc.initData.push_back((const uint8_t *)blob.pixels);
 	iconDesc.mipLevels = 1;
 	iconDesc.swizzle = Draw::TextureSwizzle::DEFAULT;
 	iconDesc.generateMips = false;
 	iconDesc.tag = key.c_str();
-	iconDesc.format = dataFormat;
+	iconDesc.format = Draw::DataFormat::R8G8B8A8_UNORM;
 	iconDesc.type = Draw::TextureType::LINEAR2D;
 
 	Draw::Texture *texture = context->GetDrawContext()->CreateTexture(iconDesc);
-	iter->second.texture = texture;
-	iter->second.usedTimeStamp = time_now_d();
+	blob.texture = texture;
+	if (texture) {
+		context->GetDrawContext()->BindTexture(0, texture);
+	}
 
-	free(buffer);
+	// The decoded pixels are not needed anymore, we'll decode again if the texture gets released.
+	free(blob.pixels);
+	blob.pixels = nullptr;
 
 	return texture;
 }
@@ -328,10 +498,13 @@ IconCacheStats IconCache::GetStats() {
 
 	std::unique_lock<std::mutex> lock(lock_);
 
-	for (auto &iter : cache_) {
-		stats.cachedCount++;
-		if (iter.second.texture)
+	stats.cachedCount = cache_.size();
+	for (auto &iter : blobs_) {
+		stats.uniqueCount++;
+		if (iter.second.texture) {
 			stats.textureCount++;
+			stats.textureSize += (size_t)iter.second.width * iter.second.height * 4;
+		}
 		stats.dataSize += iter.second.data.size();
 	}
 
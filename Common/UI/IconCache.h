@@ -26,12 +26,18 @@ struct IconCacheStats {
 	size_t textureCount;  // number of cached images that are "live" textures
 	size_t pending;
 	size_t dataSize;
+	size_t uniqueCount;  // number of distinct images after deduplication by content hash
+	size_t textureSize;  // estimated memory used by live textures
 };
 
 class IconCache {
 public:
+	~IconCache();
+
 	// NOTE: Don't store the returned texture. Only use it to look up dimensions or other properties,
 	// instead call BindIconTexture every time you want to use it.
+	// Decoding happens on a worker thread, so this can return nullptr for a few frames after an icon
+	// first becomes visible.
 	Draw::Texture *BindIconTexture(UIContext *context, const std::string &key);
 
 	// It's okay to call these from any thread.
@@ -52,24 +58,42 @@ class IconCache {
 	IconCacheStats GetStats();
 
 private:
-	void Decimate(int64_t maxSize);
-
-	struct Entry {
+	// Image data, shared between all keys that have identical contents.
+	struct Blob {
 		std::string data;
 		IconFormat format;
 		Draw::Texture *texture;
-		double insertedTimeStamp;
+		uint8_t *pixels;  // Decoded RGBA8888, waiting to be uploaded. malloc-allocated.
+		int width;
+		int height;
+		int refCount;
 		double usedTimeStamp;
+		bool decoding;
 		bool badData;
 	};
 
+	struct Entry {
+		uint64_t hash;
+		double insertedTimeStamp;
+		double usedTimeStamp;
+	};
+
+	void Decimate(int64_t maxSize);
+	void DecimateTextures(int64_t maxSize);
+	void AddEntry(const std::string &key, uint64_t hash, IconFormat format, std::string &&data, double insertedTime, double usedTime);
+	void RemoveEntry(std::map<std::string, Entry>::iterator iter);
+	void FinishDecode(uint64_t hash, uint8_t *pixels, int width, int height);
+
 	std::map<std::string, Entry> cache_;
+	std::map<uint64_t, Blob> blobs_;
 	std::set<std::string> pending_;
 
 	std::mutex lock_;
 
 	double lastUpdate_ = 0.0;
 	double lastDecimate_ = 0.0;
+
+	friend class IconDecodeTask;
 };
 
 extern IconCache g_iconCache;
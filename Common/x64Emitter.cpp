@@ -191,36 +191,9 @@ void XEmitter::WriteSIB(int scale, int index, int base)
 
 void OpArg::WriteRex(XEmitter *emit, int opBits, int bits, int customOp) const
 {
-	if (customOp == -1)       customOp = operandReg;
-#if PPSSPP_ARCH(AMD64)
-	u8 op = 0x40;
-	// REX.W (whether operation is a 64-bit operation)
-	if (opBits == 64)         op |= 8;
-	// REX.R (whether ModR/M reg field refers to R8-R15.
-	if (customOp & 8)         op |= 4;
-	// REX.X (whether ModR/M SIB index field refers to R8-R15)
-	if (indexReg & 8)         op |= 2;
-	// REX.B (whether ModR/M rm or SIB base or opcode reg field refers to R8-R15)
-	if (offsetOrBaseReg & 8)  op |= 1;
-	// Write REX if wr have REX bits to write, or if the operation accesses
-	// SIL, DIL, BPL, or SPL.
-	if (op != 0x40 ||
-	    (scale == SCALE_NONE && bits == 8 && (offsetOrBaseReg & 0x10c) == 4) ||
-	    (opBits == 8 && (customOp & 0x10c) == 4))
-	{
-		emit->Write8(op);
-		// Check the operation doesn't access AH, BH, CH, or DH.
-		_dbg_assert_((offsetOrBaseReg & 0x100) == 0);
-		_dbg_assert_((customOp & 0x100) == 0);
-	}
-#else
-	_dbg_assert_(opBits != 64);
-	_dbg_assert_((customOp & 8) == 0 || customOp == -1);
-	_dbg_assert_((indexReg & 8) == 0);
-	_dbg_assert_((offsetOrBaseReg & 8) == 0);
-	_dbg_assert_(opBits != 8 || (customOp & 0x10c) != 4 || customOp == -1);
-	_dbg_assert_(scale == SCALE_ATREG || bits != 8 || (offsetOrBaseReg & 0x10c) != 4);
-#endif
+	u8 rex = RexPrefix(opBits, bits, customOp);
+	if (rex != 0)
+		emit->Write8(rex);
 }
 
 void OpArg::WriteVex(XEmitter* emit, X64Reg regOp1, X64Reg regOp2, int L, int pp, int mmmmm, int W) const
@@ -250,6 +223,11 @@ void OpArg::WriteVex(XEmitter* emit, X64Reg regOp1, X64Reg regOp2, int L, int pp
 
 void OpArg::WriteRest(XEmitter *emit, int extraBytes, X64Reg _operandReg,
 	bool warn_64bit_offset) const
+{
+	emit->code = EncodeRest(emit->code, extraBytes, _operandReg, warn_64bit_offset);
+}
+
+u8 *OpArg::EncodeMemRest(u8 *out, int extraBytes, X64Reg _operandReg, bool warn_64bit_offset) const
 {
 	if (_operandReg == INVALID_REG)
 		_operandReg = (X64Reg)this->operandReg;
@@ -261,11 +239,10 @@ void OpArg::WriteRest(XEmitter *emit, int extraBytes, X64Reg _operandReg,
 	if (scale == SCALE_RIP) //Also, on 32-bit, just an immediate address
 	{
 		// Oh, RIP addressing.
-		_offsetOrBaseReg = 5;
-		emit->WriteModRM(0, _operandReg, _offsetOrBaseReg);
+		*out++ = (u8)(((_operandReg & 7) << 3) | 5);
 		//TODO : add some checks
 #if PPSSPP_ARCH(AMD64)
-		u64 ripAddr = (u64)emit->GetCodePointer() + 4 + extraBytes;
+		u64 ripAddr = (u64)out + 4 + extraBytes;
 		s64 distance = (s64)offset - (s64)ripAddr;
 		_assert_msg_(
 		             (distance < 0x80000000LL &&
@@ -273,12 +250,12 @@ void OpArg::WriteRest(XEmitter *emit, int extraBytes, X64Reg _operandReg,
 		             !warn_64bit_offset,
 		             "WriteRest: op out of range (0x%" PRIx64 " uses 0x%" PRIx64 ")",
 		             ripAddr, offset);
-		s32 offs = (s32)distance;
-		emit->Write32((u32)offs);
+		u32 disp = (u32)(s32)distance;
 #else
-		emit->Write32((u32)offset);
+		u32 disp = (u32)offset;
 #endif
-		return;
+		std::memcpy(out, &disp, sizeof(disp));
+		return out + 4;
 	}
 
 	if (scale == 0)
@@ -355,7 +332,7 @@ void OpArg::WriteRest(XEmitter *emit, int extraBytes, X64Reg _operandReg,
 	//if (RIP)
 	//    oreg = 5;
 
-	emit->WriteModRM(mod, _operandReg&7, oreg&7);
+	*out++ = (u8)((mod << 6) | ((_operandReg & 7) << 3) | (oreg & 7));
 
 	if (SIB)
 	{
@@ -374,17 +351,20 @@ void OpArg::WriteRest(XEmitter *emit, int extraBytes, X64Reg _operandReg,
 		case SCALE_ATREG: ss = 0; break;
 		default: _assert_msg_(false, "Invalid scale for SIB byte"); ss = 0; break;
 		}
-		emit->Write8((u8)((ss << 6) | ((ireg&7)<<3) | (_offsetOrBaseReg&7)));
+		*out++ = (u8)((ss << 6) | ((ireg&7)<<3) | (_offsetOrBaseReg&7));
 	}
 
 	if (mod == 1) //8-bit disp
 	{
-		emit->Write8((u8)(s8)(s32)offset);
+		*out++ = (u8)(s8)(s32)offset;
 	}
 	else if (mod == 2 || (scale >= SCALE_NOBASE_2 && scale <= SCALE_NOBASE_8)) //32-bit disp
 	{
-		emit->Write32((u32)offset);
+		u32 disp = (u32)offset;
+		std::memcpy(out, &disp, sizeof(disp));
+		out += 4;
 	}
+	return out;
 }
 
 // W = operand extended width (1 if 64-bit)
@@ -971,11 +951,14 @@ void XEmitter::LEA(int bits, X64Reg dest, OpArg src)
 {
 	_assert_msg_(!src.IsImm(), "LEA - Imm argument");
 	src.operandReg = (u8)dest;
+	u8 *out = code;
 	if (bits == 16)
-		Write8(0x66); //TODO: performance warning
-	src.WriteRex(this, bits, bits);
-	Write8(0x8D);
-	src.WriteRest(this, 0, INVALID_REG, bits == 64);
+		*out++ = 0x66; //TODO: performance warning
+	u8 rex = src.RexPrefix(bits, bits);
+	if (rex != 0)
+		*out++ = rex;
+	*out++ = 0x8D;
+	code = src.EncodeRest(out, 0, INVALID_REG, bits == 64);
 }
 
 //shift can be either imm8 or cl
@@ -992,30 +975,34 @@ void XEmitter::WriteShift(int bits, OpArg dest, OpArg &shift, int ext)
 		_assert_msg_(false, "WriteShift - illegal argument");
 	}
 	dest.operandReg = ext;
+	u8 *out = code;
 	if (bits == 16)
-		Write8(0x66);
-	dest.WriteRex(this, bits, bits, 0);
+		*out++ = 0x66;
+	u8 rex = dest.RexPrefix(bits, bits, 0);
+	if (rex != 0)
+		*out++ = rex;
 	if (shift.GetImmBits() == 8)
 	{
 		//ok an imm
 		u8 imm = (u8)shift.offset;
 		if (imm == 1)
 		{
-			Write8(bits == 8 ? 0xD0 : 0xD1);
+			*out++ = bits == 8 ? 0xD0 : 0xD1;
 		}
 		else
 		{
 			writeImm = true;
-			Write8(bits == 8 ? 0xC0 : 0xC1);
+			*out++ = bits == 8 ? 0xC0 : 0xC1;
 		}
 	}
 	else
 	{
-		Write8(bits == 8 ? 0xD2 : 0xD3);
+		*out++ = bits == 8 ? 0xD2 : 0xD3;
 	}
-	dest.WriteRest(this, writeImm ? 1 : 0);
+	out = dest.EncodeRest(out, writeImm ? 1 : 0, INVALID_REG);
 	if (writeImm)
-		Write8((u8)shift.offset);
+		*out++ = (u8)shift.offset;
+	code = out;
 }
 
 // large rotates and shift are slower on intel than amd
@@ -1139,6 +1126,13 @@ void OpArg::WriteSingleByteOp(XEmitter *emit, u8 op, X64Reg _operandReg, int bit
 	WriteRest(emit);
 }
 
+template <typename T>
+static inline u8 *PutImm(u8 *out, T value)
+{
+	std::memcpy(out, &value, sizeof(T));
+	return out + sizeof(T);
+}
+
 //operand can either be immediate or register
 void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &operand, int bits) const
 {
@@ -1148,14 +1142,18 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 		_assert_msg_(false, "WriteNormalOp - Imm argument, wrong order");
 	}
 
+	// Encoded through a local pointer, and only stored back to the emitter once at the end.
+	u8 *out = emit->code;
 	if (bits == 16)
-		emit->Write8(0x66);
+		*out++ = 0x66;
 
 	int immToWrite = 0;
 
 	if (operand.IsImm())
 	{
-		WriteRex(emit, bits, bits);
+		u8 rex = RexPrefix(bits, bits);
+		if (rex != 0)
+			*out++ = rex;
 
 		if (!toRM)
 		{
@@ -1167,19 +1165,21 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 			// op al, imm8
 			if (!scale && offsetOrBaseReg == AL && normalops[op].eaximm8 != 0xCC)
 			{
-				emit->Write8(normalops[op].eaximm8);
-				emit->Write8((u8)operand.offset);
+				*out++ = normalops[op].eaximm8;
+				*out++ = (u8)operand.offset;
+				emit->code = out;
 				return;
 			}
 			// mov reg, imm8
 			if (!scale && op == nrmMOV)
 			{
-				emit->Write8(0xB0 + (offsetOrBaseReg & 7));
-				emit->Write8((u8)operand.offset);
+				*out++ = (u8)(0xB0 + (offsetOrBaseReg & 7));
+				*out++ = (u8)operand.offset;
+				emit->code = out;
 				return;
 			}
 			// op r/m8, imm8
-			emit->Write8(normalops[op].imm8);
+			*out++ = normalops[op].imm8;
 			immToWrite = 8;
 		}
 		else if ((operand.scale == SCALE_IMM16 && bits == 16) ||
@@ -1193,7 +1193,7 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 			    ((operand.scale == SCALE_IMM16 && (s16)operand.offset == (s8)operand.offset) ||
 			     (operand.scale == SCALE_IMM32 && (s32)operand.offset == (s8)operand.offset)))
 			{
-				emit->Write8(normalops[op].simm8);
+				*out++ = normalops[op].simm8;
 				immToWrite = 8;
 			}
 			else
@@ -1201,25 +1201,27 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 				// mov reg, imm
 				if (!scale && op == nrmMOV && bits != 64)
 				{
-					emit->Write8(0xB8 + (offsetOrBaseReg & 7));
+					*out++ = (u8)(0xB8 + (offsetOrBaseReg & 7));
 					if (bits == 16)
-						emit->Write16((u16)operand.offset);
+						out = PutImm<u16>(out, (u16)operand.offset);
 					else
-						emit->Write32((u32)operand.offset);
+						out = PutImm<u32>(out, (u32)operand.offset);
+					emit->code = out;
 					return;
 				}
 				// op eax, imm
 				if (!scale && offsetOrBaseReg == EAX && normalops[op].eaximm32 != 0xCC)
 				{
-					emit->Write8(normalops[op].eaximm32);
+					*out++ = normalops[op].eaximm32;
 					if (bits == 16)
-						emit->Write16((u16)operand.offset);
+						out = PutImm<u16>(out, (u16)operand.offset);
 					else
-						emit->Write32((u32)operand.offset);
+						out = PutImm<u32>(out, (u32)operand.offset);
+					emit->code = out;
 					return;
 				}
 				// op r/m, imm
-				emit->Write8(normalops[op].imm32);
+				*out++ = normalops[op].imm32;
 				immToWrite = bits == 16 ? 16 : 32;
 			}
 		}
@@ -1228,7 +1230,7 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 				 (operand.scale == SCALE_IMM8 && bits == 64))
 		{
 			// op r/m, imm8
-			emit->Write8(normalops[op].simm8);
+			*out++ = normalops[op].simm8;
 			immToWrite = 8;
 		}
 		else if (operand.scale == SCALE_IMM64 && bits == 64)
@@ -1240,8 +1242,9 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 			// mov reg64, imm64
 			else if (op == nrmMOV)
 			{
-				emit->Write8(0xB8 + (offsetOrBaseReg & 7));
-				emit->Write64((u64)operand.offset);
+				*out++ = (u8)(0xB8 + (offsetOrBaseReg & 7));
+				out = PutImm<u64>(out, (u64)operand.offset);
+				emit->code = out;
 				return;
 			}
 			_assert_msg_(false, "WriteNormalOp - Only MOV can take 64-bit imm");
@@ -1255,35 +1258,38 @@ void OpArg::WriteNormalOp(XEmitter *emit, bool toRM, NormalOp op, const OpArg &o
 	else
 	{
 		_operandReg = (X64Reg)operand.offsetOrBaseReg;
-		WriteRex(emit, bits, bits, _operandReg);
+		u8 rex = RexPrefix(bits, bits, _operandReg);
+		if (rex != 0)
+			*out++ = rex;
 		// op r/m, reg
 		if (toRM)
 		{
-			emit->Write8(bits == 8 ? normalops[op].toRm8 : normalops[op].toRm32);
+			*out++ = bits == 8 ? normalops[op].toRm8 : normalops[op].toRm32;
 		}
 		// op reg, r/m
 		else
 		{
-			emit->Write8(bits == 8 ? normalops[op].fromRm8 : normalops[op].fromRm32);
+			*out++ = bits == 8 ? normalops[op].fromRm8 : normalops[op].fromRm32;
 		}
 	}
-	WriteRest(emit, immToWrite >> 3, _operandReg);
+	out = EncodeRest(out, immToWrite >> 3, _operandReg);
 	switch (immToWrite)
 	{
 	case 0:
 		break;
 	case 8:
-		emit->Write8((u8)operand.offset);
+		*out++ = (u8)operand.offset;
 		break;
 	case 16:
-		emit->Write16((u16)operand.offset);
+		out = PutImm<u16>(out, (u16)operand.offset);
 		break;
 	case 32:
-		emit->Write32((u32)operand.offset);
+		out = PutImm<u32>(out, (u32)operand.offset);
 		break;
 	default:
 		_assert_msg_(false, "WriteNormalOp - Unhandled case");
 	}
+	emit->code = out;
 }
 
 void XEmitter::WriteNormalOp(XEmitter *emit, int bits, NormalOp op, const OpArg &a1, const OpArg &a2)
@@ -1294,6 +1300,23 @@ void XEmitter::WriteNormalOp(XEmitter *emit, int bits, NormalOp op, const OpArg
 		_assert_msg_(false, "WriteNormalOp - a1 cannot be imm");
 		return;
 	}
+	if (a1.IsSimpleReg() && a2.IsSimpleReg() && bits != 8)
+	{
+		// Register to register is by far the most common form, so encode it in one go.
+		// This is the same [66] [REX] op /r that the generic path produces with a1 in reg.
+		int reg = a1.GetSimpleReg();
+		int rm = a2.GetSimpleReg();
+		u8 rex = (u8)(0x40 | (bits == 64 ? 8 : 0) | ((reg & 8) >> 1) | ((rm & 8) >> 3));
+		u8 *out = emit->code;
+		if (bits == 16)
+			*out++ = 0x66;
+		if (rex != 0x40)
+			*out++ = rex;
+		out[0] = normalops[op].fromRm32;
+		out[1] = (u8)(0xC0 | ((reg & 7) << 3) | (rm & 7));
+		emit->code = out + 2;
+		return;
+	}
 	if (a2.IsImm())
 	{
 		a1.WriteNormalOp(emit, true, op, a2, bits);
@@ -1408,15 +1431,18 @@ void XEmitter::IMUL(int bits, X64Reg regOp, OpArg a)
 
 void XEmitter::WriteSSEOp(u8 opPrefix, u16 op, X64Reg regOp, OpArg arg, int extrabytes)
 {
+	u8 *out = code;
 	if (opPrefix)
-		Write8(opPrefix);
+		*out++ = opPrefix;
 	arg.operandReg = regOp;
-	arg.WriteRex(this, 0, 0);
-	Write8(0x0F);
+	u8 rex = arg.RexPrefix(0, 0);
+	if (rex != 0)
+		*out++ = rex;
+	*out++ = 0x0F;
 	if (op > 0xFF)
-		Write8((op >> 8) & 0xFF);
-	Write8(op & 0xFF);
-	arg.WriteRest(this, extrabytes);
+		*out++ = (u8)((op >> 8) & 0xFF);
+	*out++ = (u8)(op & 0xFF);
+	code = arg.EncodeRest(out, extrabytes, INVALID_REG);
 }
 
 void XEmitter::WriteAVXOp(int bits, u8 opPrefix, u16 op, X64Reg regOp, OpArg arg, int extrabytes, int W) {
@@ -175,6 +175,20 @@ struct OpArg
 	void WriteRex(XEmitter *emit, int opBits, int bits, int customOp = -1) const;
 	void WriteVex(XEmitter* emit, X64Reg regOp1, X64Reg regOp2, int L, int pp, int mmmmm, int W = 0) const;
 	void WriteRest(XEmitter *emit, int extraBytes=0, X64Reg operandReg=INVALID_REG, bool warn_64bit_offset = true) const;
+	// Same as WriteRex/WriteRest, but on a plain pointer, so a whole instruction can be encoded
+	// without going back to the emitter's code pointer between bytes.  RexPrefix returns 0 if none is needed.
+	u8 RexPrefix(int opBits, int bits, int customOp = -1) const;
+	u8 *EncodeRest(u8 *out, int extraBytes, X64Reg operandReg, bool warn_64bit_offset = true) const
+	{
+		if (scale == SCALE_NONE)
+		{
+			// Just a register, which is by far the most common case.
+			int reg = operandReg == INVALID_REG ? this->operandReg : operandReg;
+			*out = (u8)(0xC0 | ((reg & 7) << 3) | (offsetOrBaseReg & 7));
+			return out + 1;
+		}
+		return EncodeMemRest(out, extraBytes, operandReg, warn_64bit_offset);
+	}
 	void WriteSingleByteOp(XEmitter *emit, u8 op, X64Reg operandReg, int bits);
 	// This one is public - must be written to
 	u64 offset;  // use RIP-relative as much as possible - 64-bit immediates are not available.
@@ -244,11 +258,48 @@ struct OpArg
 	}
 
 private:
+	u8 *EncodeMemRest(u8 *out, int extraBytes, X64Reg operandReg, bool warn_64bit_offset) const;
+
 	u8 scale;
 	u16 offsetOrBaseReg;
 	u16 indexReg;
 };
 
+inline u8 OpArg::RexPrefix(int opBits, int bits, int customOp) const
+{
+	if (customOp == -1)       customOp = operandReg;
+#if PPSSPP_ARCH(AMD64)
+	u8 op = 0x40;
+	// REX.W (whether operation is a 64-bit operation)
+	if (opBits == 64)         op |= 8;
+	// REX.R (whether ModR/M reg field refers to R8-R15.
+	if (customOp & 8)         op |= 4;
+	// REX.X (whether ModR/M SIB index field refers to R8-R15)
+	if (indexReg & 8)         op |= 2;
+	// REX.B (whether ModR/M rm or SIB base or opcode reg field refers to R8-R15)
+	if (offsetOrBaseReg & 8)  op |= 1;
+	// Write REX if wr have REX bits to write, or if the operation accesses
+	// SIL, DIL, BPL, or SPL.
+	if (op != 0x40 ||
+	    (scale == SCALE_NONE && bits == 8 && (offsetOrBaseReg & 0x10c) == 4) ||
+	    (opBits == 8 && (customOp & 0x10c) == 4))
+	{
+		// Check the operation doesn't access AH, BH, CH, or DH.
+		_dbg_assert_((offsetOrBaseReg & 0x100) == 0);
+		_dbg_assert_((customOp & 0x100) == 0);
+		return op;
+	}
+#else
+	_dbg_assert_(opBits != 64);
+	_dbg_assert_((customOp & 8) == 0 || customOp == -1);
+	_dbg_assert_((indexReg & 8) == 0);
+	_dbg_assert_((offsetOrBaseReg & 8) == 0);
+	_dbg_assert_(opBits != 8 || (customOp & 0x10c) != 4 || customOp == -1);
+	_dbg_assert_(scale == SCALE_ATREG || bits != 8 || (offsetOrBaseReg & 0x10c) != 4);
+#endif
+	return 0;
+}
+
 inline OpArg M(const void *ptr) {return OpArg((u64)ptr, (int)SCALE_RIP);}
 template <typename T>
 inline OpArg M(const T *ptr)    {return OpArg((u64)(const void *)ptr, (int)SCALE_RIP);}
@@ -83,6 +83,8 @@ struct Config {
 	bool bIgnoreBadMemAccess;
 
 	bool bFastMemory;
+	// Back emulated RAM/VRAM with huge pages where the OS allows it (Linux only for now.)
+	bool bMemoryHugePages;
 	int iCpuCore;
 	bool bCheckForNewVersion;
 	bool bForceLagSync;
@@ -183,6 +185,7 @@ struct Config {
 	bool bFullScreenMulti;
 	int iForceFullScreen = -1; // -1 = nope, 0 = force off, 1 = force on (not saved.)
 	int iInternalResolution;  // 0 = Auto (native), 1 = 1x (480x272), 2 = 2x, 3 = 3x, 4 = 4x and so on.
+	int iFramebufferMemoryBudgetMB;  // 0 = unlimited. Above this, unused framebuffers get downscaled or dropped.
 	int iAnisotropyLevel;  // 0 - 5, powers of 2: 0 = 1x = no aniso
 	int iMultiSampleLevel;
 	int bHighQualityDepth;
@@ -193,6 +196,7 @@ struct Config {
 	int iTexScalingType; // 0 = xBRZ, 1 = Hybrid
 	bool bTexDeposterize;
 	bool bTexHardwareScaling;
+	bool bTexComputeDecode;
 	int iFpsLimit1;
 	int iFpsLimit2;
 	int iAnalogFpsLimit;
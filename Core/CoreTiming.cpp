@@ -48,12 +48,6 @@ struct EventType {
 	const char *name;
 };
 
-static std::vector<EventType> event_types;
-// Only used during restore.
-static std::set<int> usedEventTypes;
-static std::set<int> restoredEventTypes;
-static int nextEventTypeRestoreId = -1;
-
 struct BaseEvent {
 	s64 time;
 	u64 userdata;
@@ -62,32 +56,70 @@ struct BaseEvent {
 
 typedef LinkedListItem<BaseEvent> Event;
 
-Event *first;
-Event *tsFirst;
-Event *tsLast;
+// Everything the scheduler keeps for one emulated machine.
+struct Context {
+	std::vector<EventType> event_types;
+	// Only used during restore.
+	std::set<int> usedEventTypes;
+	std::set<int> restoredEventTypes;
+	int nextEventTypeRestoreId = -1;
+
+	Event *first = nullptr;
+	Event *tsFirst = nullptr;
+	Event *tsLast = nullptr;
+
+	// event pools
+	Event *eventPool = nullptr;
+	Event *eventTsPool = nullptr;
+	int allocatedTsEvents = 0;
+	// Optimization to skip MoveEvents when possible.
+	std::atomic<u32> hasTsEvents{};
+
+	// Downcount has been moved to currentMIPS, to save a couple of clocks in every ARM JIT block
+	// as we can already reach that structure through a register.
+	int slicelength = 0;
+
+	alignas(16) s64 globalTimer = 0;
+	s64 idledCycles = 0;
+	s64 lastGlobalTimeTicks = 0;
+	s64 lastGlobalTimeUs = 0;
+
+	std::mutex externalEventLock;
 
-// event pools
-Event *eventPool = 0;
-Event *eventTsPool = 0;
-int allocatedTsEvents = 0;
-// Optimization to skip MoveEvents when possible.
-std::atomic<u32> hasTsEvents;
+	std::vector<MHzChangeCallback> mhzChangeCallbacks;
 
-// Downcount has been moved to currentMIPS, to save a couple of clocks in every ARM JIT block
-// as we can already reach that structure through a register.
-int slicelength;
+	// The live value is in currentMIPS, this holds it while the context isn't current.
+	int downcount = 0;
+};
+
+static Context defaultContext;
+// Threads that don't pick a context (GPU, audio, UI...) all share the default one.
+static thread_local Context *ctx = &defaultContext;
 
-alignas(16) s64 globalTimer;
-s64 idledCycles;
-s64 lastGlobalTimeTicks;
-s64 lastGlobalTimeUs;
+Context *CreateContext() {
+	return new Context();
+}
 
-static std::mutex externalEventLock;
+void DestroyContext(Context *context) {
+	_dbg_assert_msg_(context != ctx, "Destroying the current timing context");
+	_dbg_assert_msg_(context->first == nullptr && context->tsFirst == nullptr, "Destroying a timing context with events pending, call Shutdown() first");
+	delete context;
+}
 
-std::vector<MHzChangeCallback> mhzChangeCallbacks;
+Context *SetThreadContext(Context *context) {
+	Context *prev = ctx == &defaultContext ? nullptr : ctx;
+	Context *next = context ? context : &defaultContext;
+	if (next != ctx && currentMIPS) {
+		// The slice in progress belongs to the timing state, so it needs to follow it.
+		ctx->downcount = currentMIPS->downcount;
+		currentMIPS->downcount = next->downcount;
+	}
+	ctx = next;
+	return prev;
+}
 
 void FireMhzChange() {
-	for (MHzChangeCallback cb : mhzChangeCallbacks) {
+	for (MHzChangeCallback cb : ctx->mhzChangeCallbacks) {
 		cb();
 	}
 }
@@ -100,8 +132,8 @@ void SetClockFrequencyHz(int cpuHz) {
 
 	// When the mhz changes, we keep track of what "time" it was before hand.
 	// This way, time always moves forward, even if mhz is changed.
-	lastGlobalTimeUs = GetGlobalTimeUs();
-	lastGlobalTimeTicks = GetTicks();
+	ctx->lastGlobalTimeUs = GetGlobalTimeUs();
+	ctx->lastGlobalTimeTicks = GetTicks();
 
 	CPU_HZ = cpuHz;
 	// TODO: Rescale times of scheduled events?
@@ -118,55 +150,55 @@ u64 GetGlobalTimeUsScaled() {
 }
 
 u64 GetGlobalTimeUs() {
-	s64 ticksSinceLast = GetTicks() - lastGlobalTimeTicks;
+	s64 ticksSinceLast = GetTicks() - ctx->lastGlobalTimeTicks;
 	int freq = GetClockFrequencyHz();
 	s64 usSinceLast = ticksSinceLast * 1000000 / freq;
 	if (ticksSinceLast > UINT_MAX) {
 		// Adjust the calculated value to avoid overflow errors.
-		lastGlobalTimeUs += usSinceLast;
-		lastGlobalTimeTicks = GetTicks();
+		ctx->lastGlobalTimeUs += usSinceLast;
+		ctx->lastGlobalTimeTicks = GetTicks();
 		usSinceLast = 0;
 	}
-	return lastGlobalTimeUs + usSinceLast;
+	return ctx->lastGlobalTimeUs + usSinceLast;
 }
 
 Event* GetNewEvent()
 {
-	if(!eventPool)
+	if(!ctx->eventPool)
 		return new Event;
 
-	Event* ev = eventPool;
-	eventPool = ev->next;
+	Event* ev = ctx->eventPool;
+	ctx->eventPool = ev->next;
 	return ev;
 }
 
 Event* GetNewTsEvent()
 {
-	allocatedTsEvents++;
+	ctx->allocatedTsEvents++;
 
-	if(!eventTsPool)
+	if(!ctx->eventTsPool)
 		return new Event;
 
-	Event* ev = eventTsPool;
-	eventTsPool = ev->next;
+	Event* ev = ctx->eventTsPool;
+	ctx->eventTsPool = ev->next;
 	return ev;
 }
 
 void FreeEvent(Event* ev)
 {
-	ev->next = eventPool;
-	eventPool = ev;
+	ev->next = ctx->eventPool;
+	ctx->eventPool = ev;
 }
 
 void FreeTsEvent(Event* ev)
 {
-	ev->next = eventTsPool;
-	eventTsPool = ev;
-	allocatedTsEvents--;
+	ev->next = ctx->eventTsPool;
+	ctx->eventTsPool = ev;
+	ctx->allocatedTsEvents--;
 }
 
 int RegisterEvent(const char *name, TimedCallback callback) {
-	for (const auto &ty : event_types) {
+	for (const auto &ty : ctx->event_types) {
 		if (!strcmp(ty.name, name)) {
 			_assert_msg_(false, "Event type %s already registered", name);
 			// Try to make sure it doesn't work so we notice for sure.
@@ -174,9 +206,9 @@ int RegisterEvent(const char *name, TimedCallback callback) {
 		}
 	}
 
-	int id = (int)event_types.size();
-	event_types.push_back(EventType{ callback, name });
-	usedEventTypes.insert(id);
+	int id = (int)ctx->event_types.size();
+	ctx->event_types.push_back(EventType{ callback, name });
+	ctx->usedEventTypes.insert(id);
 	return id;
 }
 
@@ -187,43 +219,43 @@ void AntiCrashCallback(u64 userdata, int cyclesLate) {
 
 void RestoreRegisterEvent(int &event_type, const char *name, TimedCallback callback) {
 	// Some old states have a duplicate restore, do our best to fix...
-	if (restoredEventTypes.count(event_type) != 0)
+	if (ctx->restoredEventTypes.count(event_type) != 0)
 		event_type = -1;
 	if (event_type == -1)
-		event_type = nextEventTypeRestoreId++;
-	if (event_type >= (int)event_types.size()) {
+		event_type = ctx->nextEventTypeRestoreId++;
+	if (event_type >= (int)ctx->event_types.size()) {
 		// Give it any unused event id starting from the end.
 		// Older save states with messed up ids have gaps near the end.
-		for (int i = (int)event_types.size() - 1; i >= 0; --i) {
-			if (usedEventTypes.count(i) == 0) {
+		for (int i = (int)ctx->event_types.size() - 1; i >= 0; --i) {
+			if (ctx->usedEventTypes.count(i) == 0) {
 				event_type = i;
 				break;
 			}
 		}
 	}
-	_assert_msg_(event_type >= 0 && event_type < (int)event_types.size(), "Invalid event type %d", event_type);
-	event_types[event_type] = EventType{ callback, name };
-	usedEventTypes.insert(event_type);
-	restoredEventTypes.insert(event_type);
+	_assert_msg_(event_type >= 0 && event_type < (int)ctx->event_types.size(), "Invalid event type %d", event_type);
+	ctx->event_types[event_type] = EventType{ callback, name };
+	ctx->usedEventTypes.insert(event_type);
+	ctx->restoredEventTypes.insert(event_type);
 }
 
 void UnregisterAllEvents() {
-	_dbg_assert_msg_(first == nullptr, "Unregistering events with events pending - this isn't good.");
-	event_types.clear();
-	usedEventTypes.clear();
-	restoredEventTypes.clear();
+	_dbg_assert_msg_(ctx->first == nullptr, "Unregistering events with events pending - this isn't good.");
+	ctx->event_types.clear();
+	ctx->usedEventTypes.clear();
+	ctx->restoredEventTypes.clear();
 }
 
 void Init()
 {
 	currentMIPS->downcount = INITIAL_SLICE_LENGTH;
-	slicelength = INITIAL_SLICE_LENGTH;
-	globalTimer = 0;
-	idledCycles = 0;
-	lastGlobalTimeTicks = 0;
-	lastGlobalTimeUs = 0;
-	hasTsEvents = 0;
-	mhzChangeCallbacks.clear();
+	ctx->slicelength = INITIAL_SLICE_LENGTH;
+	ctx->globalTimer = 0;
+	ctx->idledCycles = 0;
+	ctx->lastGlobalTimeTicks = 0;
+	ctx->lastGlobalTimeUs = 0;
+	ctx->hasTsEvents = 0;
+	ctx->mhzChangeCallbacks.clear();
 	CPU_HZ = initialHz;
 }
 
@@ -233,16 +265,16 @@ void Shutdown()
 	ClearPendingEvents();
 	UnregisterAllEvents();
 
-	while (eventPool) {
-		Event *ev = eventPool;
-		eventPool = ev->next;
+	while (ctx->eventPool) {
+		Event *ev = ctx->eventPool;
+		ctx->eventPool = ev->next;
 		delete ev;
 	}
 
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	while (eventTsPool) {
-		Event *ev = eventTsPool;
-		eventTsPool = ev->next;
+	std::lock_guard<std::mutex> lk(ctx->externalEventLock);
+	while (ctx->eventTsPool) {
+		Event *ev = ctx->eventTsPool;
+		ctx->eventTsPool = ev->next;
 		delete ev;
 	}
 }
@@ -250,7 +282,7 @@ void Shutdown()
 u64 GetTicks()
 {
 	if (currentMIPS) {
-		return (u64)globalTimer + slicelength - currentMIPS->downcount;
+		return (u64)ctx->globalTimer + ctx->slicelength - currentMIPS->downcount;
 	} else {
 		// Reporting can actually end up here during weird task switching sequences on Android
 		return false;
@@ -259,7 +291,7 @@ u64 GetTicks()
 
 u64 GetIdleTicks()
 {
-	return (u64)idledCycles;
+	return (u64)ctx->idledCycles;
 }
 
 
@@ -267,19 +299,19 @@ u64 GetIdleTicks()
 // schedule things to be executed on the main thread.
 void ScheduleEvent_Threadsafe(s64 cyclesIntoFuture, int event_type, u64 userdata)
 {
-	std::lock_guard<std::mutex> lk(externalEventLock);
+	std::lock_guard<std::mutex> lk(ctx->externalEventLock);
 	Event *ne = GetNewTsEvent();
 	ne->time = GetTicks() + cyclesIntoFuture;
 	ne->type = event_type;
 	ne->next = 0;
 	ne->userdata = userdata;
-	if(!tsFirst)
-		tsFirst = ne;
-	if(tsLast)
-		tsLast->next = ne;
-	tsLast = ne;
+	if(!ctx->tsFirst)
+		ctx->tsFirst = ne;
+	if(ctx->tsLast)
+		ctx->tsLast->next = ne;
+	ctx->tsLast = ne;
 
-	hasTsEvents.store(1, std::memory_order::memory_order_release);
+	ctx->hasTsEvents.store(1, std::memory_order::memory_order_release);
 }
 
 // Same as ScheduleEvent_Threadsafe(0, ...) EXCEPT if we are already on the CPU thread
@@ -288,8 +320,8 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 {
 	if(false) //Core::IsCPUThread())
 	{
-		std::lock_guard<std::mutex> lk(externalEventLock);
-		event_types[event_type].callback(userdata, 0);
+		std::lock_guard<std::mutex> lk(ctx->externalEventLock);
+		ctx->event_types[event_type].callback(userdata, 0);
 	}
 	else
 		ScheduleEvent_Threadsafe(0, event_type, userdata);
@@ -297,18 +329,18 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 
 void ClearPendingEvents()
 {
-	while (first)
+	while (ctx->first)
 	{
-		Event *e = first->next;
-		FreeEvent(first);
-		first = e;
+		Event *e = ctx->first->next;
+		FreeEvent(ctx->first);
+		ctx->first = e;
 	}
 }
 
 void AddEventToQueue(Event* ne)
 {
 	Event* prev = NULL;
-	Event** pNext = &first;
+	Event** pNext = &ctx->first;
 	for(;;)
 	{
 		Event*& next = *pNext;
@@ -339,26 +371,26 @@ void ScheduleEvent(s64 cyclesIntoFuture, int event_type, u64 userdata)
 s64 UnscheduleEvent(int event_type, u64 userdata)
 {
 	s64 result = 0;
-	if (!first)
+	if (!ctx->first)
 		return result;
-	while(first)
+	while(ctx->first)
 	{
-		if (first->type == event_type && first->userdata == userdata)
+		if (ctx->first->type == event_type && ctx->first->userdata == userdata)
 		{
-			result = first->time - GetTicks();
+			result = ctx->first->time - GetTicks();
 
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
+			Event *next = ctx->first->next;
+			FreeEvent(ctx->first);
+			ctx->first = next;
 		}
 		else
 		{
 			break;
 		}
 	}
-	if (!first)
+	if (!ctx->first)
 		return result;
-	Event *prev = first;
+	Event *prev = ctx->first;
 	Event *ptr = prev->next;
 	while (ptr)
 	{
@@ -383,31 +415,31 @@ s64 UnscheduleEvent(int event_type, u64 userdata)
 s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata)
 {
 	s64 result = 0;
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	if (!tsFirst)
+	std::lock_guard<std::mutex> lk(ctx->externalEventLock);
+	if (!ctx->tsFirst)
 		return result;
-	while(tsFirst)
+	while(ctx->tsFirst)
 	{
-		if (tsFirst->type == event_type && tsFirst->userdata == userdata)
+		if (ctx->tsFirst->type == event_type && ctx->tsFirst->userdata == userdata)
 		{
-			result = tsFirst->time - GetTicks();
+			result = ctx->tsFirst->time - GetTicks();
 
-			Event *next = tsFirst->next;
-			FreeTsEvent(tsFirst);
-			tsFirst = next;
+			Event *next = ctx->tsFirst->next;
+			FreeTsEvent(ctx->tsFirst);
+			ctx->tsFirst = next;
 		}
 		else
 		{
 			break;
 		}
 	}
-	if (!tsFirst)
+	if (!ctx->tsFirst)
 	{
-		tsLast = NULL;
+		ctx->tsLast = NULL;
 		return result;
 	}
 
-	Event *prev = tsFirst;
+	Event *prev = ctx->tsFirst;
 	Event *ptr = prev->next;
 	while (ptr)
 	{
@@ -416,8 +448,8 @@ s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata)
 			result = ptr->time - GetTicks();
 
 			prev->next = ptr->next;
-			if (ptr == tsLast)
-				tsLast = prev;
+			if (ptr == ctx->tsLast)
+				ctx->tsLast = prev;
 			FreeTsEvent(ptr);
 			ptr = prev->next;
 		}
@@ -432,14 +464,14 @@ s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata)
 }
 
 void RegisterMHzChangeCallback(MHzChangeCallback callback) {
-	mhzChangeCallbacks.push_back(callback);
+	ctx->mhzChangeCallbacks.push_back(callback);
 }
 
 bool IsScheduled(int event_type)
 {
-	if (!first)
+	if (!ctx->first)
 		return false;
-	Event *e = first;
+	Event *e = ctx->first;
 	while (e) {
 		if (e->type == event_type)
 			return true;
@@ -450,24 +482,24 @@ bool IsScheduled(int event_type)
 
 void RemoveEvent(int event_type)
 {
-	if (!first)
+	if (!ctx->first)
 		return;
-	while(first)
+	while(ctx->first)
 	{
-		if (first->type == event_type)
+		if (ctx->first->type == event_type)
 		{
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
+			Event *next = ctx->first->next;
+			FreeEvent(ctx->first);
+			ctx->first = next;
 		}
 		else
 		{
 			break;
 		}
 	}
-	if (!first)
+	if (!ctx->first)
 		return;
-	Event *prev = first;
+	Event *prev = ctx->first;
 	Event *ptr = prev->next;
 	while (ptr)
 	{
@@ -487,38 +519,38 @@ void RemoveEvent(int event_type)
 
 void RemoveThreadsafeEvent(int event_type)
 {
-	std::lock_guard<std::mutex> lk(externalEventLock);
-	if (!tsFirst)
+	std::lock_guard<std::mutex> lk(ctx->externalEventLock);
+	if (!ctx->tsFirst)
 	{
 		return;
 	}
-	while(tsFirst)
+	while(ctx->tsFirst)
 	{
-		if (tsFirst->type == event_type)
+		if (ctx->tsFirst->type == event_type)
 		{
-			Event *next = tsFirst->next;
-			FreeTsEvent(tsFirst);
-			tsFirst = next;
+			Event *next = ctx->tsFirst->next;
+			FreeTsEvent(ctx->tsFirst);
+			ctx->tsFirst = next;
 		}
 		else
 		{
 			break;
 		}
 	}
-	if (!tsFirst)
+	if (!ctx->tsFirst)
 	{
-		tsLast = NULL;
+		ctx->tsLast = NULL;
 		return;
 	}
-	Event *prev = tsFirst;
+	Event *prev = ctx->tsFirst;
 	Event *ptr = prev->next;
 	while (ptr)
 	{
 		if (ptr->type == event_type)
 		{
 			prev->next = ptr->next;
-			if (ptr == tsLast)
-				tsLast = prev;
+			if (ptr == ctx->tsLast)
+				ctx->tsLast = prev;
 			FreeTsEvent(ptr);
 			ptr = prev->next;
 		}
@@ -539,15 +571,15 @@ void RemoveAllEvents(int event_type)
 //This raise only the events required while the fifo is processing data
 void ProcessFifoWaitEvents()
 {
-	while (first)
+	while (ctx->first)
 	{
-		if (first->time <= (s64)GetTicks())
+		if (ctx->first->time <= (s64)GetTicks())
 		{
 //			LOG(CPU, "[Scheduler] %s		 (%lld, %lld) ",
 //				first->name ? first->name : "?", (u64)GetTicks(), (u64)first->time);
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(GetTicks() - evt->time));
+			Event* evt = ctx->first;
+			ctx->first = ctx->first->next;
+			ctx->event_types[evt->type].callback(evt->userdata, (int)(GetTicks() - evt->time));
 			FreeEvent(evt);
 		}
 		else
@@ -559,37 +591,37 @@ void ProcessFifoWaitEvents()
 
 void MoveEvents()
 {
-	hasTsEvents.store(0, std::memory_order::memory_order_release);
+	ctx->hasTsEvents.store(0, std::memory_order::memory_order_release);
 
-	std::lock_guard<std::mutex> lk(externalEventLock);
+	std::lock_guard<std::mutex> lk(ctx->externalEventLock);
 	// Move events from async queue into main queue
-	while (tsFirst)
+	while (ctx->tsFirst)
 	{
-		Event *next = tsFirst->next;
-		AddEventToQueue(tsFirst);
-		tsFirst = next;
+		Event *next = ctx->tsFirst->next;
+		AddEventToQueue(ctx->tsFirst);
+		ctx->tsFirst = next;
 	}
-	tsLast = NULL;
+	ctx->tsLast = NULL;
 
 	// Move free events to threadsafe pool
-	while(allocatedTsEvents > 0 && eventPool)
+	while(ctx->allocatedTsEvents > 0 && ctx->eventPool)
 	{
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		ev->next = eventTsPool;
-		eventTsPool = ev;
-		allocatedTsEvents--;
+		Event *ev = ctx->eventPool;
+		ctx->eventPool = ev->next;
+		ev->next = ctx->eventTsPool;
+		ctx->eventTsPool = ev;
+		ctx->allocatedTsEvents--;
 	}
 }
 
 void ForceCheck()
 {
-	int cyclesExecuted = slicelength - currentMIPS->downcount;
-	globalTimer += cyclesExecuted;
+	int cyclesExecuted = ctx->slicelength - currentMIPS->downcount;
+	ctx->globalTimer += cyclesExecuted;
 	// This will cause us to check for new events immediately.
 	currentMIPS->downcount = -1;
 	// But let's not eat a bunch more time in Advance() because of this.
-	slicelength = -1;
+	ctx->slicelength = -1;
 
 #ifdef _DEBUG
 	_dbg_assert_msg_( cyclesExecuted >= 0, "Shouldn't have a negative cyclesExecuted");
@@ -598,34 +630,34 @@ void ForceCheck()
 
 void Advance() {
 	PROFILE_THIS_SCOPE("advance");
-	int cyclesExecuted = slicelength - currentMIPS->downcount;
-	globalTimer += cyclesExecuted;
-	currentMIPS->downcount = slicelength;
+	int cyclesExecuted = ctx->slicelength - currentMIPS->downcount;
+	ctx->globalTimer += cyclesExecuted;
+	currentMIPS->downcount = ctx->slicelength;
 
-	if (hasTsEvents.load(std::memory_order_acquire))
+	if (ctx->hasTsEvents.load(std::memory_order_acquire))
 		MoveEvents();
 	ProcessFifoWaitEvents();
 
-	if (!first) {
+	if (!ctx->first) {
 		// This should never happen in PPSSPP.
-		if (slicelength < 10000) {
-			slicelength += 10000;
+		if (ctx->slicelength < 10000) {
+			ctx->slicelength += 10000;
 			currentMIPS->downcount += 10000;
 		}
 	} else {
 		// Note that events can eat cycles as well.
-		int target = (int)(first->time - globalTimer);
+		int target = (int)(ctx->first->time - ctx->globalTimer);
 		if (target > MAX_SLICE_LENGTH)
 			target = MAX_SLICE_LENGTH;
 
-		const int diff = target - slicelength;
-		slicelength += diff;
+		const int diff = target - ctx->slicelength;
+		ctx->slicelength += diff;
 		currentMIPS->downcount += diff;
 	}
 }
 
 void LogPendingEvents() {
-	Event *ptr = first;
+	Event *ptr = ctx->first;
 	while (ptr) {
 		//INFO_LOG(CPU, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer, ptr->time, ptr->type);
 		ptr = ptr->next;
@@ -637,9 +669,9 @@ void Idle(int maxIdle) {
 	if (maxIdle != 0 && cyclesDown > maxIdle)
 		cyclesDown = maxIdle;
 
-	if (first && cyclesDown > 0) {
-		int cyclesExecuted = slicelength - currentMIPS->downcount;
-		int cyclesNextEvent = (int) (first->time - globalTimer);
+	if (ctx->first && cyclesDown > 0) {
+		int cyclesExecuted = ctx->slicelength - currentMIPS->downcount;
+		int cyclesNextEvent = (int) (ctx->first->time - ctx->globalTimer);
 
 		if (cyclesNextEvent < cyclesExecuted + cyclesDown)
 			cyclesDown = cyclesNextEvent - cyclesExecuted;
@@ -651,24 +683,24 @@ void Idle(int maxIdle) {
 
 	// VERBOSE_LOG(CPU, "Idle for %i cycles! (%f ms)", cyclesDown, cyclesDown / (float)(CPU_HZ * 0.001f));
 
-	idledCycles += cyclesDown;
+	ctx->idledCycles += cyclesDown;
 	currentMIPS->downcount -= cyclesDown;
 	if (currentMIPS->downcount == 0)
 		currentMIPS->downcount = -1;
 }
 
 std::string GetScheduledEventsSummary() {
-	Event *ptr = first;
+	Event *ptr = ctx->first;
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
 	while (ptr) {
 		unsigned int t = ptr->type;
-		if (t >= event_types.size()) {
+		if (t >= ctx->event_types.size()) {
 			_dbg_assert_msg_(false, "Invalid event type %d", t);
 			ptr = ptr->next;
 			continue;
 		}
-		const char *name = event_types[t].name;
+		const char *name = ctx->event_types[t].name;
 		if (!name)
 			name = "[unknown]";
 		char temp[512];
@@ -685,23 +717,23 @@ void Event_DoState(PointerWrap &p, BaseEvent *ev)
 	Do(p, ev->time);
 	Do(p, ev->userdata);
 	Do(p, ev->type);
-	usedEventTypes.insert(ev->type);
+	ctx->usedEventTypes.insert(ev->type);
 }
 
 void Event_DoStateOld(PointerWrap &p, BaseEvent *ev)
 {
 	Do(p, *ev);
-	usedEventTypes.insert(ev->type);
+	ctx->usedEventTypes.insert(ev->type);
 }
 
 void DoState(PointerWrap &p) {
-	std::lock_guard<std::mutex> lk(externalEventLock);
+	std::lock_guard<std::mutex> lk(ctx->externalEventLock);
 
 	auto s = p.Section("CoreTiming", 1, 3);
 	if (!s)
 		return;
 
-	int n = (int)event_types.size();
+	int n = (int)ctx->event_types.size();
 	int current = n;
 	Do(p, n);
 	if (n > current) {
@@ -712,32 +744,32 @@ void DoState(PointerWrap &p) {
 
 	// These (should) be filled in later by the modules.
 	for (int i = 0; i < current; ++i) {
-		event_types[i].callback = AntiCrashCallback;
-		event_types[i].name = "INVALID EVENT";
+		ctx->event_types[i].callback = AntiCrashCallback;
+		ctx->event_types[i].name = "INVALID EVENT";
 	}
-	nextEventTypeRestoreId = n - 1;
-	usedEventTypes.clear();
-	restoredEventTypes.clear();
+	ctx->nextEventTypeRestoreId = n - 1;
+	ctx->usedEventTypes.clear();
+	ctx->restoredEventTypes.clear();
 
 	if (s >= 3) {
-		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoState>(p, first, (Event **) NULL);
-		DoLinkedList<BaseEvent, GetNewTsEvent, FreeTsEvent, Event_DoState>(p, tsFirst, &tsLast);
+		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoState>(p, ctx->first, (Event **) NULL);
+		DoLinkedList<BaseEvent, GetNewTsEvent, FreeTsEvent, Event_DoState>(p, ctx->tsFirst, &ctx->tsLast);
 	} else {
-		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoStateOld>(p, first, (Event **) NULL);
-		DoLinkedList<BaseEvent, GetNewTsEvent, FreeTsEvent, Event_DoStateOld>(p, tsFirst, &tsLast);
+		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoStateOld>(p, ctx->first, (Event **) NULL);
+		DoLinkedList<BaseEvent, GetNewTsEvent, FreeTsEvent, Event_DoStateOld>(p, ctx->tsFirst, &ctx->tsLast);
 	}
 
 	Do(p, CPU_HZ);
-	Do(p, slicelength);
-	Do(p, globalTimer);
-	Do(p, idledCycles);
+	Do(p, ctx->slicelength);
+	Do(p, ctx->globalTimer);
+	Do(p, ctx->idledCycles);
 
 	if (s >= 2) {
-		Do(p, lastGlobalTimeTicks);
-		Do(p, lastGlobalTimeUs);
+		Do(p, ctx->lastGlobalTimeTicks);
+		Do(p, ctx->lastGlobalTimeUs);
 	} else {
-		lastGlobalTimeTicks = 0;
-		lastGlobalTimeUs = 0;
+		ctx->lastGlobalTimeTicks = 0;
+		ctx->lastGlobalTimeUs = 0;
 	}
 
 	FireMhzChange();
@@ -72,6 +72,17 @@ inline s64 cyclesToUs(s64 cycles) {
 
 namespace CoreTiming
 {
+	// All scheduler state (events, pools, timers) lives in a Context. By default every thread
+	// shares one, so nothing changes for the normal single emulator. A batch runner can create
+	// more and make one current with SetThreadContext, then Init/Shutdown it there. Switching also
+	// swaps currentMIPS->downcount, but CPU_HZ and currentMIPS itself are still global, so two
+	// contexts can't advance at the same time on different threads yet.
+	struct Context;
+	Context *CreateContext();
+	void DestroyContext(Context *context);
+	// Returns the previous context of this thread (nullptr for the default.) Pass nullptr to go back to the default.
+	Context *SetThreadContext(Context *context);
+
 	void Init();
 	void Shutdown();
 
@@ -123,6 +134,5 @@ namespace CoreTiming
 
 	void SetClockFrequencyHz(int cpuHz);
 	int GetClockFrequencyHz();
-	extern int slicelength;
 
 }; // end of namespace
@@ -373,9 +373,18 @@ void PSPSaveDialog::DisplaySaveList(bool canMove) {
 	static int upFramesHeld = 0;
 	static int downFramesHeld = 0;
 
+	// Decode the icons on screen and a few past it in parallel, they're loaded as they're drawn.
+	const int PREFETCH_ICONS = 12;
+	int prefetchEnd = std::min(param.GetFilenameCount(), currentSelectedSave + PREFETCH_ICONS + 1);
+	for (int i = std::max(0, currentSelectedSave - PREFETCH_ICONS); i < prefetchEnd; ++i) {
+		PPGeImage *texture = param.GetFileInfo(i).texture;
+		if (texture)
+			texture->Prefetch();
+	}
+
 	for (int displayCount = 0; displayCount < param.GetFilenameCount(); displayCount++) {
 		PPGeImageStyle imageStyle = FadedImageStyle();
-		auto fileInfo = param.GetFileInfo(displayCount);
+		const SaveFileInfo &fileInfo = param.GetFileInfo(displayCount);
 
 		if (fileInfo.size == 0 && fileInfo.texture && fileInfo.texture->IsValid())
 			imageStyle.color = CalcFadedColor(0xFF777777);
@@ -16,6 +16,7 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include "Common/Log.h"
 #include "Common/Data/Text/I18n.h"
@@ -49,6 +50,28 @@ static const u32 FILE_LIST_TOTAL_SIZE = sizeof(SaveSFOFileListEntry) * FILE_LIST
 
 static const std::string savePath = "ms0:/PSP/SAVEDATA/";
 
+// What the dialogs need from a save directory, so listing them again doesn't reread everything.
+struct SavedataIndexEntry {
+	PSPFileInfo info;
+	// Adding or removing files updates the directory time, but PARAM.SFO may be rewritten in place.
+	// Other files rewritten in place change the size shown, these are caught by sceIo instead.
+	tm dirMtime{};
+	tm sfoMtime{};
+	s64 sfoSize = 0;
+	bool sfoExists = false;
+	bool sfoValid = false;
+	std::string title;
+	std::string saveTitle;
+	std::string saveDetail;
+	int checkedPass = 0;
+	int fileWrites = 0;
+};
+
+// Bumped when a game writes into the savedata folder through sceIo, so index entries built before it
+// are rebuilt. Files changed from outside the emulator while it runs are still only caught when the
+// directory or PARAM.SFO times change.
+static std::atomic<int> saveFileWrites;
+
 namespace
 {
 	int getSizeNormalized(int size)
@@ -347,6 +370,7 @@ bool SavedataParam::Delete(SceUtilitySavedataParam* param, int saveId) {
 	}
 
 	ClearCaches();
+	InvalidateSaveIndex(dirPath);
 	pspFileSystem.RmDir(dirPath);
 	return true;
 }
@@ -383,6 +407,7 @@ int SavedataParam::DeleteData(SceUtilitySavedataParam* param) {
 	}
 
 	ClearCaches();
+	InvalidateSaveIndex(dirPath);
 	pspFileSystem.RemoveFile(filePath);
 
 	// Update PARAM.SFO to remove the file, if it was in the list.
@@ -452,6 +477,7 @@ int SavedataParam::Save(SceUtilitySavedataParam* param, const std::string &saveD
 	}
 
 	std::string dirPath = GetSaveFilePath(param, GetSaveDir(param, saveDirName));
+	InvalidateSaveIndex(dirPath);
 
 	if (!pspFileSystem.GetFileInfo(dirPath).exists) {
 		if (!pspFileSystem.MkDir(dirPath)) {
@@ -1480,6 +1506,9 @@ int SavedataParam::SetPspParam(SceUtilitySavedataParam *param)
 		return 0;
 	}
 
+	// Index entries checked during this call are trusted for the rest of it.
+	saveIndexPass_++;
+
 	if (param->mode == SCE_UTILITY_SAVEDATA_TYPE_LISTALLDELETE) {
 		Clear();
 		int realCount = 0;
@@ -1522,12 +1551,17 @@ int SavedataParam::SetPspParam(SceUtilitySavedataParam *param)
 			
 			// get and stock file info for each file
 			int realCount = 0;
+			std::vector<PSPFileInfo> allSaves;
+			bool listedAllSaves = false;
+			const std::string gameName = GetGameName(param);
 			for (int i = 0; i < saveDataListCount; i++) {
 				// "<>" means saveName can be anything...
 				if (strncmp(saveNameListData[i], "<>", ARRAY_SIZE(saveNameListData[i])) == 0) {
 					// TODO:Maybe we need a way to reorder the files?
-					auto allSaves = pspFileSystem.GetDirListing(savePath);
-					std::string gameName = GetGameName(param);
+					if (!listedAllSaves) {
+						allSaves = pspFileSystem.GetDirListing(savePath);
+						listedAllSaves = true;
+					}
 					for (auto it = allSaves.begin(); it != allSaves.end(); ++it) {
 						if (it->name.compare(0, gameName.length(), gameName) == 0) {
 							std::string saveName = it->name.substr(gameName.length());
@@ -1630,12 +1664,11 @@ void SavedataParam::SetFileInfo(SaveFileInfo &saveInfo, PSPFileInfo &info, std::
 	}
 
 	// Load info in PARAM.SFO
-	std::string sfoFilename = savePath + saveDir + "/" + SFO_FILENAME;
-	std::shared_ptr<ParamSFOData> sfoFile = LoadCachedSFO(sfoFilename);
-	if (sfoFile) {
-		SetStringFromSFO(*sfoFile, "TITLE", saveInfo.title, sizeof(saveInfo.title));
-		SetStringFromSFO(*sfoFile, "SAVEDATA_TITLE", saveInfo.saveTitle, sizeof(saveInfo.saveTitle));
-		SetStringFromSFO(*sfoFile, "SAVEDATA_DETAIL", saveInfo.saveDetail, sizeof(saveInfo.saveDetail));
+	std::shared_ptr<SavedataIndexEntry> entry = GetSaveIndexEntry(savePath + saveDir);
+	if (entry && entry->sfoValid) {
+		truncate_cpy(saveInfo.title, sizeof(saveInfo.title), entry->title.c_str());
+		truncate_cpy(saveInfo.saveTitle, sizeof(saveInfo.saveTitle), entry->saveTitle.c_str());
+		truncate_cpy(saveInfo.saveDetail, sizeof(saveInfo.saveDetail), entry->saveDetail.c_str());
 	} else {
 		saveInfo.broken = true;
 		truncate_cpy(saveInfo.title, saveDir.c_str());
@@ -1675,27 +1708,106 @@ void SavedataParam::ClearFileInfo(SaveFileInfo &saveInfo, const std::string &sav
 }
 
 PSPFileInfo SavedataParam::GetSaveInfo(std::string saveDir) {
-	PSPFileInfo info = pspFileSystem.GetFileInfo(saveDir);
-	if (info.exists) {
-		info.access = 0777;
-		auto allFiles = pspFileSystem.GetDirListing(saveDir);
-		bool firstFile = true;
-		for (auto file : allFiles) {
-			if (file.type == FILETYPE_DIRECTORY || file.name == "." || file.name == "..")
-				continue;
-			// Use a file to determine save date.
-			if (firstFile) {
-				info.ctime = file.ctime;
-				info.mtime = file.mtime;
-				info.atime = file.atime;
-				info.size += file.size;
-				firstFile = false;
-			} else {
-				info.size += file.size;
-			}
+	std::shared_ptr<SavedataIndexEntry> entry = GetSaveIndexEntry(saveDir);
+	if (!entry)
+		return PSPFileInfo();
+	return entry->info;
+}
+
+static bool SameTime(const tm &a, const tm &b) {
+	return a.tm_sec == b.tm_sec && a.tm_min == b.tm_min && a.tm_hour == b.tm_hour && a.tm_mday == b.tm_mday && a.tm_mon == b.tm_mon && a.tm_year == b.tm_year;
+}
+
+std::shared_ptr<SavedataIndexEntry> SavedataParam::GetSaveIndexEntry(const std::string &dirPath) {
+	std::shared_ptr<SavedataIndexEntry> entry;
+	{
+		std::lock_guard<std::mutex> guard(cacheLock_);
+		auto it = saveIndex_.find(dirPath);
+		if (it != saveIndex_.end()) {
+			entry = it->second;
+			if (entry->fileWrites != saveFileWrites)
+				entry = nullptr;
+			else if (entry->checkedPass == saveIndexPass_)
+				return entry;
+		}
+	}
+
+	PSPFileInfo dirInfo = pspFileSystem.GetFileInfo(dirPath);
+	if (!dirInfo.exists) {
+		InvalidateSaveIndex(dirPath);
+		return nullptr;
+	}
+
+	// Two stats instead of a listing and a PARAM.SFO read, which adds up with hundreds of saves.
+	std::string sfoPath = dirPath + "/" + SFO_FILENAME;
+	PSPFileInfo sfoInfo = pspFileSystem.GetFileInfo(sfoPath);
+	if (entry && SameTime(entry->dirMtime, dirInfo.mtime) && entry->sfoExists == sfoInfo.exists && entry->sfoSize == sfoInfo.size && SameTime(entry->sfoMtime, sfoInfo.mtime)) {
+		std::lock_guard<std::mutex> guard(cacheLock_);
+		entry->checkedPass = saveIndexPass_;
+		return entry;
+	}
+
+	entry = std::make_shared<SavedataIndexEntry>();
+	// Read first, a write racing with the listing below makes the next lookup rebuild it again.
+	entry->fileWrites = saveFileWrites;
+	entry->dirMtime = dirInfo.mtime;
+	entry->sfoExists = sfoInfo.exists;
+	entry->sfoSize = sfoInfo.size;
+	entry->sfoMtime = sfoInfo.mtime;
+	entry->checkedPass = saveIndexPass_;
+
+	PSPFileInfo &info = entry->info;
+	info = dirInfo;
+	info.access = 0777;
+	auto allFiles = pspFileSystem.GetDirListing(dirPath);
+	bool firstFile = true;
+	for (auto file : allFiles) {
+		if (file.type == FILETYPE_DIRECTORY || file.name == "." || file.name == "..")
+			continue;
+		// Use a file to determine save date.
+		if (firstFile) {
+			info.ctime = file.ctime;
+			info.mtime = file.mtime;
+			info.atime = file.atime;
+			info.size += file.size;
+			firstFile = false;
+		} else {
+			info.size += file.size;
 		}
 	}
-	return info;
+
+	std::shared_ptr<ParamSFOData> sfoFile = sfoInfo.exists ? LoadCachedSFO(sfoPath) : nullptr;
+	if (sfoFile) {
+		entry->sfoValid = true;
+		entry->title = sfoFile->GetValueString("TITLE");
+		entry->saveTitle = sfoFile->GetValueString("SAVEDATA_TITLE");
+		entry->saveDetail = sfoFile->GetValueString("SAVEDATA_DETAIL");
+	}
+
+	std::lock_guard<std::mutex> guard(cacheLock_);
+	saveIndex_[dirPath] = entry;
+	return entry;
+}
+
+void SavedataParam::InvalidateSaveIndex(const std::string &dirPath) {
+	std::lock_guard<std::mutex> guard(cacheLock_);
+	saveIndex_.erase(dirPath);
+}
+
+void SavedataParam::NotifyFileWritten(const std::string &filename) {
+	std::string path;
+	IFileSystem *system = nullptr;
+	if (pspFileSystem.MapFilePath(filename, path, &system) != 0)
+		return;
+
+	std::string savedataPath;
+	IFileSystem *savedataSystem = nullptr;
+	if (pspFileSystem.MapFilePath(savePath, savedataPath, &savedataSystem) != 0)
+		return;
+
+	// Mapped paths don't keep the trailing slash.
+	if (system == savedataSystem && startsWithNoCase(path, savedataPath + "/"))
+		saveFileWrites++;
 }
 
 SceUtilitySavedataParam *SavedataParam::GetPspParam()
@@ -33,6 +33,7 @@
 
 class PPGeImage;
 struct PSPFileInfo;
+struct SavedataIndexEntry;
 typedef u32_le SceSize_le;
 
 enum SceUtilitySavedataType
@@ -357,6 +358,10 @@ class SavedataParam
 
 	void ClearCaches();
 
+	// Called by sceIo when a file opened for writing is closed, since rewriting a save file in place
+	// doesn't touch anything the save index checks.
+	static void NotifyFileWritten(const std::string &filename);
+
 	void DoState(PointerWrap &p);
 
 private:
@@ -365,6 +370,8 @@ class SavedataParam
 	void SetFileInfo(SaveFileInfo &saveInfo, PSPFileInfo &info, std::string saveName, std::string saveDir = "");
 	void ClearFileInfo(SaveFileInfo &saveInfo, const std::string &saveName);
 	PSPFileInfo GetSaveInfo(std::string saveDir);
+	std::shared_ptr<SavedataIndexEntry> GetSaveIndexEntry(const std::string &dirPath);
+	void InvalidateSaveIndex(const std::string &dirPath);
 
 	int LoadSaveData(SceUtilitySavedataParam *param, const std::string &saveDirName, const std::string& dirPath, bool secureMode);
 	u32 LoadCryptedSave(SceUtilitySavedataParam *param, u8 *data, const u8 *saveData, int &saveSize, int prevCryptMode, const u8 *expectedHash, bool &saveDone);
@@ -395,4 +402,7 @@ class SavedataParam
 	// Cleared before returning to PSP, no need to save state.
 	std::mutex cacheLock_;
 	std::unordered_map<std::string, std::shared_ptr<ParamSFOData>> sfoCache_;
+	// Not cleared with the above, entries are checked against the directory and PARAM.SFO times instead.
+	std::unordered_map<std::string, std::shared_ptr<SavedataIndexEntry>> saveIndex_;
+	int saveIndexPass_ = 0;
 };
@@ -34,6 +34,7 @@
 #include "Core/Config.h"
 #include "Core/ConfigValues.h"
 #include "Core/Debugger/MemBlockInfo.h"
+#include "Core/Dialog/SavedataParam.h"
 #include "Core/ELF/ParamSFO.h"
 #include "Core/MemMapHelpers.h"
 #include "Core/System.h"
@@ -220,6 +221,8 @@ class FileNode : public KernelObject {
 		if (handle != -1)
 			pspFileSystem.CloseFile(handle);
 		pgd_close(pgdInfo);
+		if (openMode & FILEACCESS_WRITE)
+			SavedataParam::NotifyFileWritten(fullpath);
 	}
 	const char *GetName() override { return fullpath.c_str(); }
 	const char *GetTypeName() override { return GetStaticTypeName(); }
@@ -768,7 +771,7 @@ void __IoDoState(PointerWrap &p) {
 	}
 }
 
-void __IoShutdown() {
+void __IoStopManagerThread() {
 	ioManagerThreadEnabled = false;
 	ioManager.SyncThread();
 	ioManager.FinishEventLoop();
@@ -776,8 +779,13 @@ void __IoShutdown() {
 		ioManagerThread->join();
 		delete ioManagerThread;
 		ioManagerThread = nullptr;
-		ioManager.Shutdown();
 	}
+	ioManager.SetThreadEnabled(false);
+}
+
+void __IoShutdown() {
+	__IoStopManagerThread();
+	ioManager.Shutdown();
 
 	for (int i = 0; i < PSP_COUNT_FDS; ++i) {
 		asyncParams[i].op = IoAsyncOp::NONE;
@@ -23,6 +23,8 @@ class KernelObject;
 void __IoInit();
 void __IoDoState(PointerWrap &p);
 void __IoShutdown();
+// Joins the IO thread, async IO then runs synchronously. Needed before fork(), which won't copy the thread.
+void __IoStopManagerThread();
 
 struct ScePspDateTime;
 struct tm;
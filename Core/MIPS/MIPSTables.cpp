@@ -967,6 +967,122 @@ void MIPSInterpret(MIPSOpcode op) {
 #define _RD   ((op>>11) & 0x1F)
 #define R(i)   (curMips->r[i])
 
+// Pairs that RunUntilFast() runs as one step, with their operands decoded up front.
+enum class InterpretFusion : u8 {
+	NONE,
+	// lui followed by addiu or ori on the same register, both results are constants.
+	LUI_IMM,
+	// lw followed by addu.
+	LW_ADDU,
+};
+
+// Decoded instructions for RunUntilFast(), by pc. Entries are checked against the words in memory
+// on every use rather than invalidated, since the interpreter can't rely on games clearing the icache.
+struct InterpretCacheEntry {
+	// pc | 1, so that a zeroed entry never matches.
+	u32 tag;
+	u32 op;
+	// Only checked when fused.
+	u32 op2;
+	u16 cycles;
+	u16 cycles2;
+	InterpretFusion fusion;
+	u8 regs[5];
+	MIPSInterpretFunc interpret;
+	u32 imm[2];
+};
+
+static const u32 INTERPRET_CACHE_SIZE = 4096;
+static InterpretCacheEntry interpretCache[INTERPRET_CACHE_SIZE];
+
+static void DecodeInterpretFusion(InterpretCacheEntry &entry, MIPSOpcode op, const MIPSInstruction *instr, MIPSOpcode op2, const MIPSInstruction *instr2) {
+	int rt = _RT;
+	int rs = _RS;
+	int rt2 = (op2 >> 16) & 0x1F;
+	int rs2 = (op2 >> 21) & 0x1F;
+	int rd2 = (op2 >> 11) & 0x1F;
+
+	// Writes to $zr would have to be skipped, it's not worth it.
+	if (instr->interpret == &MIPSInt::Int_IType && (op >> 26) == 15 && rt != 0) {
+		if (instr2->interpret != &MIPSInt::Int_IType || rs2 != rt || rt2 == 0)
+			return;
+		u32 hi = (op & 0xFFFF) << 16;
+		if ((op2 >> 26) == 9)
+			entry.imm[1] = hi + SignExtend16ToU32(op2);
+		else if ((op2 >> 26) == 13)
+			entry.imm[1] = hi | (op2 & 0xFFFF);
+		else
+			return;
+		entry.fusion = InterpretFusion::LUI_IMM;
+		entry.regs[0] = rt;
+		entry.regs[1] = rt2;
+		entry.imm[0] = hi;
+	} else if (instr->interpret == &MIPSInt::Int_ITypeMem && (op >> 26) == 35 && rt != 0) {
+		if (instr2->interpret != &MIPSInt::Int_RType3 || (op2 & 63) != 33 || rd2 == 0)
+			return;
+		entry.fusion = InterpretFusion::LW_ADDU;
+		entry.regs[0] = rt;
+		entry.regs[1] = rs;
+		entry.regs[2] = rd2;
+		entry.regs[3] = rs2;
+		entry.regs[4] = rt2;
+		entry.imm[0] = SignExtend16ToU32(op);
+	}
+}
+
+static void DecodeInterpretEntry(InterpretCacheEntry &entry, u32 pc, MIPSOpcode op) {
+	const MIPSInstruction *instr = MIPSGetInstruction(op);
+	entry.fusion = InterpretFusion::NONE;
+	if (!instr || !instr->interpret) {
+		// Never cached, Interpret() reports these.
+		entry.tag = 0;
+		entry.interpret = nullptr;
+		return;
+	}
+
+	entry.tag = pc | 1;
+	entry.op = op.encoding;
+	entry.cycles = (u16)instr->flags.cycles;
+	entry.interpret = instr->interpret;
+
+	if (!Memory::IsValidAddress(pc + 4))
+		return;
+	MIPSOpcode op2 = MIPSOpcode(Memory::ReadUnchecked_U32(pc + 4));
+	const MIPSInstruction *instr2 = MIPSGetInstruction(op2);
+	if (instr2 && instr2->interpret) {
+		entry.op2 = op2.encoding;
+		entry.cycles2 = (u16)instr2->flags.cycles;
+		DecodeInterpretFusion(entry, op, instr, op2, instr2);
+	}
+}
+
+static inline void RunFused(MIPSState *curMips, const InterpretCacheEntry &entry) {
+	switch (entry.fusion) {
+	case InterpretFusion::LUI_IMM:
+		R(entry.regs[0]) = entry.imm[0];
+		R(entry.regs[1]) = entry.imm[1];
+		break;
+
+	case InterpretFusion::LW_ADDU:
+		R(entry.regs[0]) = Memory::Read_U32(R(entry.regs[1]) + entry.imm[0]);
+		if (coreState != CORE_RUNNING) {
+			// A bad access stops before the addu, as it would have unfused.
+			curMips->pc += 4;
+			curMips->downcount -= entry.cycles;
+			return;
+		}
+		R(entry.regs[2]) = R(entry.regs[3]) + R(entry.regs[4]);
+		break;
+
+	default:
+		break;
+	}
+	curMips->pc += 8;
+	curMips->downcount -= entry.cycles + entry.cycles2;
+}
+
+// Without the cache, this is the plain interpreter loop, kept as a reference for tests.
+template <bool useCache>
 static inline void RunUntilFast() {
 	MIPSState *curMips = currentMIPS;
 	// NEVER stop in a delay slot!
@@ -976,9 +1092,37 @@ static inline void RunUntilFast() {
 			MIPSOpcode op = MIPSOpcode(Memory::Read_U32(curMips->pc));
 
 			bool wasInDelaySlot = curMips->inDelaySlot;
-			const MIPSInstruction *instr = MIPSGetInstruction(op);
-			Interpret(instr, op);
-			curMips->downcount -= GetInstructionCycleEstimate(instr);
+			if (!useCache) {
+				const MIPSInstruction *instr = MIPSGetInstruction(op);
+				Interpret(instr, op);
+				curMips->downcount -= GetInstructionCycleEstimate(instr);
+				if (curMips->inDelaySlot && wasInDelaySlot) {
+					curMips->pc = curMips->nextPC;
+					curMips->inDelaySlot = false;
+				}
+				continue;
+			}
+
+			InterpretCacheEntry &entry = interpretCache[(curMips->pc >> 2) & (INTERPRET_CACHE_SIZE - 1)];
+			if (entry.tag != (curMips->pc | 1) || entry.op != op.encoding)
+				DecodeInterpretEntry(entry, curMips->pc, op);
+
+			if (entry.interpret) {
+				// Only fuse if the first one wouldn't have ended the slice, and never in a delay slot.
+				if (entry.fusion != InterpretFusion::NONE && !wasInDelaySlot && curMips->downcount >= entry.cycles && Memory::ReadUnchecked_U32(curMips->pc + 4) == entry.op2) {
+					RunFused(curMips, entry);
+					continue;
+				}
+
+				// Copied first, the entry could be reused by the time it returns.
+				int cycles = entry.cycles;
+				entry.interpret(op);
+				curMips->downcount -= cycles;
+			} else {
+				const MIPSInstruction *instr = MIPSGetInstruction(op);
+				Interpret(instr, op);
+				curMips->downcount -= GetInstructionCycleEstimate(instr);
+			}
 
 			// The reason we have to check this is the delay slot hack in Int_Syscall.
 			if (curMips->inDelaySlot && wasInDelaySlot) {
@@ -1051,7 +1195,7 @@ int MIPSInterpret_RunUntil(u64 globalTicks) {
 		if (CBreakPoints::HasBreakPoints() || CBreakPoints::HasMemChecks() || ticksLeft <= curMips->downcount)
 			RunUntilWithChecks(globalTicks);
 		else
-			RunUntilFast();
+			RunUntilFast<true>();
 
 		if (CoreTiming::GetTicks() > globalTicks) {
 			// DEBUG_LOG(CPU, "Hit the max ticks, bailing 1 : %llu, %llu", globalTicks, CoreTiming::GetTicks());
@@ -1062,6 +1206,13 @@ int MIPSInterpret_RunUntil(u64 globalTicks) {
 	return 1;
 }
 
+void MIPSInterpret_RunSliceForTest(bool useCache) {
+	if (useCache)
+		RunUntilFast<true>();
+	else
+		RunUntilFast<false>();
+}
+
 const char *MIPSGetName(MIPSOpcode op)
 {
 	static const char *noname = "unk";
@@ -129,6 +129,9 @@ void MIPSDisAsm(MIPSOpcode op, u32 pc, char *out, size_t outSize, bool tabsToSpa
 MIPSInfo MIPSGetInfo(MIPSOpcode op);
 void MIPSInterpret(MIPSOpcode op); //only for those rare ones
 int MIPSInterpret_RunUntil(u64 globalTicks);
+// Runs until downcount runs out or coreState changes, with or without the decoded instruction cache
+// (and its fused pairs.) Only for tests comparing the two.
+void MIPSInterpret_RunSliceForTest(bool useCache);
 MIPSInterpretFunc MIPSGetInterpretFunc(MIPSOpcode op);
 
 int MIPSGetInstructionCycleEstimate(MIPSOpcode op);
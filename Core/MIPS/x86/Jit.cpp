@@ -309,6 +309,8 @@ void Jit::Compile(u32 em_address) {
 		return;
 	}
 
+	// Linking below patches exits of other blocks, so protect them all in one go afterward.
+	BeginWriteBatch();
 	// Sometimes we compile fairly large blocks, although it's uncommon.
 	BeginWrite(JitBlockCache::MAX_BLOCK_INSTRUCTIONS * 16);
 
@@ -318,6 +320,7 @@ void Jit::Compile(u32 em_address) {
 	blocks.FinalizeBlock(block_num, jo.enableBlocklink);
 
 	EndWrite();
+	EndWriteBatch();
 
 	bool cleanSlate = false;
 
@@ -515,9 +518,7 @@ void Jit::Comp_RunBlock(MIPSOpcode op) {
 }
 
 void Jit::LinkBlock(u8 *exitPoint, const u8 *checkedEntry) {
-	if (PlatformIsWXExclusive()) {
-		ProtectMemoryPages(exitPoint, 32, MEM_PROT_READ | MEM_PROT_WRITE);
-	}
+	BeginPatch(exitPoint, 32);
 	XEmitter emit(exitPoint);
 	// Okay, this is a bit ugly, but we check here if it already has a JMP.
 	// That means it doesn't have a full exit to pad with INT 3.
@@ -530,24 +531,18 @@ void Jit::LinkBlock(u8 *exitPoint, const u8 *checkedEntry) {
 			emit.INT3();
 		}
 	}
-	if (PlatformIsWXExclusive()) {
-		ProtectMemoryPages(exitPoint, 32, MEM_PROT_READ | MEM_PROT_EXEC);
-	}
+	EndPatch(exitPoint, 32);
 }
 
 void Jit::UnlinkBlock(u8 *checkedEntry, u32 originalAddress) {
-	if (PlatformIsWXExclusive()) {
-		ProtectMemoryPages(checkedEntry, 16, MEM_PROT_READ | MEM_PROT_WRITE);
-	}
+	BeginPatch(checkedEntry, 16);
 	// Send anyone who tries to run this block back to the dispatcher.
 	// Not entirely ideal, but .. pretty good.
 	// Spurious entrances from previously linked blocks can only come through checkedEntry
 	XEmitter emit(checkedEntry);
 	emit.MOV(32, MIPSSTATE_VAR(pc), Imm32(originalAddress));
 	emit.JMP(MIPSComp::jit->GetDispatcher(), true);
-	if (PlatformIsWXExclusive()) {
-		ProtectMemoryPages(checkedEntry, 16, MEM_PROT_READ | MEM_PROT_EXEC);
-	}
+	EndPatch(checkedEntry, 16);
 }
 
 bool Jit::ReplaceJalTo(u32 dest) {
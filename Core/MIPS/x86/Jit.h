@@ -168,7 +168,10 @@ class Jit : public Gen::XCodeBlock, public JitInterface, public MIPSFrontendInte
 	void ClearCache() override;
 	void InvalidateCacheAt(u32 em_address, int length = 4) override {
 		if (blocks.RangeMayHaveEmuHacks(em_address, em_address + length)) {
+			// This may unlink many blocks, so protect them all at once afterward.
+			BeginWriteBatch();
 			blocks.InvalidateICache(em_address, length);
+			EndWriteBatch();
 		}
 	}
 	void UpdateFCR31() override;
@@ -185,9 +185,7 @@ void X64JitBackend::OverwriteExit(int srcOffset, int len, int block_num) {
 	const IRNativeBlock *nativeBlock = GetNativeBlock(block_num);
 	if (nativeBlock) {
 		u8 *writable = GetWritablePtrFromCodePtr(GetBasePtr()) + srcOffset;
-		if (PlatformIsWXExclusive()) {
-			ProtectMemoryPages(writable, len, MEM_PROT_READ | MEM_PROT_WRITE);
-		}
+		BeginPatch(writable, len);
 
 		XEmitter emitter(writable);
 		emitter.JMP(GetBasePtr() + nativeBlock->checkedOffset, true);
@@ -195,9 +193,7 @@ void X64JitBackend::OverwriteExit(int srcOffset, int len, int block_num) {
 		if (bytesWritten < len)
 			emitter.ReserveCodeSpace(len - bytesWritten);
 
-		if (PlatformIsWXExclusive()) {
-			ProtectMemoryPages(writable, 16, MEM_PROT_READ | MEM_PROT_EXEC);
-		}
+		EndPatch(writable, len);
 	}
 }
 
@@ -274,9 +270,7 @@ void X64JitBackend::InvalidateBlock(IRBlock *block, int block_num) {
 	u32 pc = block->GetOriginalStart();
 	if (pc != 0) {
 		// Hopefully we always have at least 16 bytes, which should be all we need.
-		if (PlatformIsWXExclusive()) {
-			ProtectMemoryPages(writable, MIN_BLOCK_NORMAL_LEN, MEM_PROT_READ | MEM_PROT_WRITE);
-		}
+		BeginPatch(writable, MIN_BLOCK_NORMAL_LEN);
 
 		XEmitter emitter(writable);
 		emitter.MOV(32, R(SCRATCH1), Imm32(pc));
@@ -285,9 +279,7 @@ void X64JitBackend::InvalidateBlock(IRBlock *block, int block_num) {
 		if (bytesWritten < MIN_BLOCK_NORMAL_LEN)
 			emitter.ReserveCodeSpace(MIN_BLOCK_NORMAL_LEN - bytesWritten);
 
-		if (PlatformIsWXExclusive()) {
-			ProtectMemoryPages(writable, MIN_BLOCK_NORMAL_LEN, MEM_PROT_READ | MEM_PROT_EXEC);
-		}
+		EndPatch(writable, MIN_BLOCK_NORMAL_LEN);
 	}
 
 	EraseAllLinks(block_num);
@@ -201,6 +201,9 @@ bool MemoryMap_Setup(u32 flags) {
 	base = (u8*)VirtualAllocFromApp(0, 0x10000000, MEM_RESERVE, PAGE_READWRITE);
 #else
 
+	// Needs to be decided before roundup() is used for the layout.
+	g_arena.SetHugePages(g_Config.bMemoryHugePages);
+
 	// Figure out how much memory we need to allocate in total.
 	size_t total_mem = 0;
 	for (int i = 0; i < num_views; i++) {
@@ -291,6 +294,38 @@ void MemoryMap_Shutdown(u32 flags) {
 #endif
 }
 
+bool MemoryMap_Unshare(u32 flags) {
+	if (!g_arena.Unshare()) {
+		ERROR_LOG(MEMMAP, "MemoryMap_Unshare: Not supported on this platform.");
+		return false;
+	}
+
+	size_t position = 0;
+	size_t last_position = 0;
+
+	for (int i = 0; i < num_views; i++) {
+		if (views[i].size == 0)
+			continue;
+		SKIP(flags, views[i].flags);
+
+		if (views[i].flags & MV_MIRROR_PREVIOUS) {
+			position = last_position;
+		}
+
+		// Mapping over the old view replaces it, so pointers into memory stay valid.
+		if (*views[i].out_ptr && !CanIgnoreView(views[i])) {
+			if (g_arena.CreateView(position, views[i].size, *views[i].out_ptr) != *views[i].out_ptr) {
+				ERROR_LOG(MEMMAP, "MemoryMap_Unshare: Failed to remap view %d", i);
+				return false;
+			}
+		}
+
+		last_position = position;
+		position += g_arena.roundup(views[i].size);
+	}
+	return true;
+}
+
 bool Init() {
 	// On some 32 bit platforms (like Android, iOS, etc.), you can only map < 32 megs at a time.
 	const static int MAX_MMAP_SIZE = 31 * 1024 * 1024;
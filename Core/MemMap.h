@@ -107,6 +107,8 @@ struct MemoryView
 // Uses a memory arena to set up an emulator-friendly memory map
 bool MemoryMap_Setup(u32 flags);
 void MemoryMap_Shutdown(u32 flags);
+// In a child process after fork(), stops sharing memory with the parent. Views keep their addresses.
+bool MemoryMap_Unshare(u32 flags);
 
 // Init and Shutdown
 bool Init();
@@ -16,6 +16,8 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 #include "ext/xxhash.h"
 
@@ -30,6 +32,7 @@
 #include "Common/Serialize/Serializer.h"
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Core/Config.h"
 #include "Common/BitScan.h"
 #include "Core/HDRemaster.h"
@@ -1305,6 +1308,65 @@ void PPGeDisableTexture()
 
 std::vector<PPGeImage *> PPGeImage::loadedTextures_;
 
+// Shared with the task, so the image doesn't have to outlive it.
+struct PPGeImagePrefetch {
+	~PPGeImagePrefetch() {
+		free(pixels);
+	}
+
+	std::mutex lock;
+	std::condition_variable cond;
+	bool done = false;
+	bool cancelled = false;
+	bool readFailed = false;
+	unsigned char *pixels = nullptr;
+	int width = 0;
+	int height = 0;
+};
+
+class PPGeImagePrefetchTask : public Task {
+public:
+	PPGeImagePrefetchTask(const std::string &filename, const std::shared_ptr<PPGeImagePrefetch> &state)
+		: filename_(filename), state_(state) {}
+
+	TaskType Type() const override { return TaskType::IO_BLOCKING; }
+	TaskPriority Priority() const override { return TaskPriority::NORMAL; }
+
+	void Run() override {
+		bool cancelled;
+		{
+			std::lock_guard<std::mutex> guard(state_->lock);
+			cancelled = state_->cancelled;
+		}
+
+		bool readFailed = false;
+		unsigned char *pixels = nullptr;
+		int width = 0;
+		int height = 0;
+		if (!cancelled) {
+			std::vector<u8> pngData;
+			if (pspFileSystem.ReadEntireFile(filename_, pngData) < 0) {
+				readFailed = true;
+			} else if (pngLoadPtr((const unsigned char *)&pngData[0], pngData.size(), &width, &height, &pixels) != 1) {
+				free(pixels);
+				pixels = nullptr;
+			}
+		}
+
+		std::lock_guard<std::mutex> guard(state_->lock);
+		state_->readFailed = readFailed;
+		state_->pixels = pixels;
+		state_->width = width;
+		state_->height = height;
+		state_->done = true;
+		state_->cond.notify_all();
+	}
+
+private:
+	std::string filename_;
+	std::shared_ptr<PPGeImagePrefetch> state_;
+};
+
 PPGeImage::PPGeImage(const std::string &pspFilename)
 	: filename_(pspFilename) {
 }
@@ -1314,9 +1376,30 @@ PPGeImage::PPGeImage(u32 pngPointer, size_t pngSize)
 }
 
 PPGeImage::~PPGeImage() {
+	CancelPrefetch();
 	Free();
 }
 
+void PPGeImage::Prefetch() {
+	if (filename_.empty() || texture_ != 0 || loadFailed_ || prefetch_ || !g_threadManager.IsInitialized())
+		return;
+
+	prefetch_ = std::make_shared<PPGeImagePrefetch>();
+	g_threadManager.EnqueueTask(new PPGeImagePrefetchTask(filename_, prefetch_));
+}
+
+void PPGeImage::CancelPrefetch() {
+	if (!prefetch_)
+		return;
+
+	// Wait even if it's just starting, it may be using pspFileSystem which might be about to shut down.
+	std::unique_lock<std::mutex> guard(prefetch_->lock);
+	prefetch_->cancelled = true;
+	prefetch_->cond.wait(guard, [&] { return prefetch_->done; });
+	guard.unlock();
+	prefetch_.reset();
+}
+
 bool PPGeImage::Load() {
 	loadFailed_ = false;
 	Free();
@@ -1325,10 +1408,26 @@ bool PPGeImage::Load() {
 	width_ = 0;
 	height_ = 0;
 
-	unsigned char *textureData;
+	unsigned char *textureData = nullptr;
 	int success;
 	if (filename_.empty()) {
 		success = pngLoadPtr(Memory::GetPointerRange(png_, (u32)size_), size_, &width_, &height_, &textureData);
+	} else if (prefetch_) {
+		// Always wait, so the image shows up on the same frame as it would without prefetching.
+		std::shared_ptr<PPGeImagePrefetch> prefetch = std::move(prefetch_);
+		std::unique_lock<std::mutex> guard(prefetch->lock);
+		prefetch->cond.wait(guard, [&] { return prefetch->done; });
+		if (prefetch->readFailed) {
+			WARN_LOG(SCEGE, "PPGeImage cannot load file %s", filename_.c_str());
+			loadFailed_ = true;
+			return false;
+		}
+
+		success = prefetch->pixels != nullptr;
+		textureData = prefetch->pixels;
+		prefetch->pixels = nullptr;
+		width_ = prefetch->width;
+		height_ = prefetch->height;
 	} else {
 		std::vector<u8> pngData;
 		if (pspFileSystem.ReadEntireFile(filename_, pngData) < 0) {
@@ -1389,6 +1488,14 @@ void PPGeImage::DoState(PointerWrap &p) {
 	if (!s)
 		return;
 
+	if (p.mode == PointerWrap::MODE_READ) {
+		CancelPrefetch();
+	} else if (prefetch_) {
+		// The task may have a file open in pspFileSystem, which is saved after this. Keep the result.
+		std::unique_lock<std::mutex> guard(prefetch_->lock);
+		prefetch_->cond.wait(guard, [&] { return prefetch_->done; });
+	}
+
 	Do(p, filename_);
 	Do(p, png_);
 	Do(p, size_);
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -25,6 +26,7 @@
 #include "Common/Common.h"
 
 class PointerWrap;
+struct PPGeImagePrefetch;
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 // PPGeDraw: Super simple internal drawing API for 2D overlays like sceUtility messageboxes
@@ -121,6 +123,8 @@ class PPGeImage {
 
 	// Does not normally need to be called (except to force preloading.)
 	bool Load();
+	// Starts reading and decoding the file on a worker thread. Load() waits for it if still busy.
+	void Prefetch();
 	void Free();
 	bool IsValid();
 
@@ -140,6 +144,8 @@ class PPGeImage {
 	static void Decimate(int age = 30);
 
 private:
+	void CancelPrefetch();
+
 	static std::vector<PPGeImage *> loadedTextures_;
 
 	std::string filename_;
@@ -154,6 +160,7 @@ class PPGeImage {
 
 	int lastFrame_;
 	bool loadFailed_ = false;
+	std::shared_ptr<PPGeImagePrefetch> prefetch_;
 };
 
 void PPGeDrawRect(float x1, float y1, float x2, float y2, u32 color);
@@ -489,6 +489,15 @@ VirtualFramebuffer *FramebufferManagerCommon::DoSetRenderFrameBuffer(Framebuffer
 			vfb->lastFrameNewSize = gpuStats.numFlips;
 		}
 
+		if (!resized && vfb->budgetDownscaled) {
+			// It was downscaled to save memory while unused, and now it's back in use.
+			vfb->budgetDownscaled = false;
+			if (renderScaleFactor_ != 1) {
+				ResizeFramebufFBO(vfb, vfb->bufferWidth, vfb->bufferHeight, true);
+				resized = true;
+			}
+		}
+
 		if (!resized && renderScaleFactor_ != 1 && vfb->renderScaleFactor == 1) {
 			// Might be time to change this framebuffer - have we used depth?
 			if ((vfb->usageFlags & FB_USAGE_COLOR_MIXED_DEPTH) && !PSP_CoreParameter().compat.flags().ForceLowerResolutionForEffectsOn) {
@@ -1695,6 +1704,8 @@ void FramebufferManagerCommon::DecimateFBOs() {
 		}
 	}
 
+	EnforceFramebufferBudget();
+
 	// And DrawPixels cached textures.
 
 	for (auto it = drawPixelsCache_.begin(); it != drawPixelsCache_.end(); ) {
@@ -1710,6 +1721,106 @@ void FramebufferManagerCommon::DecimateFBOs() {
 	}
 }
 
+// We can't ask the driver, so this is an estimate. Color and depth/stencil are counted as 32 bits per pixel
+// each, and multisampled framebuffers also have a single sampled color resolve target.
+static size_t EstimateFramebufferBytes(Draw::Framebuffer *fbo, bool zStencil) {
+	if (!fbo) {
+		return 0;
+	}
+	size_t pixels = (size_t)fbo->Width() * fbo->Height() * std::max(1, fbo->Layers());
+	size_t samples = (size_t)1 << fbo->MultiSampleLevel();
+	size_t bytes = pixels * samples * (zStencil ? 8 : 4);
+	if (samples > 1) {
+		bytes += pixels * 4;
+	}
+	return bytes;
+}
+
+size_t FramebufferManagerCommon::ComputeFramebufferMemory() const {
+	size_t total = 0;
+	for (const VirtualFramebuffer *vfb : vfbs_) {
+		total += EstimateFramebufferBytes(vfb->fbo, true);
+	}
+	// Download framebuffers are color only.
+	for (const VirtualFramebuffer *vfb : bvfbs_) {
+		total += EstimateFramebufferBytes(vfb->fbo, false);
+	}
+	for (const auto &iter : tempFBOs_) {
+		total += EstimateFramebufferBytes(iter.second.fbo, (TempFBO)(iter.first >> 48) == TempFBO::STENCIL);
+	}
+	return total;
+}
+
+// Aging alone can keep a lot of framebuffers around at high render resolutions. When over the configured budget,
+// first drop temp FBOs, then downscale framebuffers that haven't been used for a bit to 1x (keeping their contents),
+// and only as a last resort destroy them.
+void FramebufferManagerCommon::EnforceFramebufferBudget() {
+	framebufferMemory_ = ComputeFramebufferMemory();
+	const size_t budget = (size_t)std::max(0, g_Config.iFramebufferMemoryBudgetMB) * 1024 * 1024;
+	if (budget == 0 || framebufferMemory_ <= budget) {
+		return;
+	}
+
+	for (auto it = tempFBOs_.begin(); it != tempFBOs_.end() && framebufferMemory_ > budget; ) {
+		int age = frameLastFramebufUsed_ - it->second.last_frame_used;
+		if (age > 0) {
+			framebufferMemory_ -= EstimateFramebufferBytes(it->second.fbo, (TempFBO)(it->first >> 48) == TempFBO::STENCIL);
+			it->second.fbo->Release();
+			it = tempFBOs_.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto vfbAge = [&](const VirtualFramebuffer *vfb) {
+		return frameLastFramebufUsed_ - std::max(vfb->last_frame_render, vfb->last_frame_used);
+	};
+
+	std::vector<VirtualFramebuffer *> candidates;
+	for (VirtualFramebuffer *vfb : vfbs_) {
+		if (vfb->fbo && vfb != displayFramebuf_ && vfb != prevDisplayFramebuf_ && vfb != prevPrevDisplayFramebuf_ && vfbAge(vfb) >= FBO_BUDGET_DOWNSCALE_AGE) {
+			candidates.push_back(vfb);
+		}
+	}
+	// Oldest first.
+	std::sort(candidates.begin(), candidates.end(), [&](const VirtualFramebuffer *a, const VirtualFramebuffer *b) {
+		return vfbAge(a) > vfbAge(b);
+	});
+
+	int downscaled = 0;
+	for (VirtualFramebuffer *vfb : candidates) {
+		if (framebufferMemory_ <= budget)
+			break;
+		if (vfb->renderScaleFactor <= 1)
+			continue;
+		size_t before = EstimateFramebufferBytes(vfb->fbo, true);
+		vfb->budgetDownscaled = true;
+		ResizeFramebufFBO(vfb, vfb->bufferWidth, vfb->bufferHeight, true);
+		framebufferMemory_ = framebufferMemory_ - before + EstimateFramebufferBytes(vfb->fbo, true);
+		downscaled++;
+	}
+
+	int destroyed = 0;
+	for (VirtualFramebuffer *vfb : candidates) {
+		if (framebufferMemory_ <= budget)
+			break;
+		if (vfbAge(vfb) < FBO_BUDGET_DESTROY_AGE)
+			continue;
+		INFO_LOG(FRAMEBUF, "Over framebuffer budget, decimating FBO for %08x (%dx%d %s)", vfb->fb_address, vfb->width, vfb->height, GeBufferFormatToString(vfb->fb_format));
+		framebufferMemory_ -= EstimateFramebufferBytes(vfb->fbo, true);
+		vfbs_.erase(std::find(vfbs_.begin(), vfbs_.end(), vfb));
+		DestroyFramebuf(vfb);
+		destroyed++;
+	}
+
+	if (downscaled || destroyed) {
+		DEBUG_LOG(FRAMEBUF, "Framebuffer budget: downscaled %d, destroyed %d, now at %d MB", downscaled, destroyed, (int)(framebufferMemory_ >> 20));
+		// ResizeFramebufFBO binds the framebuffer.
+		currentRenderVfb_ = nullptr;
+		gstate_c.Dirty(DIRTY_ALL_RENDER_STATE);
+	}
+}
+
 // Requires width/height to be set already.
 void FramebufferManagerCommon::ResizeFramebufFBO(VirtualFramebuffer *vfb, int w, int h, bool force, bool skipCopy) {
 	_dbg_assert_(w > 0);
@@ -1751,6 +1862,9 @@ void FramebufferManagerCommon::ResizeFramebufFBO(VirtualFramebuffer *vfb, int w,
 	if (PSP_CoreParameter().compat.flags().Force04154000Download && vfb->fb_address == 0x04154000) {
 		force1x = true;
 	}
+	if (vfb->budgetDownscaled) {
+		force1x = true;
+	}
 
 	if (force1x && g_Config.iInternalResolution != 1) {
 		vfb->renderScaleFactor = 1;
@@ -2656,6 +2770,10 @@ static const char *TempFBOReasonToString(TempFBO reason) {
 }
 
 Draw::Framebuffer *FramebufferManagerCommon::GetTempFBO(TempFBO reason, u16 w, u16 h) {
+	// BLIT and Z_COPY are only alive for the duration of a single copy or readback, so they can share.
+	if (reason == TempFBO::Z_COPY) {
+		reason = TempFBO::BLIT;
+	}
 	u64 key = ((u64)reason << 48) | ((u32)w << 16) | h;
 	auto it = tempFBOs_.find(key);
 	if (it != tempFBOs_.end()) {
@@ -128,6 +128,9 @@ struct VirtualFramebuffer {
 	// Means that the whole image has already been read back to memory - used when combining small readbacks (gameUsesSequentialCopies_).
 	bool memoryUpdated;
 
+	// Dropped to 1x render scale to stay within the framebuffer memory budget. Scaled back up when rendered to again.
+	bool budgetDownscaled;
+
 	// TODO: Fold into usageFlags?
 	bool dirtyAfterDisplay;
 	bool reallyDirtyAfterDisplay;  // takes frame skipping into account
@@ -354,6 +357,8 @@ class FramebufferManagerCommon {
 	void DrawPixels(VirtualFramebuffer *vfb, int dstX, int dstY, const u8 *srcPixels, GEBufferFormat srcPixelFormat, int srcStride, int width, int height, RasterChannel channel, const char *tag);
 
 	size_t NumVFBs() const { return vfbs_.size(); }
+	// Estimated, as of the last DecimateFBOs.
+	size_t FramebufferMemoryBytes() const { return framebufferMemory_; }
 
 	u32 PrevDisplayFramebufAddr() const {
 		return prevDisplayFramebuf_ ? prevDisplayFramebuf_->fb_address : 0;
@@ -494,6 +499,8 @@ class FramebufferManagerCommon {
 
 	void FlushBeforeCopy();
 	virtual void DecimateFBOs();  // keeping it virtual to let D3D do a little extra
+	void EnforceFramebufferBudget();
+	size_t ComputeFramebufferMemory() const;
 
 	// Used by ReadFramebufferToMemory and later framebuffer block copies
 	void BlitFramebuffer(VirtualFramebuffer *dst, int dstX, int dstY, VirtualFramebuffer *src, int srcX, int srcY, int w, int h, int bpp, RasterChannel channel, const char *tag);
@@ -599,12 +606,17 @@ class FramebufferManagerCommon {
 
 	std::unordered_map<u64, TempFBOInfo> tempFBOs_;
 
+	size_t framebufferMemory_ = 0;
+
 	std::vector<Draw::Framebuffer *> fbosToDelete_;
 
 	// Aggressively delete unused FBOs to save gpu memory.
 	enum {
 		FBO_OLD_AGE = 5,
 		FBO_OLD_USAGE_FLAG = 15,
+		// When over the memory budget. Not too young, or we'd just be resizing back and forth.
+		FBO_BUDGET_DOWNSCALE_AGE = 2,
+		FBO_BUDGET_DESTROY_AGE = 3,
 	};
 
 	// Thin3D stuff for reinterpreting image data between the various 16-bit color formats.
@@ -47,6 +47,9 @@ struct ShaderInfo {
 	bool requires60fps;
 	// Takes previous frame as input (for blending effects.)
 	bool usePreviousFrame;
+	// Only samples sampler0 at v_texcoord0 and doesn't otherwise use the position, so it can be fused into
+	// the previous pass (where v_texcoord0 may be the source rect rather than 0..1).
+	bool perPixel;
 
 	struct Setting {
 		std::string name;
@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include <set>
+#include <sstream>
 #include <cstdint>
 #include <algorithm>
 
@@ -28,6 +29,7 @@
 #include "Common/File/VFS/VFS.h"
 #include "Common/VR/PPSSPPVR.h"
 #include "Common/Log.h"
+#include "Common/StringUtils.h"
 #include "Common/TimeUtil.h"
 #include "Core/Config.h"
 #include "Core/ConfigValues.h"
@@ -201,7 +203,7 @@ static float GetShaderSettingValue(const ShaderInfo *shaderInfo, int i, const ch
 	return shaderInfo->settings[i].value;
 }
 
-void PresentationCommon::CalculatePostShaderUniforms(int bufferWidth, int bufferHeight, int targetWidth, int targetHeight, const ShaderInfo *shaderInfo, PostShaderUniforms *uniforms) const {
+void PresentationCommon::CalculatePostShaderUniforms(int bufferWidth, int bufferHeight, int targetWidth, int targetHeight, const ShaderInfo *shaderInfo, PostShaderUniforms *uniforms, const std::vector<ShaderInfo> *fused) const {
 	float u_delta = 1.0f / bufferWidth;
 	float v_delta = 1.0f / bufferHeight;
 	float u_pixel_delta = 1.0f / targetWidth;
@@ -229,6 +231,16 @@ void PresentationCommon::CalculatePostShaderUniforms(int bufferWidth, int buffer
 	uniforms->setting[1] = GetShaderSettingValue(shaderInfo, 1, "SettingCurrentValue2");
 	uniforms->setting[2] = GetShaderSettingValue(shaderInfo, 2, "SettingCurrentValue3");
 	uniforms->setting[3] = GetShaderSettingValue(shaderInfo, 3, "SettingCurrentValue4");
+
+	memset(uniforms->fusedSetting, 0, sizeof(uniforms->fusedSetting));
+	if (fused) {
+		for (size_t i = 0; i < fused->size() && i < ARRAY_SIZE(uniforms->fusedSetting); ++i) {
+			uniforms->fusedSetting[i][0] = GetShaderSettingValue(&(*fused)[i], 0, "SettingCurrentValue1");
+			uniforms->fusedSetting[i][1] = GetShaderSettingValue(&(*fused)[i], 1, "SettingCurrentValue2");
+			uniforms->fusedSetting[i][2] = GetShaderSettingValue(&(*fused)[i], 2, "SettingCurrentValue3");
+			uniforms->fusedSetting[i][3] = GetShaderSettingValue(&(*fused)[i], 3, "SettingCurrentValue4");
+		}
+	}
 }
 
 static std::string ReadShaderSrc(const Path &filename) {
@@ -243,6 +255,123 @@ static std::string ReadShaderSrc(const Path &filename) {
 	return src;
 }
 
+// A fused pass has room for u_setting and u_setting1-3.
+static const size_t MAX_FUSED_POST_SHADERS = 4;
+
+// b can run in the same pass as a if it only reads its input at its own pixel and ignores where that pixel is
+// (PerPixel in the ini), and nothing about the intermediate framebuffer between them matters.
+static bool CanFusePostShaders(const ShaderInfo *a, const ShaderInfo *b) {
+	if (!b->perPixel || b->isUpscalingFilter || b->SSAAFilterLevel >= 2)
+		return false;
+	if (a->usePreviousFrame || b->usePreviousFrame || a->isStereo || b->isStereo)
+		return false;
+	return a->outputResolution == b->outputResolution && a->vertexShaderFile == b->vertexShaderFile;
+}
+
+static bool IsIdentifierChar(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Replaces whole-word occurrences of ident.
+static std::string ReplaceIdentifier(const std::string &src, const std::string &ident, const std::string &replacement) {
+	std::string out;
+	out.reserve(src.size());
+	size_t pos = 0;
+	while (true) {
+		size_t found = src.find(ident, pos);
+		if (found == std::string::npos)
+			break;
+		size_t end = found + ident.size();
+		bool wordStart = found == 0 || !IsIdentifierChar(src[found - 1]);
+		bool wordEnd = end == src.size() || !IsIdentifierChar(src[end]);
+		out.append(src, pos, found - pos);
+		out += wordStart && wordEnd ? replacement : ident;
+		pos = end;
+	}
+	out.append(src, pos, std::string::npos);
+	return out;
+}
+
+// Replaces every texture2D(sampler0, ...) call with the color the previous stage produced.
+// Fails if the shader reads any other texture, since those can't be fused.
+static bool ReplaceInputReads(std::string *src, const std::string &replacement) {
+	static const std::string needle = "texture2D";
+	size_t pos = 0;
+	while ((pos = src->find(needle, pos)) != std::string::npos) {
+		if (pos > 0 && IsIdentifierChar((*src)[pos - 1])) {
+			pos += needle.size();
+			continue;
+		}
+		size_t open = src->find_first_not_of(" \t", pos + needle.size());
+		if (open == std::string::npos || (*src)[open] != '(')
+			return false;
+		size_t arg = src->find_first_not_of(" \t", open + 1);
+		if (arg == std::string::npos || src->compare(arg, 8, "sampler0") != 0 || IsIdentifierChar((*src)[arg + 8]))
+			return false;
+		int depth = 0;
+		size_t close = open;
+		for (; close < src->size(); ++close) {
+			if ((*src)[close] == '(') {
+				depth++;
+			} else if ((*src)[close] == ')' && --depth == 0) {
+				break;
+			}
+		}
+		if (close >= src->size())
+			return false;
+		src->replace(pos, close + 1 - pos, replacement);
+		pos += replacement.size();
+	}
+	return true;
+}
+
+// Chains several per-pixel fragment shaders into one. Each stage's main() becomes a function writing to
+// its own color variable, and later stages read the previous stage's color instead of sampler0.
+static std::string GenerateFusedPostShader(const std::vector<std::string> &fragmentSources) {
+	std::string out =
+		"#ifdef GL_ES\n"
+		"precision mediump float;\n"
+		"precision mediump int;\n"
+		"#endif\n";
+	for (size_t i = 0; i < fragmentSources.size(); ++i) {
+		out += StringFromFormat("vec4 fused_color_%d;\n", (int)i);
+	}
+
+	std::set<std::string> declarations;
+	for (size_t i = 0; i < fragmentSources.size(); ++i) {
+		std::string src = fragmentSources[i];
+		if (i > 0) {
+			if (!ReplaceInputReads(&src, StringFromFormat("fused_color_%d", (int)i - 1)))
+				return "";
+			src = ReplaceIdentifier(src, "u_setting", StringFromFormat("u_setting%d", (int)i));
+		}
+		src = ReplaceIdentifier(src, "gl_FragColor", StringFromFormat("fused_color_%d", (int)i));
+		src = ReplaceIdentifier(src, "main", StringFromFormat("fused_main_%d", (int)i));
+
+		// Shared uniforms and varyings can only be declared once.
+		std::string line;
+		std::stringstream instream(src);
+		while (std::getline(instream, line)) {
+			std::string trimmed = StripSpaces(line);
+			if (startsWith(trimmed, "uniform ") || startsWith(trimmed, "varying ")) {
+				if (!declarations.insert(trimmed).second)
+					continue;
+				line = trimmed;
+			}
+			out += line;
+			out += "\n";
+		}
+	}
+
+	out += "void main() {\n";
+	for (size_t i = 0; i < fragmentSources.size(); ++i) {
+		out += StringFromFormat("  fused_main_%d();\n", (int)i);
+	}
+	out += StringFromFormat("  gl_FragColor = fused_color_%d;\n", (int)fragmentSources.size() - 1);
+	out += "}\n";
+	return out;
+}
+
 // Note: called on resize and settings changes.
 // Also takes care of making sure the appropriate stereo shader is compiled.
 bool PresentationCommon::UpdatePostShader() {
@@ -274,20 +403,43 @@ bool PresentationCommon::UpdatePostShader() {
 
 	bool usePreviousFrame = false;
 	bool usePreviousAtOutputResolution = false;
-	for (size_t i = 0; i < shaderInfo.size(); ++i) {
-		const ShaderInfo *next = i + 1 < shaderInfo.size() ? shaderInfo[i + 1] : nullptr;
+	for (size_t i = 0; i < shaderInfo.size(); ) {
+		// Run any following per-pixel shaders in the same pass, saving a full screen round trip each.
+		size_t count = 1;
+		while (i + count < shaderInfo.size() && count < MAX_FUSED_POST_SHADERS && CanFusePostShaders(shaderInfo[i + count - 1], shaderInfo[i + count])) {
+			count++;
+		}
+
+		std::vector<ShaderInfo> fused;
+		for (size_t j = 1; j < count; ++j) {
+			fused.push_back(*shaderInfo[i + j]);
+		}
+
 		Draw::Pipeline *postPipeline = nullptr;
-		if (!BuildPostShader(shaderInfo[i], next, &postPipeline)) {
-			DestroyPostShader();
-			return false;
+		if (count > 1) {
+			const ShaderInfo *next = i + count < shaderInfo.size() ? shaderInfo[i + count] : nullptr;
+			if (!BuildPostShader(shaderInfo[i], next, fused, &postPipeline)) {
+				WARN_LOG(FRAMEBUF, "Failed to fuse %d post shaders starting at %s, running them separately", (int)count, shaderInfo[i]->section.c_str());
+				count = 1;
+				fused.clear();
+			}
+		}
+		if (count == 1) {
+			const ShaderInfo *next = i + 1 < shaderInfo.size() ? shaderInfo[i + 1] : nullptr;
+			if (!BuildPostShader(shaderInfo[i], next, fused, &postPipeline)) {
+				DestroyPostShader();
+				return false;
+			}
 		}
 		_dbg_assert_(postPipeline);
 		postShaderPipelines_.push_back(postPipeline);
 		postShaderInfo_.push_back(*shaderInfo[i]);
+		postShaderFusedInfo_.push_back(fused);
 		if (shaderInfo[i]->usePreviousFrame) {
 			usePreviousFrame = true;
 			usePreviousAtOutputResolution = shaderInfo[i]->outputResolution;
 		}
+		i += count;
 	}
 
 	if (usePreviousFrame) {
@@ -322,6 +474,38 @@ bool PresentationCommon::CompilePostShader(const ShaderInfo *shaderInfo, Draw::P
 		return false;
 	}
 
+	std::string name = shaderInfo->vertexShaderFile.ToString() + " and " + shaderInfo->fragmentShaderFile.ToString();
+	return CompilePostShaderSource(vsSourceGLSL, fsSourceGLSL, name, true, outPipeline);
+}
+
+bool PresentationCommon::CompileFusedPostShader(const ShaderInfo *shaderInfo, const std::vector<ShaderInfo> &fused, Draw::Pipeline **outPipeline) const {
+	_assert_(shaderInfo);
+
+	std::string vsSourceGLSL = ReadShaderSrc(shaderInfo->vertexShaderFile);
+	std::vector<std::string> fsSources{ ReadShaderSrc(shaderInfo->fragmentShaderFile) };
+	std::string name = shaderInfo->section;
+	for (const ShaderInfo &info : fused) {
+		fsSources.push_back(ReadShaderSrc(info.fragmentShaderFile));
+		name += "+" + info.section;
+	}
+	if (vsSourceGLSL.empty()) {
+		return false;
+	}
+	for (const std::string &src : fsSources) {
+		if (src.empty())
+			return false;
+	}
+
+	std::string fsSourceGLSL = GenerateFusedPostShader(fsSources);
+	if (fsSourceGLSL.empty()) {
+		return false;
+	}
+
+	// Errors here just mean we fall back to separate passes, no need to bother the user.
+	return CompilePostShaderSource(vsSourceGLSL, fsSourceGLSL, name, false, outPipeline);
+}
+
+bool PresentationCommon::CompilePostShaderSource(const std::string &vsSourceGLSL, const std::string &fsSourceGLSL, const std::string &name, bool showErrors, Draw::Pipeline **outPipeline) const {
 	std::string vsError;
 	std::string fsError;
 
@@ -334,8 +518,9 @@ bool PresentationCommon::CompilePostShader(const ShaderInfo *shaderInfo, Draw::P
 		std::string errorString = vsError + "\n" + fsError;
 		// DO NOT turn this into an ERROR_LOG_REPORT, as it will pollute our logs with all kinds of
 		// user shader experiments.
-		ERROR_LOG(FRAMEBUF, "Failed to build post-processing program from %s and %s!\n%s", shaderInfo->vertexShaderFile.c_str(), shaderInfo->fragmentShaderFile.c_str(), errorString.c_str());
-		ShowPostShaderError(errorString);
+		ERROR_LOG(FRAMEBUF, "Failed to build post-processing program from %s!\n%s", name.c_str(), errorString.c_str());
+		if (showErrors)
+			ShowPostShaderError(errorString);
 		return false;
 	}
 
@@ -347,6 +532,9 @@ bool PresentationCommon::CompilePostShader(const ShaderInfo *shaderInfo, Draw::P
 		{ "u_timeDelta", 4, 4, UniformType::FLOAT4, offsetof(PostShaderUniforms, timeDelta) },
 		{ "u_setting", 5, 5, UniformType::FLOAT4, offsetof(PostShaderUniforms, setting) },
 		{ "u_video", 6, 6, UniformType::FLOAT1, offsetof(PostShaderUniforms, video) },
+		{ "u_setting1", 7, 7, UniformType::FLOAT4, offsetof(PostShaderUniforms, fusedSetting) },
+		{ "u_setting2", 8, 8, UniformType::FLOAT4, offsetof(PostShaderUniforms, fusedSetting) + sizeof(float) * 4 },
+		{ "u_setting3", 9, 9, UniformType::FLOAT4, offsetof(PostShaderUniforms, fusedSetting) + sizeof(float) * 8 },
 	} };
 
 	Draw::Pipeline *pipeline = CreatePipeline({ vs, fs }, true, &postShaderDesc);
@@ -361,8 +549,9 @@ bool PresentationCommon::CompilePostShader(const ShaderInfo *shaderInfo, Draw::P
 	return true;
 }
 
-bool PresentationCommon::BuildPostShader(const ShaderInfo * shaderInfo, const ShaderInfo * next, Draw::Pipeline **outPipeline) {
-	if (!CompilePostShader(shaderInfo, outPipeline)) {
+bool PresentationCommon::BuildPostShader(const ShaderInfo *shaderInfo, const ShaderInfo *next, const std::vector<ShaderInfo> &fused, Draw::Pipeline **outPipeline) {
+	bool compiled = fused.empty() ? CompilePostShader(shaderInfo, outPipeline) : CompileFusedPostShader(shaderInfo, fused, outPipeline);
+	if (!compiled) {
 		return false;
 	}
 
@@ -559,6 +748,7 @@ void PresentationCommon::DestroyPostShader() {
 	DoReleaseVector(postShaderFramebuffers_);
 	DoReleaseVector(previousFramebuffers_);
 	postShaderInfo_.clear();
+	postShaderFusedInfo_.clear();
 	postShaderFBOUsage_.clear();
 }
 
@@ -764,7 +954,7 @@ void PresentationCommon::CopyToOutput(OutputFlags flags, int uvRotation, float u
 	Draw::Framebuffer *previousFramebuffer = previousFramebuffers_.empty() ? nullptr : previousFramebuffers_[previousIndex_];
 
 	PostShaderUniforms uniforms;
-	const auto performShaderPass = [&](const ShaderInfo *shaderInfo, Draw::Framebuffer *postShaderFramebuffer, Draw::Pipeline *postShaderPipeline, int vertsOffset) {
+	const auto performShaderPass = [&](const ShaderInfo *shaderInfo, const std::vector<ShaderInfo> *fused, Draw::Framebuffer *postShaderFramebuffer, Draw::Pipeline *postShaderPipeline, int vertsOffset) {
 		if (postShaderOutput) {
 			draw_->BindFramebufferAsTexture(postShaderOutput, 0, Draw::FB_COLOR_BIT, 0);
 		} else {
@@ -780,7 +970,7 @@ void PresentationCommon::CopyToOutput(OutputFlags flags, int uvRotation, float u
 		draw_->SetViewport(viewport);
 		draw_->SetScissorRect(0, 0, nextWidth, nextHeight);
 
-		CalculatePostShaderUniforms(lastWidth, lastHeight, nextWidth, nextHeight, shaderInfo, &uniforms);
+		CalculatePostShaderUniforms(lastWidth, lastHeight, nextWidth, nextHeight, shaderInfo, &uniforms, fused);
 
 		draw_->BindPipeline(postShaderPipeline);
 		draw_->UpdateDynamicUniformBuffer(&uniforms, sizeof(uniforms));
@@ -835,7 +1025,7 @@ void PresentationCommon::CopyToOutput(OutputFlags flags, int uvRotation, float u
 
 			// Pick vertices 8-11 for the first pass.
 			int vertOffset = i == 0 ? (int)sizeof(Vertex) * 8 : (int)sizeof(Vertex) * 4;
-			performShaderPass(shaderInfo, postShaderFramebuffer, postShaderPipeline, vertOffset);
+			performShaderPass(shaderInfo, &postShaderFusedInfo_[i], postShaderFramebuffer, postShaderPipeline, vertOffset);
 		}
 
 		if (isFinalAtOutputResolution && postShaderInfo_.back().isUpscalingFilter)
@@ -857,7 +1047,7 @@ void PresentationCommon::CopyToOutput(OutputFlags flags, int uvRotation, float u
 		Draw::Framebuffer *postShaderFramebuffer = previousFramebuffers_[previousIndex_];
 
 		draw_->BindFramebufferAsRenderTarget(postShaderFramebuffer, { Draw::RPAction::CLEAR, Draw::RPAction::DONT_CARE, Draw::RPAction::DONT_CARE }, "InterFrameBlit");
-		performShaderPass(shaderInfo, postShaderFramebuffer, postShaderPipeline, postVertsOffset);
+		performShaderPass(shaderInfo, &postShaderFusedInfo_.back(), postShaderFramebuffer, postShaderPipeline, postVertsOffset);
 	}
 
 	draw_->BindFramebufferAsRenderTarget(nullptr, { Draw::RPAction::CLEAR, Draw::RPAction::DONT_CARE, Draw::RPAction::DONT_CARE }, "FinalBlit");
@@ -887,7 +1077,7 @@ void PresentationCommon::CopyToOutput(OutputFlags flags, int uvRotation, float u
 	BindSource(1, false);
 
 	if (isFinalAtOutputResolution && previousFramebuffers_.empty()) {
-		CalculatePostShaderUniforms(lastWidth, lastHeight, (int)rc.w, (int)rc.h, &postShaderInfo_.back(), &uniforms);
+		CalculatePostShaderUniforms(lastWidth, lastHeight, (int)rc.w, (int)rc.h, &postShaderInfo_.back(), &uniforms, &postShaderFusedInfo_.back());
 		draw_->UpdateDynamicUniformBuffer(&uniforms, sizeof(uniforms));
 	} else if (useStereo) {
 		CalculatePostShaderUniforms(lastWidth, lastHeight, (int)rc.w, (int)rc.h, stereoShaderInfo_, &uniforms);
@@ -35,6 +35,8 @@ struct PostShaderUniforms {
 	float timeDelta[4];
 	float setting[4];
 	float video; float pad[3];
+	// u_setting1-3, for the extra shaders of a fused pass.
+	float fusedSetting[3][4];
 	// Used on Direct3D9.
 	float gl_HalfPixel[4];
 };
@@ -120,13 +122,15 @@ class PresentationCommon {
 	Draw::ShaderModule *CompileShaderModule(ShaderStage stage, ShaderLanguage lang, const std::string &src, std::string *errorString) const;
 	Draw::Pipeline *CreatePipeline(std::vector<Draw::ShaderModule *> shaders, bool postShader, const UniformBufferDesc *uniformDesc) const;
 	bool CompilePostShader(const ShaderInfo *shaderInfo, Draw::Pipeline **outPipeline) const;
-	bool BuildPostShader(const ShaderInfo *shaderInfo, const ShaderInfo *next, Draw::Pipeline **outPipeline);
+	bool CompileFusedPostShader(const ShaderInfo *shaderInfo, const std::vector<ShaderInfo> &fused, Draw::Pipeline **outPipeline) const;
+	bool CompilePostShaderSource(const std::string &vsSourceGLSL, const std::string &fsSourceGLSL, const std::string &name, bool showErrors, Draw::Pipeline **outPipeline) const;
+	bool BuildPostShader(const ShaderInfo *shaderInfo, const ShaderInfo *next, const std::vector<ShaderInfo> &fused, Draw::Pipeline **outPipeline);
 	bool AllocateFramebuffer(int w, int h);
 
 	bool BindSource(int binding, bool bindStereo);
 
 	void GetCardboardSettings(CardboardSettings *cardboardSettings) const;
-	void CalculatePostShaderUniforms(int bufferWidth, int bufferHeight, int targetWidth, int targetHeight, const ShaderInfo *shaderInfo, PostShaderUniforms *uniforms) const;
+	void CalculatePostShaderUniforms(int bufferWidth, int bufferHeight, int targetWidth, int targetHeight, const ShaderInfo *shaderInfo, PostShaderUniforms *uniforms, const std::vector<ShaderInfo> *fused = nullptr) const;
 
 	Draw::DrawContext *draw_;
 	Draw::Pipeline *texColor_ = nullptr;
@@ -138,6 +142,8 @@ class PresentationCommon {
 	std::vector<Draw::Pipeline *> postShaderPipelines_;
 	std::vector<Draw::Framebuffer *> postShaderFramebuffers_;
 	std::vector<ShaderInfo> postShaderInfo_;
+	// Per pass, the per-pixel shaders that were fused into the pass after postShaderInfo_[i].
+	std::vector<std::vector<ShaderInfo>> postShaderFusedInfo_;
 	std::vector<Draw::Framebuffer *> previousFramebuffers_;
 	
 	Draw::Pipeline *stereoPipeline_ = nullptr;
@@ -77,10 +77,10 @@ static ReplacedImageType Identify(VFSBackend *vfs, VFSOpenFile *openFile, std::s
 
 class ReplacedTextureTask : public Task {
 public:
-	ReplacedTextureTask(VFSBackend *vfs, ReplacedTexture &tex, LimitedWaitable *w) : vfs_(vfs), tex_(tex), waitable_(w) {}
+	ReplacedTextureTask(VFSBackend *vfs, ReplacedTexture &tex, LimitedWaitable *w, TaskPriority priority) : vfs_(vfs), tex_(tex), waitable_(w), priority_(priority) {}
 
 	TaskType Type() const override { return TaskType::IO_BLOCKING; }
-	TaskPriority Priority() const override { return TaskPriority::NORMAL; }
+	TaskPriority Priority() const override { return priority_; }
 
 	void Run() override {
 		tex_.Prepare(vfs_);
@@ -91,6 +91,7 @@ class ReplacedTextureTask : public Task {
 	VFSBackend *vfs_;
 	ReplacedTexture &tex_;
 	LimitedWaitable *waitable_;
+	TaskPriority priority_;
 };
 
 ReplacedTexture::ReplacedTexture(VFSBackend *vfs, const ReplacementDesc &desc) : vfs_(vfs), desc_(desc) {
@@ -175,14 +176,19 @@ bool ReplacedTexture::Poll(double budget) {
 
 	lastUsed_ = now;
 
-	// Let's not even start a new texture if we're already behind.
-	if (budget < 0.0)
-		return false;
-
 	_assert_(!threadWaitable_);
 	threadWaitable_ = new LimitedWaitable();
 	SetState(ReplacementState::PENDING);
-	g_threadManager.EnqueueTask(new ReplacedTextureTask(vfs_, *this, threadWaitable_));
+
+	// If we're already behind, still start loading so it's decoded in parallel with
+	// everything else, but don't wait for it and don't let it jump ahead of textures
+	// we're actually waiting on this frame.
+	if (budget < 0.0) {
+		g_threadManager.EnqueueTask(new ReplacedTextureTask(vfs_, *this, threadWaitable_, TaskPriority::NORMAL));
+		return false;
+	}
+
+	g_threadManager.EnqueueTask(new ReplacedTextureTask(vfs_, *this, threadWaitable_, TaskPriority::HIGH));
 	if (threadWaitable_->WaitFor(budget)) {
 		// If we successfully wait here, we're done. The thread will set state accordingly.
 		_assert_(State() == ReplacementState::ACTIVE || State() == ReplacementState::NOT_FOUND || State() == ReplacementState::CANCEL_INIT);
@@ -194,6 +200,20 @@ bool ReplacedTexture::Poll(double budget) {
 	return false;
 }
 
+void ReplacedTexture::Prefetch() {
+	_assert_(vfs_ != nullptr);
+	if (State() != ReplacementState::UNLOADED)
+		return;
+
+	// Count it as used, so it's not immediately decimated before it's drawn.
+	lastUsed_ = time_now_d();
+
+	_assert_(!threadWaitable_);
+	threadWaitable_ = new LimitedWaitable();
+	SetState(ReplacementState::PENDING);
+	g_threadManager.EnqueueTask(new ReplacedTextureTask(vfs_, *this, threadWaitable_, TaskPriority::LOW));
+}
+
 inline uint32_t RoundUpTo4(uint32_t value) {
 	return (value + 3) & ~3;
 }
@@ -597,24 +617,29 @@ ReplacedTexture::LoadLevelResult ReplacedTexture::LoadLevelData(VFSFileReference
 
 	} else if (imageType == ReplacedImageType::ZIM) {
 
-		std::unique_ptr<uint8_t[]> zim(new uint8_t[fileSize]);
-		if (!zim) {
-			ERROR_LOG(G3D, "Failed to allocate memory for texture replacement");
-			vfs_->CloseFile(openFile);
-			return LoadLevelResult::LOAD_ERROR;
-		}
+		std::unique_ptr<uint8_t[]> zim;
+		const uint8_t *zimPtr = vfs_->GetMappedData(openFile);
+		if (!zimPtr) {
+			zim.reset(new uint8_t[fileSize]);
+			if (!zim) {
+				ERROR_LOG(G3D, "Failed to allocate memory for texture replacement");
+				vfs_->CloseFile(openFile);
+				return LoadLevelResult::LOAD_ERROR;
+			}
 
-		if (vfs_->Read(openFile, &zim[0], fileSize) != fileSize) {
-			ERROR_LOG(G3D, "Could not load texture replacement: %s - failed to read ZIM", filename.c_str());
-			vfs_->CloseFile(openFile);
-			return LoadLevelResult::LOAD_ERROR;
+			if (vfs_->Read(openFile, &zim[0], fileSize) != fileSize) {
+				ERROR_LOG(G3D, "Could not load texture replacement: %s - failed to read ZIM", filename.c_str());
+				vfs_->CloseFile(openFile);
+				return LoadLevelResult::LOAD_ERROR;
+			}
+			zimPtr = &zim[0];
 		}
 
 		int w, h, f;
 		uint8_t *image;
 		std::vector<uint8_t> &out = data_[mipLevel];
 		// TODO: Zim files can actually hold mipmaps (although no tool has ever been made to create them :P)
-		if (LoadZIMPtr(&zim[0], fileSize, &w, &h, &f, &image)) {
+		if (LoadZIMPtr(zimPtr, fileSize, &w, &h, &f, &image)) {
 			if (w > level.w || h > level.h) {
 				ERROR_LOG(G3D, "Texture replacement changed since header read: %s", filename.c_str());
 				vfs_->CloseFile(openFile);
@@ -647,10 +672,17 @@ ReplacedTexture::LoadLevelResult ReplacedTexture::LoadLevelData(VFSFileReference
 		png_image png = {};
 		png.version = PNG_IMAGE_VERSION;
 
+		// Uncompressed files in a zip can be decoded straight out of the mapped archive.
 		std::string pngdata;
-		pngdata.resize(fileSize);
-		pngdata.resize(vfs_->Read(openFile, &pngdata[0], fileSize));
-		if (!png_image_begin_read_from_memory(&png, &pngdata[0], pngdata.size())) {
+		const uint8_t *pngPtr = vfs_->GetMappedData(openFile);
+		size_t pngSize = fileSize;
+		if (!pngPtr) {
+			pngdata.resize(fileSize);
+			pngdata.resize(vfs_->Read(openFile, &pngdata[0], fileSize));
+			pngPtr = (const uint8_t *)pngdata.data();
+			pngSize = pngdata.size();
+		}
+		if (!png_image_begin_read_from_memory(&png, pngPtr, pngSize)) {
 			ERROR_LOG(G3D, "Could not load texture replacement info: %s - %s (zip)", filename.c_str(), png.message);
 			vfs_->CloseFile(openFile);
 			return LoadLevelResult::LOAD_ERROR;
@@ -173,6 +173,8 @@ class ReplacedTexture {
 	}
 
 	bool Poll(double budget);
+	// Starts loading in the background at low priority, without waiting. Poll() picks up the result.
+	void Prefetch();
 	bool CopyLevelTo(int level, uint8_t *out, size_t outDataSize, int rowPitch);
 
 	std::string logId_;
@@ -438,7 +438,13 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 				// TODO: Unify this as far as possible (I think only GLES backend really needs its own implementation due to different component order).
 				UpdateCurrentClut(gstate.getClutPaletteFormat(), gstate.getClutIndexStartPos(), gstate.isClutIndexSimple());
 			}
-			cluthash = clutHash_ ^ gstate.clutformat;
+			if (!clutGPUTextures_.empty() && clutGPUTextures_.count(ClutGPUKey(texaddr, texFormat)) != 0) {
+				// Palette animated texture, keep a single index texture and only swap the CLUT.
+				hasClutGPU = true;
+				cluthash = 0;
+			} else {
+				cluthash = clutHash_ ^ gstate.clutformat;
+			}
 		}
 	} else {
 		cluthash = 0;
@@ -642,7 +648,9 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 		}
 
 		if (hasClutGPU) {
-			WARN_LOG_N_TIMES(clutUseRender, 5, G3D, "Using texture with dynamic CLUT: texfmt=%d, clutfmt=%d", gstate.getTextureFormat(), gstate.getClutPaletteFormat());
+			if (clutRenderAddress_ != 0xFFFFFFFF) {
+				WARN_LOG_N_TIMES(clutUseRender, 5, G3D, "Using texture with dynamic CLUT: texfmt=%d, clutfmt=%d", gstate.getTextureFormat(), gstate.getClutPaletteFormat());
+			}
 			entry->status |= TexCacheEntry::STATUS_CLUT_GPU;
 		}
 
@@ -661,6 +669,13 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 				}
 
 				entry->status |= TexCacheEntry::STATUS_CLUT_VARIANTS;
+
+				// From now on, decode this texture to indices once and apply the CLUT on the GPU.
+				// The CPU-decoded variants will age out through Decimate.
+				if (!hasClutGPU && CanDepalettizeMemoryClutOnGPU(texFormat, maxLevel)) {
+					DEBUG_LOG(G3D, "Switching texture %08x to GPU depal after %d CLUT variants", texaddr, found);
+					clutGPUTextures_.insert(ClutGPUKey(texaddr, texFormat));
+				}
 			}
 		}
 
@@ -815,6 +830,17 @@ void TextureCacheCommon::Decimate(bool forcePressure) {
 			}
 		}
 
+		// Forget palette animated textures that no longer have any entry left.
+		for (auto iter = clutGPUTextures_.begin(); iter != clutGPUTextures_.end(); ) {
+			const u64 cachekeyMin = (*iter >> 32) << 32;
+			const u64 cachekeyMax = cachekeyMin + (1ULL << 32);
+			if (cache_.lower_bound(cachekeyMin) == cache_.upper_bound(cachekeyMax)) {
+				iter = clutGPUTextures_.erase(iter);
+			} else {
+				++iter;
+			}
+		}
+
 		VERBOSE_LOG(G3D, "Decimated texture cache, saved %d estimated bytes - now %d bytes", had - cacheSizeEstimate_, cacheSizeEstimate_);
 	}
 
@@ -1719,6 +1745,9 @@ static void Expand4To8Bits(u8 *dest, const u8 *src, int srcWidth) {
 	}
 }
 
+// The row loops here are deliberately not split with ParallelRangeLoop. Each one also reduces alphaSum across
+// all rows, and PSP texture levels are at most 512x512, mostly far smaller, so a dispatch rarely pays off.
+// Replacement textures, which can be much larger, are converted in parallel in ReplacedTexture.
 CheckAlphaResult TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, GETextureFormat format, GEPaletteFormat clutformat, uint32_t texaddr, int level, int bufw, TexDecodeFlags flags) {
 	u32 alphaSum = 0xFFFFFFFF;
 	u32 fullAlphaMask = 0x0;
@@ -2154,7 +2183,6 @@ void TextureCacheCommon::ApplyTexture() {
 		// Special process.
 		ApplyTextureDepal(entry);
 		entry->lastFrame = gpuStats.numFlips;
-		gstate_c.SetTextureFullAlpha(false);
 		gstate_c.SetTextureIs3D(false);
 		gstate_c.SetTextureIsArray(false);
 		gstate_c.SetTextureIsBGRA(false);
@@ -2419,16 +2447,23 @@ void TextureCacheCommon::ApplyTextureDepal(TexCacheEntry *entry) {
 	const GEPaletteFormat clutFormat = gstate.getClutPaletteFormat();
 	u32 depthUpperBits = 0;
 
-	// The CLUT texture is dynamic, it's the framebuffer pointed to by clutRenderAddress.
-	// Instead of texturing directly from that, we copy to a temporary CLUT texture.
-	GEBufferFormat expectedCLUTBufferFormat = (GEBufferFormat)clutFormat;  // All entries from clutFormat correspond directly to buffer formats.
+	ClutTexture clutTexture{};
+	const bool memoryClut = clutRenderAddress_ == 0xFFFFFFFF;
+	if (memoryClut) {
+		// Palette animated texture from memory. The index texture stays put, we only need the current CLUT.
+		clutTexture = textureShaderCache_->GetClutTexture(clutFormat, clutHash_, clutBufRaw_);
+	} else {
+		// The CLUT texture is dynamic, it's the framebuffer pointed to by clutRenderAddress.
+		// Instead of texturing directly from that, we copy to a temporary CLUT texture.
+		GEBufferFormat expectedCLUTBufferFormat = (GEBufferFormat)clutFormat;  // All entries from clutFormat correspond directly to buffer formats.
 
-	// OK, figure out what format we want our framebuffer in, so it can be reinterpreted if needed.
-	// If no reinterpretation is needed, we'll automatically just get a copy shader.
-	float scaleFactorX = 1.0f;
-	Draw2DPipeline *reinterpret = framebufferManager_->GetReinterpretPipeline(clutRenderFormat_, expectedCLUTBufferFormat, &scaleFactorX);
-	framebufferManager_->BlitUsingRaster(
-		dynamicClutTemp_, 0.0f, 0.0f, 512.0f, 1.0f, dynamicClutFbo_, 0.0f, 0.0f, scaleFactorX * 512.0f, 1.0f, false, 1.0f, reinterpret, "reinterpret_clut");
+		// OK, figure out what format we want our framebuffer in, so it can be reinterpreted if needed.
+		// If no reinterpretation is needed, we'll automatically just get a copy shader.
+		float scaleFactorX = 1.0f;
+		Draw2DPipeline *reinterpret = framebufferManager_->GetReinterpretPipeline(clutRenderFormat_, expectedCLUTBufferFormat, &scaleFactorX);
+		framebufferManager_->BlitUsingRaster(
+			dynamicClutTemp_, 0.0f, 0.0f, 512.0f, 1.0f, dynamicClutFbo_, 0.0f, 0.0f, scaleFactorX * 512.0f, 1.0f, false, 1.0f, reinterpret, "reinterpret_clut");
+	}
 
 	Draw2DPipeline *textureShader = textureShaderCache_->GetDepalettizeShader(clutMode, GE_TFMT_CLUT8, GE_FORMAT_CLUT8, false, 0);
 	gstate_c.SetUseShaderDepal(ShaderDepalMode::OFF);
@@ -2462,7 +2497,11 @@ void TextureCacheCommon::ApplyTextureDepal(TexCacheEntry *entry) {
 	draw_->SetViewport(viewport);
 
 	draw_->BindNativeTexture(0, GetNativeTextureView(entry));
-	draw_->BindFramebufferAsTexture(dynamicClutFbo_, 1, Draw::FB_COLOR_BIT, 0);
+	if (memoryClut) {
+		draw_->BindTexture(1, clutTexture.texture);
+	} else {
+		draw_->BindFramebufferAsTexture(dynamicClutFbo_, 1, Draw::FB_COLOR_BIT, 0);
+	}
 	Draw::SamplerState *nearest = textureShaderCache_->GetSampler(false);
 	Draw::SamplerState *clutSampler = textureShaderCache_->GetSampler(false);
 	draw_->BindSamplerStates(0, 1, &nearest);
@@ -2484,8 +2523,13 @@ void TextureCacheCommon::ApplyTextureDepal(TexCacheEntry *entry) {
 	const u32 bytesPerColor = clutFormat == GE_CMODE_32BIT_ABGR8888 ? sizeof(u32) : sizeof(u16);
 	const u32 clutTotalColors = clutMaxBytes_ / bytesPerColor;
 
-	// We don't know about alpha at all.
-	gstate_c.SetTextureFullAlpha(false);
+	if (memoryClut) {
+		CheckAlphaResult alphaStatus = CheckCLUTAlpha((const uint8_t *)clutBufRaw_, clutFormat, clutTotalColors);
+		gstate_c.SetTextureFullAlpha(alphaStatus == CHECKALPHA_FULL);
+	} else {
+		// We don't know about alpha at all.
+		gstate_c.SetTextureFullAlpha(false);
+	}
 
 	draw_->Invalidate(InvalidationFlags::CACHED_RENDER_STATE);
 	shaderManager_->DirtyLastShader();
@@ -2497,6 +2541,19 @@ void TextureCacheCommon::ApplyTextureDepal(TexCacheEntry *entry) {
 	gstate_c.Dirty(DIRTY_ALL_RENDER_STATE);
 }
 
+// Palette animated textures from memory can skip the CPU de-index on every CLUT change, as long as
+// nothing else wants the decoded colors (mips, scaling, replacement.) See STATUS_CLUT_GPU.
+bool TextureCacheCommon::CanDepalettizeMemoryClutOnGPU(GETextureFormat texFormat, u8 maxLevel) const {
+	// Only these are decoded to an index texture, see ApplyTextureDepal.
+	if (texFormat != GE_TFMT_CLUT4 && texFormat != GE_TFMT_CLUT8)
+		return false;
+	if (maxLevel != 0)
+		return false;
+	if (standardScaleFactor_ > 1 || replacer_.Enabled())
+		return false;
+	return textureShaderCache_ != nullptr;
+}
+
 void TextureCacheCommon::Clear(bool delete_them) {
 	textureShaderCache_->Clear();
 
@@ -2516,6 +2573,7 @@ void TextureCacheCommon::Clear(bool delete_them) {
 		secondCacheSizeEstimate_ = 0;
 	}
 	videos_.clear();
+	clutGPUTextures_.clear();
 
 	if (dynamicClutFbo_) {
 		dynamicClutFbo_->Release();
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
@@ -378,6 +379,11 @@ class TextureCacheCommon {
 
 	void ApplyTextureFramebuffer(VirtualFramebuffer *framebuffer, GETextureFormat texFormat, RasterChannel channel);
 	void ApplyTextureDepal(TexCacheEntry *entry);
+	bool CanDepalettizeMemoryClutOnGPU(GETextureFormat texFormat, u8 maxLevel) const;
+	// Same address layout as cache keys, so they can be matched up with entries.
+	static u64 ClutGPUKey(u32 addr, GETextureFormat texFormat) {
+		return ((u64)(addr & 0x3FFFFFFF) << 32) | (u64)texFormat;
+	}
 
 	void HandleTextureChange(TexCacheEntry *const entry, const char *reason, bool initialMatch, bool doDelete);
 	virtual void BuildTexture(TexCacheEntry *const entry) = 0;
@@ -511,6 +517,9 @@ class TextureCacheCommon {
 	// Facilities for GPU depal of static textures.
 	Draw::Framebuffer *dynamicClutTemp_ = nullptr;
 	Draw::Framebuffer *dynamicClutFbo_ = nullptr;
+	// Textures seen with many different memory CLUTs (palette animation), by ClutGPUKey().
+	// These are uploaded once as raw indices and depalettized on the GPU instead.
+	std::unordered_set<u64> clutGPUTextures_;
 
 	int standardScaleFactor_;
 	int shaderScaleFactor_ = 0;
@@ -54,6 +54,12 @@ static const std::string ZIP_FILENAME = "textures.zip";
 static const std::string NEW_TEXTURE_DIR = "new/";
 static const int VERSION = 1;
 static const double MAX_CACHE_SIZE = 4.0;
+// Hard cap on decoded replacement data, enforced by evicting the least recently used textures.
+static const uint64_t MAX_CACHE_BYTES = (uint64_t)(MAX_CACHE_SIZE * 1024.0 * 1024.0 * 1024.0);
+// Textures used within this many seconds are never evicted for the budget, to avoid reloading every frame.
+static const double MIN_EVICT_AGE = 2.0;
+// How many neighbors of a newly seen texture to queue for loading.
+static const int MAX_PREFETCH_NEIGHBORS = 8;
 static bool basisu_initialized = false;
 
 TextureReplacer::TextureReplacer(Draw::DrawContext *draw) {
@@ -106,6 +112,7 @@ void TextureReplacer::NotifyConfigChanged() {
 bool TextureReplacer::LoadIni() {
 	hash_ = ReplacedTextureHash::QUICK;
 	aliases_.clear();
+	aliasesByAddress_.clear();
 	hashranges_.clear();
 	filtering_.clear();
 	reducehashranges_.clear();
@@ -305,7 +312,14 @@ bool TextureReplacer::LoadIniValues(IniFile &ini, VFSBackend *dir, bool isOverri
 				c = '/';
 			}
 		}
-		aliases_[pair.first] = alias;
+		auto inserted = aliases_.insert(std::make_pair(pair.first, alias));
+		if (inserted.second) {
+			u32 addr = (u32)(pair.first.cachekey >> 32);
+			if (addr != 0 && !alias.empty())
+				aliasesByAddress_[addr].push_back(pair.first);
+		} else {
+			inserted.first->second = alias;
+		}
 	}
 
 	if (filenameWarning) {
@@ -508,6 +522,17 @@ ReplacedTexture *TextureReplacer::FindReplacement(u64 cachekey, u32 hash, int w,
 		return nullptr;
 	}
 
+	bool created = false;
+	ReplacedTexture *texture = LookupReplacement(cachekey, hash, w, h, &created);
+	if (created) {
+		// This is the first time we've seen this texture, so its neighbors are likely to be needed soon.
+		PrefetchNeighbors(cachekey);
+	}
+	return texture;
+}
+
+ReplacedTexture *TextureReplacer::LookupReplacement(u64 cachekey, u32 hash, int w, int h, bool *created) {
+
 	ReplacementCacheKey replacementKey(cachekey, hash);
 	auto it = cache_.find(replacementKey);
 	if (it != cache_.end()) {
@@ -583,9 +608,42 @@ ReplacedTexture *TextureReplacer::FindReplacement(u64 cachekey, u32 hash, int w,
 
 	// Also, insert the level in the level cache so we can look up by desc_->hashfiles again.
 	levelCache_.emplace(std::make_pair(hashfiles, texture));
+	*created = true;
 	return texture;
 }
 
+void TextureReplacer::PrefetchNeighbors(u64 cachekey) {
+	// Without addresses, there's no cheap way to tell which textures belong together.
+	if (ignoreAddress_)
+		return;
+	auto it = aliasesByAddress_.find((u32)(cachekey >> 32));
+	if (it == aliasesByAddress_.end())
+		return;
+
+	int count = 0;
+	for (const ReplacementCacheKey &key : it->second) {
+		if (count >= MAX_PREFETCH_NEIGHBORS)
+			break;
+		if (cache_.find(key) != cache_.end())
+			continue;
+
+		// The dimensions are only known if the low bits are just the texture dimension, without a CLUT hash.
+		// Guessing would leave an entry with the wrong size in the cache for the real lookup to find.
+		u32 dim = (u32)key.cachekey;
+		if ((dim & ~0x0F0F) != 0)
+			continue;
+		int w = 1 << (dim & 0xF);
+		int h = 1 << ((dim >> 8) & 0xF);
+
+		bool created = false;
+		ReplacedTexture *texture = LookupReplacement(key.cachekey, key.hash, w, h, &created);
+		if (texture) {
+			texture->Prefetch();
+			count++;
+		}
+	}
+}
+
 static bool WriteTextureToPNG(png_imagep image, const Path &filename, int convert_to_8bit, const void *buffer, png_int_32 row_stride, const void *colormap) {
 	FILE *fp = File::OpenCFile(filename, "wb");
 	if (!fp) {
@@ -783,7 +841,7 @@ void TextureReplacer::Decimate(ReplacerDecimateMode mode) {
 	}
 
 	const double threshold = time_now_d() - age;
-	size_t totalSize = 0;
+	uint64_t totalSize = 0;
 	for (auto &item : levelCache_) {
 		std::lock_guard<std::mutex> guard(item.second->lock_);
 		item.second->PurgeIfNotUsedSinceTime(threshold);
@@ -791,6 +849,12 @@ void TextureReplacer::Decimate(ReplacerDecimateMode mode) {
 		// don't actually delete the items here, just clean out the data.
 	}
 
+	// Under pressure, aim well below the cap so we're not evicting every frame.
+	uint64_t budget = mode == ReplacerDecimateMode::FORCE_PRESSURE ? MAX_CACHE_BYTES / 2 : MAX_CACHE_BYTES;
+	if (totalSize > budget) {
+		totalSize = DecimateToBudget(totalSize, budget);
+	}
+
 	double totalSizeGB = totalSize / (1024.0 * 1024.0 * 1024.0);
 	if (totalSizeGB >= 1.0) {
 		WARN_LOG(G3D, "Decimated replacements older than %fs, currently using %f GB of RAM", age, totalSizeGB);
@@ -798,6 +862,36 @@ void TextureReplacer::Decimate(ReplacerDecimateMode mode) {
 	lastTextureCacheSizeGB_ = totalSizeGB;
 }
 
+uint64_t TextureReplacer::DecimateToBudget(uint64_t totalSize, uint64_t budget) {
+	std::vector<ReplacedTexture *> candidates;
+	const double threshold = time_now_d() - MIN_EVICT_AGE;
+	for (auto &item : levelCache_) {
+		ReplacedTexture *texture = item.second;
+		if (texture->State() == ReplacementState::ACTIVE && texture->lastUsed_ < threshold)
+			candidates.push_back(texture);
+	}
+
+	// Least recently used first.
+	std::sort(candidates.begin(), candidates.end(), [](const ReplacedTexture *a, const ReplacedTexture *b) {
+		return a->lastUsed_ < b->lastUsed_;
+	});
+
+	for (ReplacedTexture *texture : candidates) {
+		if (totalSize <= budget)
+			break;
+		std::lock_guard<std::mutex> guard(texture->lock_);
+		size_t size = texture->GetTotalDataSize();
+		texture->PurgeIfNotUsedSinceTime(threshold);
+		if (texture->State() != ReplacementState::ACTIVE)
+			totalSize -= size;
+	}
+
+	if (totalSize > budget) {
+		WARN_LOG(G3D, "Texture replacements recently in use exceed the memory budget (%d MB)", (int)(budget / (1024 * 1024)));
+	}
+	return totalSize;
+}
+
 template <typename Key, typename Value>
 static typename std::unordered_map<Key, Value>::const_iterator LookupWildcard(const std::unordered_map<Key, Value> &map, Key &key, u64 cachekey, u32 hash, bool ignoreAddress) {
 	auto alias = map.find(key);
@@ -134,6 +134,9 @@ class TextureReplacer {
 	bool LookupHashRange(u32 addr, int w, int h, int *newW, int *newH);
 	float LookupReduceHashRange(int w, int h);
 	std::string LookupHashFile(u64 cachekey, u32 hash, bool *foundAlias, bool *ignored);
+	ReplacedTexture *LookupReplacement(u64 cachekey, u32 hash, int w, int h, bool *created);
+	void PrefetchNeighbors(u64 cachekey);
+	uint64_t DecimateToBudget(uint64_t totalSize, uint64_t budget);
 
 	bool enabled_ = false;
 	bool allowVideo_ = false;
@@ -161,6 +164,8 @@ class TextureReplacer {
 
 	std::unordered_map<ReplacementCacheKey, std::string> aliases_;
 	std::unordered_map<ReplacementCacheKey, TextureFiltering> filtering_;
+	// Aliases grouped by texture address, used to prefetch likely neighbors (e.g. animation frames.)
+	std::unordered_map<u32, std::vector<ReplacementCacheKey>> aliasesByAddress_;
 
 	std::unordered_map<ReplacementCacheKey, ReplacedTextureRef> cache_;
 	std::unordered_map<ReplacementCacheKey, SavedTextureCacheData> savedCache_;
@@ -1655,7 +1655,7 @@ size_t GPUCommonHW::FormatGPUStatsCommon(char *buffer, size_t size) {
 		"Draw calls: %d, flushes %d, clears %d, bbox jumps %d (%d updates)\n"
 		"Cached draws: %d (tracked: %d)\n"
 		"Vertices: %d cached: %d uncached: %d\n"
-		"FBOs active: %d (evaluations: %d)\n"
+		"FBOs active: %d (evaluations: %d), est. memory: %d MB\n"
 		"Textures: %d, dec: %d, invalidated: %d, hashed: %d kB\n"
 		"readbacks %d (%d non-block), uploads %d, depal %d\n"
 		"replacer: tracks %d references, %d unique textures\n"
@@ -1676,6 +1676,7 @@ size_t GPUCommonHW::FormatGPUStatsCommon(char *buffer, size_t size) {
 		gpuStats.numUncachedVertsDrawn,
 		(int)framebufferManager_->NumVFBs(),
 		gpuStats.numFramebufferEvaluations,
+		(int)(framebufferManager_->FramebufferMemoryBytes() >> 20),
 		(int)textureCache_->NumLoadedTextures(),
 		gpuStats.numTexturesDecoded,
 		gpuStats.numTextureInvalidations,
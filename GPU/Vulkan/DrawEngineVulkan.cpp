@@ -59,7 +59,9 @@ enum {
 };
 
 #define VERTEXCACHE_DECIMATION_INTERVAL 17
-#define DESCRIPTORSET_DECIMATION_INTERVAL 1  // Temporarily cut to 1. Handle reuse breaks this when textures get deleted.
+#define DESCRIPTORSET_DECIMATION_INTERVAL 60  // Also reset whenever a handle might be reused, see BeginFrame.
+// Above this many cached sets, we reset anyway rather than growing the pool further.
+#define DESCRIPTORSET_MAX_CACHED 4096
 
 enum { VAI_KILL_AGE = 120, VAI_UNRELIABLE_KILL_AGE = 240, VAI_UNRELIABLE_KILL_MAX = 4 };
 
@@ -308,10 +310,17 @@ void DrawEngineVulkan::BeginFrame() {
 
 	vertexCache_->BeginNoReset();
 
-	if (--descDecimationCounter_ <= 0) {
+	// Descriptor sets are cached across frames, keyed on raw handles. Those can be reused by the driver
+	// as soon as the old object is destroyed, so we wipe the cache if anything that could be in a set
+	// has been queued for deletion since it was last reset.
+	uint32_t handleGeneration = vulkan->Delete().DescriptorHandleGeneration();
+	if (--frame->descDecimationCounter <= 0 || frame->descHandleGeneration != handleGeneration || frame->descSets.size() > DESCRIPTORSET_MAX_CACHED) {
 		frame->descPool.Reset();
-		descDecimationCounter_ = DESCRIPTORSET_DECIMATION_INTERVAL;
+		frame->descHandleGeneration = handleGeneration;
+		frame->descDecimationCounter = DESCRIPTORSET_DECIMATION_INTERVAL;
 	}
+	descSetsWritten_ = 0;
+	descSetsReused_ = 0;
 
 	if (--decimationCounter_ <= 0) {
 		decimationCounter_ = VERTEXCACHE_DECIMATION_INTERVAL;
@@ -341,6 +350,8 @@ void DrawEngineVulkan::EndFrame() {
 	FrameData *frame = &GetCurFrame();
 	stats_.pushVertexSpaceUsed = (int)pushVertex_->GetUsedThisFrame();
 	stats_.pushIndexSpaceUsed = (int)pushIndex_->GetUsedThisFrame();
+	stats_.descriptorSetsWritten = descSetsWritten_;
+	stats_.descriptorSetsReused = descSetsReused_;
 	vertexCache_->End();
 }
 
@@ -384,8 +395,10 @@ VkDescriptorSet DrawEngineVulkan::GetOrCreateDescriptorSet(VkImageView imageView
 	// See if we already have this descriptor set cached.
 	if (!tess) { // Don't cache descriptors for HW tessellation.
 		VkDescriptorSet d = frame.descSets.Get(key);
-		if (d != VK_NULL_HANDLE)
+		if (d != VK_NULL_HANDLE) {
+			descSetsReused_++;
 			return d;
+		}
 	}
 
 	// Didn't find one in the frame descriptor set cache, let's make a new one.
@@ -505,6 +518,7 @@ VkDescriptorSet DrawEngineVulkan::GetOrCreateDescriptorSet(VkImageView imageView
 
 	VulkanContext *vulkan = (VulkanContext *)draw_->GetNativeObject(Draw::NativeObject::CONTEXT);
 	vkUpdateDescriptorSets(vulkan->GetDevice(), n, writes, 0, nullptr);
+	descSetsWritten_++;
 
 	if (!tess) // Again, avoid caching when HW tessellation.
 		frame.descSets.Insert(key, desc);
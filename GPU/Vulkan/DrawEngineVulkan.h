@@ -61,6 +61,8 @@ struct VulkanPipeline;
 struct DrawEngineVulkanStats {
 	int pushVertexSpaceUsed;
 	int pushIndexSpaceUsed;
+	int descriptorSetsWritten;
+	int descriptorSetsReused;
 };
 
 enum {
@@ -253,7 +255,8 @@ class DrawEngineVulkan : public DrawEngineCommon {
 
 	PrehashMap<VertexArrayInfoVulkan *, nullptr> vai_;
 	VulkanPushBuffer *vertexCache_;
-	int descDecimationCounter_ = 0;
+	int descSetsWritten_ = 0;
+	int descSetsReused_ = 0;
 
 	struct DescriptorSetKey {
 		VkImageView imageView_;
@@ -272,8 +275,11 @@ class DrawEngineVulkan : public DrawEngineCommon {
 
 		VulkanDescSetPool descPool;
 
-		// We do rolling allocation and reset instead of caching across frames. That we might do later.
+		// Kept across frames until a referenced handle might have been deleted (and reused), see
+		// VulkanDeleteList::DescriptorHandleGeneration, or the decimation interval runs out.
 		DenseHashMap<DescriptorSetKey, VkDescriptorSet, (VkDescriptorSet)VK_NULL_HANDLE> descSets;
+		uint32_t descHandleGeneration = 0;
+		int descDecimationCounter = 0;
 
 		void Destroy(VulkanContext *vulkan);
 	};
@@ -462,12 +462,15 @@ void GPU_Vulkan::GetStats(char *buffer, size_t bufsize) {
 	snprintf(buffer, bufsize,
 		"Vertex, Fragment, Pipelines loaded: %i, %i, %i\n"
 		"Pushbuffer space used: Vtx %d, Idx %d\n"
+		"Descriptor sets: %d written, %d reused\n"
 		"%s\n",
 		shaderManagerVulkan_->GetNumVertexShaders(),
 		shaderManagerVulkan_->GetNumFragmentShaders(),
 		pipelineManager_->GetNumPipelines(),
 		drawStats.pushVertexSpaceUsed,
 		drawStats.pushIndexSpaceUsed,
+		drawStats.descriptorSetsWritten,
+		drawStats.descriptorSetsReused,
 		texStats
 	);
 }
@@ -107,6 +107,67 @@ void main() {
 
 )";
 
+// Unswizzles and expands raw PSP texture memory (5650/5551/4444/8888) straight into an RGBA8 image.
+// The CPU path does the same thing through UnswizzleFromMem and ConvertFormatToRGBA8888.
+const char *decodeShader = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+uniform layout(set = 0, binding = 0, rgba8) writeonly image2D img;
+
+layout(std430, set = 0, binding = 1) buffer Buf {
+	uint data[];
+} buf;
+
+layout(push_constant) uniform Params {
+	uint width;
+	uint height;
+	uint bufw;
+	uint fmtFlags;  // GE texture format in the low byte, bit 8 = swizzled.
+} params;
+
+uint readTexel(uvec2 p, uint bpp) {
+	uint byteOffset;
+	if ((params.fmtFlags & 0x100u) != 0u) {
+		// Swizzled textures are stored as 16 byte x 8 row blocks.
+		uint byteX = p.x * bpp;
+		uint blocksPerRow = (params.bufw * bpp) >> 4u;
+		uint block = (p.y >> 3u) * blocksPerRow + (byteX >> 4u);
+		byteOffset = block * 128u + (p.y & 7u) * 16u + (byteX & 15u);
+	} else {
+		byteOffset = (p.y * params.bufw + p.x) * bpp;
+	}
+	uint word = buf.data[byteOffset >> 2u];
+	if (bpp == 2u)
+		word = (word >> ((byteOffset & 2u) * 8u)) & 0xFFFFu;
+	return word;
+}
+
+void main() {
+	uvec2 xy = gl_GlobalInvocationID.xy;
+	if (xy.x >= params.width || xy.y >= params.height)
+		return;
+
+	uint fmt = params.fmtFlags & 0xFFu;
+	vec4 c;
+	if (fmt == 3u) {  // GE_TFMT_8888
+		c = unpackUnorm4x8(readTexel(xy, 4u));
+	} else {
+		uint t = readTexel(xy, 2u);
+		if (fmt == 0u) {  // GE_TFMT_5650
+			c = vec4(vec3(uvec3(t, t >> 5u, t >> 11u) & uvec3(0x1Fu, 0x3Fu, 0x1Fu)) / vec3(31.0, 63.0, 31.0), 1.0);
+		} else if (fmt == 1u) {  // GE_TFMT_5551
+			c = vec4(uvec4(t, t >> 5u, t >> 10u, t >> 15u) & uvec4(0x1Fu, 0x1Fu, 0x1Fu, 0x1u)) / vec4(31.0, 31.0, 31.0, 1.0);
+		} else {  // GE_TFMT_4444
+			c = vec4(uvec4(t, t >> 4u, t >> 8u, t >> 12u) & uvec4(0xFu)) / 15.0;
+		}
+	}
+	imageStore(img, ivec2(xy), c);
+}
+)";
+
 static int VkFormatBytesPerPixel(VkFormat format) {
 	switch (format) {
 	case VULKAN_8888_FORMAT: return 4;
@@ -116,6 +177,15 @@ static int VkFormatBytesPerPixel(VkFormat format) {
 	return 2;
 }
 
+static const VkComponentMapping *VkFormatComponentMapping(VkFormat format) {
+	switch (format) {
+	case VULKAN_4444_FORMAT: return &VULKAN_4444_SWIZZLE;
+	case VULKAN_1555_FORMAT: return &VULKAN_1555_SWIZZLE;
+	case VULKAN_565_FORMAT:  return &VULKAN_565_SWIZZLE;
+	default:                 return &VULKAN_8888_SWIZZLE;  // no swizzle
+	}
+}
+
 SamplerCache::~SamplerCache() {
 	DeviceLost();
 }
@@ -222,6 +292,8 @@ void TextureCacheVulkan::DeviceLost() {
 
 	if (uploadCS_ != VK_NULL_HANDLE)
 		vulkan->Delete().QueueDeleteShaderModule(uploadCS_);
+	if (decodeCS_ != VK_NULL_HANDLE)
+		vulkan->Delete().QueueDeleteShaderModule(decodeCS_);
 
 	computeShaderManager_.DeviceLost();
 
@@ -249,6 +321,7 @@ void TextureCacheVulkan::DeviceRestore(Draw::DrawContext *draw) {
 	_assert_(res == VK_SUCCESS);
 
 	CompileScalingShader();
+	CompileDecodeShader();
 
 	computeShaderManager_.DeviceRestore(draw);
 }
@@ -256,6 +329,7 @@ void TextureCacheVulkan::DeviceRestore(Draw::DrawContext *draw) {
 void TextureCacheVulkan::NotifyConfigChanged() {
 	TextureCacheCommon::NotifyConfigChanged();
 	CompileScalingShader();
+	CompileDecodeShader();
 }
 
 static std::string ReadShaderSrc(const Path &filename) {
@@ -301,6 +375,100 @@ void TextureCacheVulkan::CompileScalingShader() {
 	shaderScaleFactor_ = shaderInfo->scaleFactor;
 }
 
+void TextureCacheVulkan::CompileDecodeShader() {
+	VulkanContext *vulkan = (VulkanContext *)draw_->GetNativeObject(Draw::NativeObject::CONTEXT);
+
+	if (!g_Config.bTexComputeDecode) {
+		if (decodeCS_ != VK_NULL_HANDLE) {
+			vulkan->Delete().QueueDeleteShaderModule(decodeCS_);
+			decodeCS_ = VK_NULL_HANDLE;
+		}
+		return;
+	} else if (decodeCS_ != VK_NULL_HANDLE) {
+		return;
+	}
+
+	std::string error;
+	decodeCS_ = CompileShaderModule(vulkan, VK_SHADER_STAGE_COMPUTE_BIT, decodeShader, &error);
+	if (decodeCS_ == VK_NULL_HANDLE) {
+		ERROR_LOG(G3D, "Failed to compile texture decode shader, using CPU decoding: %s", error.c_str());
+	}
+}
+
+// Only plain non-CLUT formats are handled, and only when nothing else needs the CPU-decoded pixels.
+bool TextureCacheVulkan::CanDecodeWithCompute(const BuildTexturePlan &plan, const TexCacheEntry *entry) const {
+	if (decodeCS_ == VK_NULL_HANDLE)
+		return false;
+	if (plan.doReplace || plan.saveTexture || plan.scaleFactor > 1 || plan.depth != 1 || plan.decodeToClut8 || plan.baseLevelSrc != 0)
+		return false;
+
+	const GETextureFormat format = (GETextureFormat)entry->format;
+	switch (format) {
+	case GE_TFMT_5650:
+	case GE_TFMT_5551:
+	case GE_TFMT_4444:
+	case GE_TFMT_8888:
+		break;
+	default:
+		return false;
+	}
+
+	for (int i = 0; i < plan.levelsToLoad; i++) {
+		u32 texaddr = gstate.getTextureAddress(i);
+		// The CPU path flips swizzling for some VRAM mirrors, leave those to it.
+		if ((texaddr & 0x00600000) != 0 && Memory::IsVRAMAddress(texaddr))
+			return false;
+		int bufw = GetTextureBufw(i, texaddr, format);
+		int h = gstate.getTextureHeight(i);
+		u32 size = bufw * ((h + 7) & ~7) * (format == GE_TFMT_8888 ? 4 : 2);
+		if (!Memory::IsValidRange(texaddr, size))
+			return false;
+	}
+	return true;
+}
+
+void TextureCacheVulkan::DecodeLevelWithCompute(VkCommandBuffer cmd, TexCacheEntry *entry, int level, VulkanPushPool *pushBuffer) {
+	VulkanContext *vulkan = (VulkanContext *)draw_->GetNativeObject(Draw::NativeObject::CONTEXT);
+
+	const GETextureFormat format = (GETextureFormat)entry->format;
+	const u32 texaddr = gstate.getTextureAddress(level);
+	const int w = gstate.getTextureWidth(level);
+	const int h = gstate.getTextureHeight(level);
+	const int bufw = GetTextureBufw(level, texaddr, format);
+	const int bpp = format == GE_TFMT_8888 ? 4 : 2;
+	const bool swizzled = gstate.isTextureSwizzled();
+	// Swizzled data is always stored in whole blocks of 8 rows.
+	const u32 srcSize = bufw * bpp * (swizzled ? ((h + 7) & ~7) : h);
+
+	VkBuffer texBuf;
+	uint32_t bufferOffset;
+	// Bound as a storage buffer at this offset, so it has to meet the device's alignment.
+	int ssboAlignment = std::max(16, (int)vulkan->GetPhysicalDeviceProperties().properties.limits.minStorageBufferOffsetAlignment);
+	void *data = pushBuffer->Allocate(srcSize, ssboAlignment, &texBuf, &bufferOffset);
+	memcpy(data, Memory::GetPointerUnchecked(texaddr), srcSize);
+
+	// Alpha doesn't care about the pixel order, so we can check it on the raw data.
+	CheckAlphaResult alphaResult;
+	switch (format) {
+	case GE_TFMT_5650: alphaResult = CHECKALPHA_FULL; break;
+	case GE_TFMT_5551: alphaResult = CheckAlpha16((const u16 *)data, srcSize / 2, 0x8000); break;
+	case GE_TFMT_4444: alphaResult = CheckAlpha16((const u16 *)data, srcSize / 2, 0xF000); break;
+	default: alphaResult = CheckAlpha32((const u32 *)data, srcSize / 4, 0xFF000000); break;
+	}
+	entry->SetAlphaStatus(alphaResult, level);
+
+	VkImageView view = entry->vkTex->CreateViewForMip(level);
+	VkDescriptorSet descSet = computeShaderManager_.GetDescriptorSet(view, texBuf, bufferOffset, srcSize);
+	struct Params { u32 width; u32 height; u32 bufw; u32 fmtFlags; } params{ (u32)w, (u32)h, (u32)bufw, (u32)format | (swizzled ? 0x100 : 0) };
+	VK_PROFILE_BEGIN(vulkan, cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, "Compute Decode: %dx%d", w, h);
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeShaderManager_.GetPipeline(decodeCS_));
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeShaderManager_.GetPipelineLayout(), 0, 1, &descSet, 0, nullptr);
+	vkCmdPushConstants(cmd, computeShaderManager_.GetPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+	vkCmdDispatch(cmd, (w + 7) / 8, (h + 7) / 8, 1);
+	VK_PROFILE_END(vulkan, cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	vulkan->Delete().QueueDeleteImageView(view);
+}
+
 void TextureCacheVulkan::ReleaseTexture(TexCacheEntry *entry, bool delete_them) {
 	delete entry->vkTex;
 	entry->vkTex = nullptr;
@@ -465,6 +633,11 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 	}
 
 	bool computeUpload = false;
+	// Raw texture memory goes to the GPU and gets unswizzled and expanded there.
+	bool computeDecode = CanDecodeWithCompute(plan, entry);
+	if (computeDecode) {
+		actualFmt = VULKAN_8888_FORMAT;
+	}
 	VkCommandBuffer cmdInit = (VkCommandBuffer)draw_->GetNativeObject(Draw::NativeObject::INIT_COMMANDBUFFER);
 
 	delete entry->vkTex;
@@ -474,14 +647,6 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 	entry->vkTex = new VulkanTexture(vulkan, texName);
 	VulkanTexture *image = entry->vkTex;
 
-	const VkComponentMapping *mapping;
-	switch (actualFmt) {
-	case VULKAN_4444_FORMAT: mapping = &VULKAN_4444_SWIZZLE; break;
-	case VULKAN_1555_FORMAT: mapping = &VULKAN_1555_SWIZZLE; break;
-	case VULKAN_565_FORMAT:  mapping = &VULKAN_565_SWIZZLE;  break;
-	default:                 mapping = &VULKAN_8888_SWIZZLE; break;  // no swizzle
-	}
-
 	VkImageLayout imageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 	VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
@@ -493,7 +658,7 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 		}
 	}
 
-	if (computeUpload) {
+	if (computeUpload || computeDecode) {
 		usage |= VK_IMAGE_USAGE_STORAGE_BIT;
 		imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 	}
@@ -502,7 +667,7 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 		actualFmt = VULKAN_8888_FORMAT;
 	}
 
-	bool allocSuccess = image->CreateDirect(cmdInit, plan.createW, plan.createH, plan.depth, plan.levelsToCreate, actualFmt, imageLayout, usage, mapping);
+	bool allocSuccess = image->CreateDirect(cmdInit, plan.createW, plan.createH, plan.depth, plan.levelsToCreate, actualFmt, imageLayout, usage, VkFormatComponentMapping(actualFmt));
 	if (!allocSuccess && !lowMemoryMode_) {
 		WARN_LOG_REPORT(G3D, "Texture cache ran out of GPU memory; switching to low memory mode");
 		lowMemoryMode_ = true;
@@ -525,8 +690,10 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 		plan.createH /= plan.scaleFactor;
 		plan.scaleFactor = 1;
 		actualFmt = dstFmt;
+		computeDecode = false;
 
-		allocSuccess = image->CreateDirect(cmdInit, plan.createW, plan.createH, plan.depth, plan.levelsToCreate, actualFmt, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, mapping);
+		// The 16-bit formats need their own swizzle, so the mapping follows actualFmt.
+		allocSuccess = image->CreateDirect(cmdInit, plan.createW, plan.createH, plan.depth, plan.levelsToCreate, actualFmt, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VkFormatComponentMapping(actualFmt));
 	}
 
 	if (!allocSuccess) {
@@ -612,6 +779,8 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 				// 3D texturing.
 				loadLevel(uploadSize, i, byteStride, plan.scaleFactor);
 				entry->vkTex->CopyBufferToMipLevel(cmdInit, &copyBatch, 0, mipWidth, mipHeight, i, texBuf, bufferOffset, pixelStride);
+			} else if (computeDecode) {
+				DecodeLevelWithCompute(cmdInit, entry, i, pushBuffer);
 			} else if (computeUpload) {
 				int srcBpp = VkFormatBytesPerPixel(dstFmt);
 				int srcStride = mipUnscaledWidth * srcBpp;
@@ -660,14 +829,15 @@ void TextureCacheVulkan::BuildTexture(TexCacheEntry *const entry) {
 		VK_PROFILE_END(vulkan, cmdInit, VK_PIPELINE_STAGE_TRANSFER_BIT);
 	}
 
-	VkImageLayout layout = computeUpload ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-	VkPipelineStageFlags prevStage = computeUpload ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT;
+	const bool computeWritten = computeUpload || computeDecode;
+	VkImageLayout layout = computeWritten ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	VkPipelineStageFlags prevStage = computeWritten ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT;
 
 	// Generate any additional mipmap levels.
 	// This will transition the whole stack to GENERAL if it wasn't already.
 	if (plan.levelsToLoad < plan.levelsToCreate) {
 		VK_PROFILE_BEGIN(vulkan, cmdInit, VK_PIPELINE_STAGE_TRANSFER_BIT, "Mipgen up to level %d", plan.levelsToCreate);
-		entry->vkTex->GenerateMips(cmdInit, plan.levelsToLoad, computeUpload);
+		entry->vkTex->GenerateMips(cmdInit, plan.levelsToLoad, computeWritten);
 		layout = VK_IMAGE_LAYOUT_GENERAL;
 		prevStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 		VK_PROFILE_END(vulkan, cmdInit, VK_PIPELINE_STAGE_TRANSFER_BIT);
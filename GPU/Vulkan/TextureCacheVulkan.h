@@ -34,6 +34,7 @@ class DrawEngineVulkan;
 class VulkanContext;
 class VulkanTexture;
 class VulkanPushBuffer;
+class VulkanPushPool;
 
 class SamplerCache {
 public:
@@ -101,6 +102,9 @@ class TextureCacheVulkan : public TextureCacheCommon {
 	void BuildTexture(TexCacheEntry *const entry) override;
 
 	void CompileScalingShader();
+	void CompileDecodeShader();
+	bool CanDecodeWithCompute(const BuildTexturePlan &plan, const TexCacheEntry *entry) const;
+	void DecodeLevelWithCompute(VkCommandBuffer cmd, TexCacheEntry *entry, int level, VulkanPushPool *pushBuffer);
 
 	VulkanDeviceAllocator *allocator_ = nullptr;
 
@@ -112,6 +116,7 @@ class TextureCacheVulkan : public TextureCacheCommon {
 
 	std::string textureShader_;
 	VkShaderModule uploadCS_ = VK_NULL_HANDLE;
+	VkShaderModule decodeCS_ = VK_NULL_HANDLE;
 
 	// Bound state to emulate an API similar to the others
 	VkImageView imageView_ = VK_NULL_HANDLE;
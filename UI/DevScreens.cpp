@@ -850,7 +850,9 @@ void SystemInfoScreen::CreateTabs() {
 	IconCacheStats iconStats = g_iconCache.GetStats();
 	internals->Add(new InfoItem(si->T("Image data count"), StringFromFormat("%d", iconStats.cachedCount)));
 	internals->Add(new InfoItem(si->T("Texture count"), StringFromFormat("%d", iconStats.textureCount)));
+	internals->Add(new InfoItem(si->T("Unique image count"), StringFromFormat("%d", iconStats.uniqueCount)));
 	internals->Add(new InfoItem(si->T("Data size"), NiceSizeFormat(iconStats.dataSize)));
+	internals->Add(new InfoItem(si->T("Texture size"), NiceSizeFormat(iconStats.textureSize)));
 	internals->Add(new Choice(di->T("Clear")))->OnClick.Add([&](UI::EventParams &) {
 		g_iconCache.ClearData();
 		RecreateViews();
@@ -682,6 +682,7 @@ void NativeInit(int argc, const char *argv[], const char *savegame_dir, const ch
 						// Ignore and proceed.
 #else
 						// Bail.
+						LogManager::GetInstance()->Flush();
 						exit(1);
 #endif
 					}
@@ -692,6 +693,7 @@ void NativeInit(int argc, const char *argv[], const char *savegame_dir, const ch
 				// Ignore and proceed.
 #else
 				// Bail.
+				LogManager::GetInstance()->Flush();
 				exit(1);
 #endif
 			}
@@ -5,6 +5,8 @@
 // > --root pspautotests/tests/../ --compare --timeout=5 --graphics=software pspautotests/tests/cpu/cpu_alu/cpu_alu.prx
 
 #include "ppsspp_config.h"
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <limits>
@@ -22,6 +24,9 @@
 #include <timeapi.h>
 #else
 #include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 #include "Common/CPUDetect.h"
 #include "Common/File/VFS/VFS.h"
@@ -35,8 +40,12 @@
 #include "Core/ConfigValues.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/MemMap.h"
+#include "Core/PSPLoaders.h"
+#include "Core/Replay.h"
 #include "Core/System.h"
 #include "Core/WebServer.h"
+#include "Core/HLE/sceIo.h"
 #include "Core/HLE/sceUtility.h"
 #include "Core/SaveState.h"
 #include "GPU/Common/FramebufferManagerCommon.h"
@@ -173,6 +182,8 @@ int printUsage(const char *progname, const char *reason)
 	fprintf(stderr, "  -j                    use jit (default)\n");
 	fprintf(stderr, "  -c, --compare         compare with output in file.expected\n");
 	fprintf(stderr, "  --bench               run multiple times and output speed\n");
+	fprintf(stderr, "  --fork[=JOBS]         boot once, then run each --replay in a forked copy\n");
+	fprintf(stderr, "  --replay=FILE         replay to run with --fork, or @listfile\n");
 	fprintf(stderr, "\nSee headless.txt for details.\n");
 
 	return 1;
@@ -294,6 +305,202 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, const
 	return passed;
 }
 
+#if !PPSSPP_PLATFORM(WINDOWS)
+struct ForkedScenario {
+	pid_t pid;
+	int fd;
+	std::string name;
+	std::string output;
+};
+
+// Runs in the child process, never returns.
+static void RunForkedScenario(HeadlessHost *headlessHost, const AutoTestOptions &opt, const Path &replay, std::string &output) {
+	if (!Memory::MemoryMap_Unshare(0)) {
+		printf("Unable to give the forked emulator its own memory\n");
+		fflush(stdout);
+		_exit(2);
+	}
+	g_threadManager.Init(cpu_info.num_cores, cpu_info.logical_cpu_count);
+
+	// Only compare what happens after the checkpoint.
+	output.clear();
+	if (!ReplayExecuteFile(replay)) {
+		printf("Unable to load replay %s\n", replay.c_str());
+		fflush(stdout);
+		_exit(2);
+	}
+
+	// Keep running a second after the last input, so it can have some effect.
+	bool passed = true;
+	u64 endTicks = 0;
+	double deadline = time_now_d() + opt.timeout;
+	PSP_BeginHostFrame();
+	while (coreState == CORE_RUNNING || coreState == CORE_NEXTFRAME) {
+		PSP_RunLoopFor((int)usToCycles(1000000 / 10));
+		if (coreState == CORE_NEXTFRAME) {
+			coreState = CORE_RUNNING;
+			headlessHost->SwapBuffers();
+		}
+		if (endTicks == 0 && !ReplayHasMoreEvents())
+			endTicks = CoreTiming::GetTicks() + usToCycles(1000000);
+		if (endTicks != 0 && CoreTiming::GetTicks() >= endTicks)
+			break;
+		if (time_now_d() > deadline) {
+			System_SendDebugOutput("TIMEOUT\n");
+			passed = false;
+			break;
+		}
+	}
+	PSP_EndHostFrame();
+
+	if (coreState == CORE_RUNTIME_ERROR || coreState == CORE_BOOT_ERROR)
+		passed = false;
+	if (!opt.bench)
+		headlessHost->FlushDebugOutput();
+	if (opt.compare && passed)
+		passed = CompareOutput(replay, output, opt.verbose);
+
+	// Skip global destructors, the parent still owns everything shared.
+	fflush(stdout);
+	fflush(stderr);
+	_exit(passed ? 0 : 1);
+}
+
+static void FinishForkedScenario(ForkedScenario &scenario, std::vector<std::string> &passedTests, std::vector<std::string> &failedTests) {
+	close(scenario.fd);
+	int status = 0;
+	while (waitpid(scenario.pid, &status, 0) < 0 && errno == EINTR)
+		continue;
+
+	bool passed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	printf("%s:\n%s", scenario.name.c_str(), scenario.output.c_str());
+	if (passed) {
+		passedTests.push_back(scenario.name);
+		printf("  %s - passed!\n", scenario.name.c_str());
+	} else {
+		failedTests.push_back(scenario.name);
+		if (WIFSIGNALED(status))
+			printf("  %s - crashed (signal %d)\n", scenario.name.c_str(), WTERMSIG(status));
+	}
+	fflush(stdout);
+}
+
+// Reads output from running scenarios until at least one of them exits.
+static void WaitForForkedScenarios(std::vector<ForkedScenario> &running, std::vector<std::string> &passedTests, std::vector<std::string> &failedTests) {
+	std::vector<pollfd> fds(running.size());
+	for (size_t i = 0; i < running.size(); ++i)
+		fds[i] = { running[i].fd, POLLIN, 0 };
+	while (poll(fds.data(), fds.size(), -1) < 0 && errno == EINTR)
+		continue;
+
+	for (size_t i = running.size(); i-- > 0; ) {
+		if (fds[i].revents == 0)
+			continue;
+		char buf[4096];
+		ssize_t len = read(running[i].fd, buf, sizeof(buf));
+		if (len > 0) {
+			running[i].output.append(buf, len);
+		} else if (len == 0 || errno != EINTR) {
+			FinishForkedScenario(running[i], passedTests, failedTests);
+			running.erase(running.begin() + i);
+		}
+	}
+}
+
+// Boots once, gets to the checkpoint, and then forks a copy of the emulator per replay.
+// Each child has its own copy of PSP memory, everything else is copy-on-write.
+static bool RunForkedScenarios(HeadlessHost *headlessHost, CoreParameter &coreParameter, const AutoTestOptions &opt, const char *stateToLoad, const std::vector<std::string> &replays, int jobs, std::vector<std::string> &passedTests, std::vector<std::string> &failedTests) {
+	std::string output;
+	coreParameter.collectDebugOutput = &output;
+
+	std::string error_string;
+	if (!PSP_InitStart(coreParameter, &error_string)) {
+		fprintf(stderr, "Failed to start '%s'. Error: %s\n", coreParameter.fileToStart.c_str(), error_string.c_str());
+		return false;
+	}
+	while (!PSP_InitUpdate(&error_string))
+		sleep_ms(1);
+	if (!PSP_IsInited()) {
+		fprintf(stderr, "Failed to start '%s'. Error: %s\n", coreParameter.fileToStart.c_str(), error_string.c_str());
+		return false;
+	}
+	System_Notify(SystemNotification::BOOT_DONE);
+
+	if (g_Config.bSeparateSASThread) {
+		// Could've been turned back on by a game config.
+		fprintf(stderr, "The SAS thread is enabled, can't fork\n");
+		PSP_Shutdown();
+		return false;
+	}
+
+	coreState = CORE_RUNNING;
+	if (stateToLoad) {
+		bool loaded = false;
+		bool loadFailed = false;
+		SaveState::Load(Path(stateToLoad), -1, [&](SaveState::Status status, const std::string &message, void *) {
+			loaded = true;
+			loadFailed = status == SaveState::Status::FAILURE;
+		});
+		PSP_BeginHostFrame();
+		while (!loaded && (coreState == CORE_RUNNING || coreState == CORE_NEXTFRAME)) {
+			PSP_RunLoopFor((int)usToCycles(1000000 / 10));
+			if (coreState == CORE_NEXTFRAME)
+				coreState = CORE_RUNNING;
+		}
+		PSP_EndHostFrame();
+		if (!loaded || loadFailed) {
+			fprintf(stderr, "Failed to load state '%s'\n", stateToLoad);
+			PSP_Shutdown();
+			return false;
+		}
+	}
+
+	// fork() only copies the calling thread, so stop the others until the children are running.
+	PSPLoaders_Shutdown();
+	__IoStopManagerThread();
+	g_threadManager.Teardown();
+
+	std::vector<ForkedScenario> running;
+	for (const std::string &replay : replays) {
+		while ((int)running.size() >= jobs)
+			WaitForForkedScenarios(running, passedTests, failedTests);
+
+		int pipefd[2];
+		if (pipe(pipefd) != 0) {
+			perror("pipe");
+			failedTests.push_back(replay);
+			continue;
+		}
+
+		fflush(stdout);
+		fflush(stderr);
+		pid_t pid = fork();
+		if (pid == 0) {
+			close(pipefd[0]);
+			dup2(pipefd[1], STDOUT_FILENO);
+			dup2(pipefd[1], STDERR_FILENO);
+			close(pipefd[1]);
+			RunForkedScenario(headlessHost, opt, Path(replay), output);
+		}
+
+		close(pipefd[1]);
+		if (pid < 0) {
+			perror("fork");
+			close(pipefd[0]);
+			failedTests.push_back(replay);
+			continue;
+		}
+		running.push_back({ pid, pipefd[0], replay });
+	}
+	while (!running.empty())
+		WaitForForkedScenarios(running, passedTests, failedTests);
+
+	g_threadManager.Init(cpu_info.num_cores, cpu_info.logical_cpu_count);
+	PSP_Shutdown();
+	return true;
+}
+#endif
+
 std::vector<std::string> ReadFromListFile(const std::string &listFilename) {
 	std::vector<std::string> testFilenames;
 	char temp[2048]{};
@@ -339,8 +546,10 @@ int main(int argc, const char* argv[])
 	GPUCore gpuCore = GPUCORE_SOFTWARE;
 	CPUCore cpuCore = CPUCore::JIT;
 	int debuggerPort = -1;
+	int forkJobs = 0;
 
 	std::vector<std::string> testFilenames;
+	std::vector<std::string> replayFilenames;
 	const char *mountIso = nullptr;
 	const char *mountRoot = nullptr;
 	const char *screenshotFilename = nullptr;
@@ -411,6 +620,19 @@ int main(int argc, const char* argv[])
 			teamCityMode = true;
 		else if (!strncmp(argv[i], "--state=", strlen("--state=")) && strlen(argv[i]) > strlen("--state="))
 			stateToLoad = argv[i] + strlen("--state=");
+		else if (!strcmp(argv[i], "--fork"))
+			forkJobs = cpu_info.num_cores;
+		else if (!strncmp(argv[i], "--fork=", strlen("--fork=")) && strlen(argv[i]) > strlen("--fork="))
+			forkJobs = std::max(1, (int)strtol(argv[i] + strlen("--fork="), nullptr, 10));
+		else if (!strncmp(argv[i], "--replay=", strlen("--replay=")) && strlen(argv[i]) > strlen("--replay=")) {
+			const char *replayName = argv[i] + strlen("--replay=");
+			if (replayName[0] == '@') {
+				std::vector<std::string> list = ReadFromListFile(replayName + 1);
+				replayFilenames.insert(replayFilenames.end(), list.begin(), list.end());
+			} else {
+				replayFilenames.push_back(replayName);
+			}
+		}
 		else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h"))
 			return printUsage(argv[0], NULL);
 		else
@@ -422,6 +644,19 @@ int main(int argc, const char* argv[])
 
 	if (testFilenames.empty())
 		return printUsage(argv[0], argc <= 1 ? NULL : "No executables specified");
+	if (forkJobs > 0) {
+#if PPSSPP_PLATFORM(WINDOWS)
+		return printUsage(argv[0], "--fork is not supported on Windows");
+#endif
+		if (testFilenames.size() != 1)
+			return printUsage(argv[0], "--fork needs exactly one executable");
+		if (replayFilenames.empty())
+			return printUsage(argv[0], "--fork needs at least one --replay");
+		if (gpuCore != GPUCORE_SOFTWARE)
+			return printUsage(argv[0], "--fork only works with --graphics=software");
+		if (debuggerPort > 0)
+			return printUsage(argv[0], "--fork can't be used with --debugger");
+	}
 
 	LogManager::Init(&g_Config.bEnableLogging);
 	LogManager *logman = LogManager::GetInstance();
@@ -499,6 +734,9 @@ int main(int argc, const char* argv[])
 	g_Config.iGlobalVolume = VOLUME_FULL;
 	g_Config.iReverbVolume = VOLUME_FULL;
 	g_Config.internalDataDirectory.clear();
+	// A forked copy only gets the thread that called fork().
+	if (forkJobs > 0)
+		g_Config.bSeparateSASThread = false;
 
 	Path exePath = File::GetExeDirectory();
 	g_Config.flash0Directory = exePath / "assets/flash0";
@@ -556,11 +794,20 @@ int main(int argc, const char* argv[])
 		StartWebServer(WebServerFlags::DEBUGGER);
 	}
 
-	if (stateToLoad != NULL)
-		SaveState::Load(Path(stateToLoad), -1);
-
 	std::vector<std::string> failedTests;
 	std::vector<std::string> passedTests;
+#if !PPSSPP_PLATFORM(WINDOWS)
+	if (forkJobs > 0) {
+		coreParameter.fileToStart = Path(testFilenames[0]);
+		if (!RunForkedScenarios(headlessHost, coreParameter, testOptions, stateToLoad, replayFilenames, forkJobs, passedTests, failedTests))
+			failedTests.push_back(GetTestName(coreParameter.fileToStart));
+		testFilenames.clear();
+	}
+#endif
+
+	if (stateToLoad != NULL && forkJobs == 0)
+		SaveState::Load(Path(stateToLoad), -1);
+
 	for (size_t i = 0; i < testFilenames.size(); ++i)
 	{
 		coreParameter.fileToStart = Path(testFilenames[i]);
@@ -594,7 +841,7 @@ int main(int argc, const char* argv[])
 		}
 	}
 
-	if (testOptions.compare) {
+	if (testOptions.compare || forkJobs > 0) {
 		printf("%d tests passed, %d tests failed.\n", (int)passedTests.size(), (int)failedTests.size());
 		if (!failedTests.empty())
 		{
@@ -16,12 +16,15 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <cstring>
+#include <initializer_list>
 
 #include "ppsspp_config.h"
 
 #include "Common/System/NativeApp.h"
 #include "Common/System/System.h"
 #include "Common/TimeUtil.h"
+#include "Core/Config.h"
 #include "Core/ConfigValues.h"
 #include "Core/Debugger/SymbolMap.h"
 #include "Core/MIPS/JitCommon/JitCommon.h"
@@ -35,6 +38,7 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
+#include "Core/System.h"
 
 // Temporary hacks around annoying linking errors.  Copied from Headless.
 void NativeFrame(GraphicsContext *graphicsContext) { }
@@ -198,3 +202,232 @@ bool TestJit() {
 
 	return jit_speed >= interp_speed;
 }
+
+#define MAKE_ADDU(rd, rs, rt) (((rs) << 21) | ((rt) << 16) | ((rd) << 11) | 33)
+#define MAKE_SUBU(rd, rs, rt) (((rs) << 21) | ((rt) << 16) | ((rd) << 11) | 35)
+
+struct InterpretState {
+	u32 r[32];
+	u32 pc;
+	int downcount;
+	bool inDelaySlot;
+	CoreState state;
+};
+
+static u32 FusionCodeAddress() {
+	return PSP_GetUserMemoryBase();
+}
+
+static u32 FusionDataAddress() {
+	return PSP_GetUserMemoryBase() + 0x10000;
+}
+
+static void WriteFusionCode(std::initializer_list<u32> ops) {
+	u32 addr = FusionCodeAddress();
+	for (u32 op : ops) {
+		Memory::Write_U32(op, addr);
+		addr += 4;
+	}
+	Memory::Write_U32(MIPS_MAKE_SYSCALL("UnitTestFakeSyscalls", "UnitTestTerminator"), addr);
+	Memory::Write_U32(MIPS_MAKE_BREAK(1), addr + 4);
+}
+
+static void ResetInterpretState(int downcount) {
+	for (int i = 0; i < 32; ++i)
+		mipsr4k.r[i] = 0x01010101 * i;
+	mipsr4k.r[MIPS_REG_A0] = FusionDataAddress();
+	mipsr4k.pc = FusionCodeAddress();
+	mipsr4k.nextPC = 0;
+	mipsr4k.inDelaySlot = false;
+	mipsr4k.downcount = downcount;
+
+	// A pointer to the next word, then some values.
+	Memory::Write_U32(FusionDataAddress() + 4, FusionDataAddress());
+	Memory::Write_U32(0x12345678, FusionDataAddress() + 4);
+	Memory::Write_U32(0x0BADF00D, FusionDataAddress() + 8);
+
+	coreState = CORE_RUNNING;
+	coreStatePending = false;
+}
+
+static void RunInterpretSlice(InterpretState &result, int downcount, bool useCache, void (*setup)()) {
+	ResetInterpretState(downcount);
+	if (setup)
+		setup();
+	MIPSInterpret_RunSliceForTest(useCache);
+
+	memcpy(result.r, mipsr4k.r, sizeof(result.r));
+	result.pc = mipsr4k.pc;
+	result.downcount = mipsr4k.downcount;
+	result.inDelaySlot = mipsr4k.inDelaySlot;
+	result.state = coreState;
+}
+
+static bool CompareInterpretState(const char *name, const char *run, const InterpretState &expected, const InterpretState &actual) {
+	bool success = true;
+	for (int i = 0; i < 32; ++i) {
+		if (expected.r[i] != actual.r[i]) {
+			printf("%s (%s): r%d is %08x, expected %08x\n", name, run, i, actual.r[i], expected.r[i]);
+			success = false;
+		}
+	}
+	if (expected.pc != actual.pc) {
+		printf("%s (%s): pc is %08x, expected %08x\n", name, run, actual.pc, expected.pc);
+		success = false;
+	}
+	if (expected.downcount != actual.downcount) {
+		printf("%s (%s): downcount is %d, expected %d\n", name, run, actual.downcount, expected.downcount);
+		success = false;
+	}
+	if (expected.inDelaySlot != actual.inDelaySlot || expected.state != actual.state) {
+		printf("%s (%s): ended in a different delay slot or core state\n", name, run);
+		success = false;
+	}
+	return success;
+}
+
+// Runs the code currently in memory without the decoded instruction cache, and then with it both
+// cold and warm, which must all end in the same state.
+static bool CompareFusion(const char *name, int downcount = 1000, void (*setup)() = nullptr) {
+	InterpretState expected, cold, warm;
+	RunInterpretSlice(expected, downcount, false, setup);
+	RunInterpretSlice(cold, downcount, true, setup);
+	RunInterpretSlice(warm, downcount, true, setup);
+
+	bool success = CompareInterpretState(name, "cold", expected, cold);
+	success = CompareInterpretState(name, "warm", expected, warm) && success;
+	return success;
+}
+
+static void SetupBadPointer() {
+	mipsr4k.r[MIPS_REG_A1] = 0;
+}
+
+static bool TestInterpreterFusionCases() {
+	bool success = true;
+
+	// Writes to $zr, from either half of the pair.
+	WriteFusionCode({
+		MIPS_MAKE_LUI(MIPS_REG_T0, 0x1234),
+		MIPS_MAKE_ADDIU(MIPS_REG_ZERO, MIPS_REG_T0, 0x5678),
+		MIPS_MAKE_LUI(MIPS_REG_ZERO, 0x4321),
+		MIPS_MAKE_ORI(MIPS_REG_T1, MIPS_REG_ZERO, 0x0010),
+		MIPS_MAKE_LW(MIPS_REG_ZERO, MIPS_REG_A0, 4),
+		MAKE_ADDU(MIPS_REG_V0, MIPS_REG_ZERO, MIPS_REG_A1),
+		MIPS_MAKE_LW(MIPS_REG_T2, MIPS_REG_A0, 4),
+		MAKE_ADDU(MIPS_REG_ZERO, MIPS_REG_T2, MIPS_REG_A1),
+	});
+	success = CompareFusion("zr destination") && success;
+
+	// Plain pairs, including lw and addu reading and writing their own base.
+	WriteFusionCode({
+		MIPS_MAKE_LUI(MIPS_REG_T0, 0x8000),
+		MIPS_MAKE_ADDIU(MIPS_REG_T0, MIPS_REG_T0, 0xFFFF),
+		MIPS_MAKE_LUI(MIPS_REG_T1, 0x0001),
+		MIPS_MAKE_ORI(MIPS_REG_T2, MIPS_REG_T1, 0xFFFF),
+		MIPS_MAKE_LW(MIPS_REG_T3, MIPS_REG_A0, 8),
+		MAKE_ADDU(MIPS_REG_T3, MIPS_REG_T3, MIPS_REG_A0),
+		MIPS_MAKE_LW(MIPS_REG_A0, MIPS_REG_A0, 0),
+		MAKE_ADDU(MIPS_REG_A0, MIPS_REG_A0, MIPS_REG_A0),
+	});
+	success = CompareFusion("base is destination") && success;
+
+	// A bad lw has to stop before the addu runs.
+	bool ignoreBadMemAccess = g_Config.bIgnoreBadMemAccess;
+	g_Config.bIgnoreBadMemAccess = false;
+	WriteFusionCode({
+		MIPS_MAKE_LW(MIPS_REG_T0, MIPS_REG_A1, 0),
+		MAKE_ADDU(MIPS_REG_V0, MIPS_REG_A2, MIPS_REG_A3),
+	});
+	success = CompareFusion("faulting lw", 1000, &SetupBadPointer) && success;
+	g_Config.bIgnoreBadMemAccess = ignoreBadMemAccess;
+
+	// The slice can end between the two, at any point.
+	WriteFusionCode({
+		MIPS_MAKE_NOP(),
+		MIPS_MAKE_LUI(MIPS_REG_T0, 0x1234),
+		MIPS_MAKE_ADDIU(MIPS_REG_T0, MIPS_REG_T0, 0x5678),
+		MIPS_MAKE_LW(MIPS_REG_T1, MIPS_REG_A0, 4),
+		MAKE_ADDU(MIPS_REG_T2, MIPS_REG_T1, MIPS_REG_T1),
+	});
+	for (int downcount = 0; downcount < 6; ++downcount) {
+		char name[64];
+		snprintf(name, sizeof(name), "slice end, downcount %d", downcount);
+		success = CompareFusion(name, downcount) && success;
+	}
+
+	// A pair starting in a delay slot must not run the second, the branch skips it.
+	WriteFusionCode({
+		MIPS_MAKE_B(2),
+		MIPS_MAKE_LW(MIPS_REG_T0, MIPS_REG_A0, 4),
+		MAKE_ADDU(MIPS_REG_T1, MIPS_REG_T0, MIPS_REG_T0),
+		MAKE_ADDU(MIPS_REG_T2, MIPS_REG_T0, MIPS_REG_A1),
+		MIPS_MAKE_B(2),
+		MIPS_MAKE_LUI(MIPS_REG_T3, 0x1234),
+		MIPS_MAKE_ADDIU(MIPS_REG_T3, MIPS_REG_T3, 0x5678),
+		MIPS_MAKE_NOP(),
+	});
+	success = CompareFusion("delay slot") && success;
+
+	// Cache the pair, then rewrite the second word: first with another addu, then with something else.
+	WriteFusionCode({
+		MIPS_MAKE_LW(MIPS_REG_T0, MIPS_REG_A0, 4),
+		MAKE_ADDU(MIPS_REG_T1, MIPS_REG_T0, MIPS_REG_T0),
+	});
+	success = CompareFusion("before rewrite") && success;
+	Memory::Write_U32(MAKE_ADDU(MIPS_REG_T2, MIPS_REG_T0, MIPS_REG_A1), FusionCodeAddress() + 4);
+	success = CompareFusion("rewritten addu") && success;
+	Memory::Write_U32(MAKE_SUBU(MIPS_REG_T2, MIPS_REG_T0, MIPS_REG_A1), FusionCodeAddress() + 4);
+	success = CompareFusion("rewritten to subu") && success;
+	Memory::Write_U32(MIPS_MAKE_LUI(MIPS_REG_T0, 0x1234), FusionCodeAddress());
+	Memory::Write_U32(MIPS_MAKE_ORI(MIPS_REG_T0, MIPS_REG_T0, 0x5678), FusionCodeAddress() + 4);
+	success = CompareFusion("rewritten to lui") && success;
+	Memory::Write_U32(MIPS_MAKE_ORI(MIPS_REG_T1, MIPS_REG_T0, 0x5678), FusionCodeAddress() + 4);
+	success = CompareFusion("rewritten ori") && success;
+
+	return success;
+}
+
+static double ExecInterpretSlices(bool useCache, int instructions) {
+	int total = 0;
+	double st = time_now_d();
+	do {
+		for (int j = 0; j < 100; ++j) {
+			ResetInterpretState(0x7FFFFFFF);
+			MIPSInterpret_RunSliceForTest(useCache);
+			++total;
+		}
+	} while (time_now_d() - st < 0.25);
+	double elapsed = time_now_d() - st;
+
+	return (double)total * instructions / elapsed;
+}
+
+bool TestInterpreterFusion() {
+	SetupJitHarness();
+
+	bool success = TestInterpreterFusionCases();
+
+	// Only for comparing by eye, timing on CI machines is too noisy to fail on.
+	const int pairs = 1024;
+	u32 addr = FusionCodeAddress();
+	for (int i = 0; i < pairs; ++i) {
+		if (i & 1) {
+			Memory::Write_U32(MIPS_MAKE_LUI(MIPS_REG_T0, i), addr);
+			Memory::Write_U32(MIPS_MAKE_ADDIU(MIPS_REG_T1, MIPS_REG_T0, i), addr + 4);
+		} else {
+			Memory::Write_U32(MIPS_MAKE_LW(MIPS_REG_T2, MIPS_REG_A0, 4), addr);
+			Memory::Write_U32(MAKE_ADDU(MIPS_REG_T3, MIPS_REG_T3, MIPS_REG_T2), addr + 4);
+		}
+		addr += 8;
+	}
+	Memory::Write_U32(MIPS_MAKE_SYSCALL("UnitTestFakeSyscalls", "UnitTestTerminator"), addr);
+	Memory::Write_U32(MIPS_MAKE_BREAK(1), addr + 4);
+
+	double plainSpeed = ExecInterpretSlices(false, pairs * 2 + 1);
+	double cachedSpeed = ExecInterpretSlices(true, pairs * 2 + 1);
+	printf("Interpreter: %0.1f M instructions/s plain, %0.1f M instructions/s cached and fused (%0.2fx)\n", plainSpeed / 1000000.0, cachedSpeed / 1000000.0, cachedSpeed / plainSpeed);
+
+	DestroyJitHarness();
+	return success;
+}
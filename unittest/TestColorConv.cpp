@@ -0,0 +1,256 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/TimeUtil.h"
+#include "Common/Data/Convert/ColorConv.h"
+
+#include "UnitTest.h"
+
+static u32 SwapRB(u32 c) {
+	return (c & 0xFF00FF00) | ((c >> 16) & 0xFF) | ((c & 0xFF) << 16);
+}
+
+static u32 RefBGR565ToRGBA8888(u16 c) {
+	return SwapRB(RGB565ToRGBA8888(c));
+}
+
+static u32 RefABGR1555ToRGBA8888(u16 c) {
+	u32 r = Convert5To8((c >> 11) & 0x1F);
+	u32 g = Convert5To8((c >> 6) & 0x1F);
+	u32 b = Convert5To8((c >> 1) & 0x1F);
+	u32 a = (c & 1) ? 0xFF : 0;
+	return (a << 24) | (b << 16) | (g << 8) | r;
+}
+
+static u32 RefABGR4444ToRGBA8888(u16 c) {
+	u16 swapped = (u16)(((c >> 12) & 0x000F) | ((c >> 4) & 0x00F0) | ((c << 4) & 0x0F00) | ((c << 12) & 0xF000));
+	return RGBA4444ToRGBA8888(swapped);
+}
+
+typedef void (*Convert16To32Func)(u32 *dst, const u16 *src, u32 numPixels);
+typedef void (*Convert32To16Func)(u16 *dst, const u32 *src, u32 numPixels);
+typedef void (*Convert16To16Func)(u16 *dst, const u16 *src, u32 numPixels);
+
+// Runs the check with every SIMD level this CPU has, by hiding features from the dispatchers.
+template <typename F>
+static bool ForEachLevel(F check) {
+	const bool hasAVX2 = cpu_info.bAVX2;
+	const bool hasSSSE3 = cpu_info.bSSSE3;
+	bool success = check();
+	if (hasAVX2) {
+		cpu_info.bAVX2 = false;
+		success = check() && success;
+	}
+	if (hasSSSE3) {
+		cpu_info.bSSSE3 = false;
+		success = check() && success;
+	}
+	cpu_info.bAVX2 = hasAVX2;
+	cpu_info.bSSSE3 = hasSSSE3;
+	return success;
+}
+
+// Every 16-bit input, at a few misalignments so that both the vector body and the scalar tail get used.
+template <typename Ref>
+static bool CheckConvert16To32(const char *name, Convert16To32Func func, Ref ref) {
+	return ForEachLevel([&]() {
+		std::vector<u16> src(65536 + 8);
+		std::vector<u32> dst(65536 + 8);
+		for (int offset = 0; offset < 4; ++offset) {
+			const u32 count = 65536 - offset * 3;
+			for (u32 i = 0; i < count; ++i)
+				src[offset + i] = (u16)(i + offset * 0x1111);
+			func(&dst[offset], &src[offset], count);
+			for (u32 i = 0; i < count; ++i) {
+				u32 expected = ref(src[offset + i]);
+				if (dst[offset + i] != expected) {
+					printf("%s: %04x -> %08x, expected %08x (offset %d, AVX2 %d)\n", name, src[offset + i], dst[offset + i], expected, offset, (int)cpu_info.bAVX2);
+					return false;
+				}
+			}
+		}
+		return true;
+	});
+}
+
+static u32 NextRandom(u32 &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed;
+}
+
+// Every value of each byte lane, plus a few million random pixels.
+template <typename Ref>
+static bool CheckConvert32To16(const char *name, Convert32To16Func func, Ref ref) {
+	return ForEachLevel([&]() {
+		const u32 count = 1 << 20;
+		std::vector<u32> src(count + 8);
+		std::vector<u16> dst(count + 8);
+		u32 seed = 1234;
+		for (int offset = 0; offset < 4; ++offset) {
+			const u32 n = count - offset * 3;
+			for (u32 i = 0; i < n; ++i) {
+				u32 c = NextRandom(seed);
+				if (i < 256 * 4)
+					c = (i & 0xFF) << ((i >> 8) * 8);
+				src[offset + i] = c;
+			}
+			func(&dst[offset], &src[offset], n);
+			for (u32 i = 0; i < n; ++i) {
+				u16 expected = ref(src[offset + i]);
+				if (dst[offset + i] != expected) {
+					printf("%s: %08x -> %04x, expected %04x (offset %d, AVX2 %d)\n", name, src[offset + i], dst[offset + i], expected, offset, (int)cpu_info.bAVX2);
+					return false;
+				}
+			}
+		}
+		return true;
+	});
+}
+
+template <typename Ref>
+static bool CheckConvert16To16(const char *name, Convert16To16Func func, Ref ref) {
+	return ForEachLevel([&]() {
+		std::vector<u16> src(65536 + 8);
+		std::vector<u16> dst(65536 + 8);
+		for (int offset = 0; offset < 4; ++offset) {
+			const u32 count = 65536 - offset * 3;
+			for (u32 i = 0; i < count; ++i)
+				src[offset + i] = (u16)(i + offset * 0x1111);
+			func(&dst[offset], &src[offset], count);
+			for (u32 i = 0; i < count; ++i) {
+				u16 expected = ref(src[offset + i]);
+				if (dst[offset + i] != expected) {
+					printf("%s: %04x -> %04x, expected %04x (offset %d)\n", name, src[offset + i], dst[offset + i], expected, offset);
+					return false;
+				}
+			}
+			// These are used in place, too.
+			func(&src[offset], &src[offset], count);
+			if (memcmp(&src[offset], &dst[offset], count * sizeof(u16)) != 0) {
+				printf("%s: in place conversion differs (offset %d)\n", name, offset);
+				return false;
+			}
+		}
+		return true;
+	});
+}
+
+static bool CheckConvert32To32() {
+	return ForEachLevel([&]() {
+		const u32 count = 4096;
+		std::vector<u32> src(count + 8);
+		std::vector<u32> dst(count + 8);
+		std::vector<u8> dst24(count * 3 + 8);
+		u32 seed = 5678;
+		for (int offset = 0; offset < 4; ++offset) {
+			const u32 n = count - offset * 3;
+			for (u32 i = 0; i < n; ++i)
+				src[offset + i] = NextRandom(seed);
+
+			ConvertBGRA8888ToRGBA8888(&dst[offset], &src[offset], n);
+			for (u32 i = 0; i < n; ++i) {
+				if (dst[offset + i] != SwapRB(src[offset + i])) {
+					printf("BGRA8888ToRGBA8888: %08x -> %08x (offset %d)\n", src[offset + i], dst[offset + i], offset);
+					return false;
+				}
+			}
+
+			ConvertRGBA8888ToRGB888(&dst24[offset], &src[offset], n);
+			for (u32 i = 0; i < n; ++i) {
+				if (memcmp(&dst24[offset + i * 3], &src[offset + i], 3) != 0) {
+					printf("RGBA8888ToRGB888: mismatch at %d (offset %d)\n", i, offset);
+					return false;
+				}
+			}
+
+			ConvertBGRA8888ToRGB888(&dst24[offset], &src[offset], n);
+			for (u32 i = 0; i < n; ++i) {
+				u32 swapped = SwapRB(src[offset + i]);
+				if (memcmp(&dst24[offset + i * 3], &swapped, 3) != 0) {
+					printf("BGRA8888ToRGB888: mismatch at %d (offset %d)\n", i, offset);
+					return false;
+				}
+			}
+		}
+		return true;
+	});
+}
+
+// Prints throughput for a typical readback (480x272) next to a plain per-pixel loop.
+template <typename Dst, typename Src, typename Func, typename Ref>
+static void BenchmarkConvert(const char *name, Func func, Ref ref) {
+	const u32 count = 480 * 272;
+	const int iterations = 200;
+	std::vector<Src> src(count);
+	std::vector<Dst> dst(count);
+	u32 seed = 42;
+	for (u32 i = 0; i < count; ++i)
+		src[i] = (Src)NextRandom(seed);
+
+	double start = time_now_d();
+	for (int j = 0; j < iterations; ++j)
+		func(dst.data(), src.data(), count);
+	double simd = time_now_d() - start;
+
+	start = time_now_d();
+	for (int j = 0; j < iterations; ++j) {
+		Dst *d = dst.data();
+		const Src *s = src.data();
+		for (u32 i = 0; i < count; ++i)
+			d[i] = (Dst)ref(s[i]);
+	}
+	double scalar = time_now_d() - start;
+
+	const double mpix = (double)count * iterations / 1000000.0;
+	printf("%-22s %8.1f Mpix/s (per-pixel: %8.1f Mpix/s)\n", name, mpix / simd, mpix / scalar);
+}
+
+bool TestColorConv() {
+	bool success = true;
+	success = CheckConvert16To32("RGB565ToRGBA8888", &ConvertRGB565ToRGBA8888, &RGB565ToRGBA8888) && success;
+	success = CheckConvert16To32("RGBA5551ToRGBA8888", &ConvertRGBA5551ToRGBA8888, &RGBA5551ToRGBA8888) && success;
+	success = CheckConvert16To32("RGBA4444ToRGBA8888", &ConvertRGBA4444ToRGBA8888, &RGBA4444ToRGBA8888) && success;
+	success = CheckConvert16To32("BGR565ToRGBA8888", &ConvertBGR565ToRGBA8888, &RefBGR565ToRGBA8888) && success;
+	success = CheckConvert16To32("ABGR1555ToRGBA8888", &ConvertABGR1555ToRGBA8888, &RefABGR1555ToRGBA8888) && success;
+	success = CheckConvert16To32("ABGR4444ToRGBA8888", &ConvertABGR4444ToRGBA8888, &RefABGR4444ToRGBA8888) && success;
+	success = CheckConvert16To32("RGB565ToBGRA8888", &ConvertRGB565ToBGRA8888, [](u16 c) { return SwapRB(RGB565ToRGBA8888(c)); }) && success;
+	success = CheckConvert16To32("RGBA5551ToBGRA8888", &ConvertRGBA5551ToBGRA8888, [](u16 c) { return SwapRB(RGBA5551ToRGBA8888(c)); }) && success;
+	success = CheckConvert16To32("RGBA4444ToBGRA8888", &ConvertRGBA4444ToBGRA8888, [](u16 c) { return SwapRB(RGBA4444ToRGBA8888(c)); }) && success;
+
+	success = CheckConvert32To16("RGBA8888ToRGB565", &ConvertRGBA8888ToRGB565, &RGBA8888toRGB565) && success;
+	success = CheckConvert32To16("RGBA8888ToRGBA5551", &ConvertRGBA8888ToRGBA5551, &RGBA8888toRGBA5551) && success;
+	success = CheckConvert32To16("RGBA8888ToRGBA4444", &ConvertRGBA8888ToRGBA4444, &RGBA8888toRGBA4444) && success;
+	success = CheckConvert32To16("BGRA8888ToRGB565", &ConvertBGRA8888ToRGB565, &BGRA8888toRGB565) && success;
+	success = CheckConvert32To16("BGRA8888ToRGBA5551", &ConvertBGRA8888ToRGBA5551, &BGRA8888toRGBA5551) && success;
+	success = CheckConvert32To16("BGRA8888ToRGBA4444", &ConvertBGRA8888ToRGBA4444, &BGRA8888toRGBA4444) && success;
+
+	success = CheckConvert16To16("RGBA4444ToABGR4444", &ConvertRGBA4444ToABGR4444, [](u16 c) {
+		return (u16)(((c >> 12) & 0x000F) | ((c >> 4) & 0x00F0) | ((c << 4) & 0x0F00) | ((c << 12) & 0xF000));
+	}) && success;
+	success = CheckConvert16To16("RGBA5551ToABGR1555", &ConvertRGBA5551ToABGR1555, [](u16 c) {
+		return (u16)(((c >> 15) & 0x0001) | ((c >> 9) & 0x003E) | ((c << 1) & 0x07C0) | ((c << 11) & 0xF800));
+	}) && success;
+	success = CheckConvert16To16("RGB565ToBGR565", &ConvertRGB565ToBGR565, [](u16 c) {
+		return (u16)(((c >> 11) & 0x001F) | (c & 0x07E0) | ((c << 11) & 0xF800));
+	}) && success;
+	success = CheckConvert16To16("BGRA5551ToABGR1555", &ConvertBGRA5551ToABGR1555, [](u16 c) {
+		return (u16)((c >> 15) | (c << 1));
+	}) && success;
+
+	success = CheckConvert32To32() && success;
+	if (!success)
+		return false;
+
+	printf("ColorConv (AVX2: %d, SSSE3: %d, NEON: %d)\n", (int)cpu_info.bAVX2, (int)cpu_info.bSSSE3, (int)cpu_info.bNEON);
+	BenchmarkConvert<u32, u16>("RGB565ToRGBA8888", &ConvertRGB565ToRGBA8888, &RGB565ToRGBA8888);
+	BenchmarkConvert<u32, u16>("RGBA5551ToRGBA8888", &ConvertRGBA5551ToRGBA8888, &RGBA5551ToRGBA8888);
+	BenchmarkConvert<u32, u16>("RGBA4444ToRGBA8888", &ConvertRGBA4444ToRGBA8888, &RGBA4444ToRGBA8888);
+	BenchmarkConvert<u32, u16>("ABGR1555ToRGBA8888", &ConvertABGR1555ToRGBA8888, &RefABGR1555ToRGBA8888);
+	BenchmarkConvert<u16, u32>("RGBA8888ToRGB565", &ConvertRGBA8888ToRGB565, &RGBA8888toRGB565);
+	BenchmarkConvert<u16, u32>("RGBA8888ToRGBA5551", &ConvertRGBA8888ToRGBA5551, &RGBA8888toRGBA5551);
+	BenchmarkConvert<u16, u32>("BGRA8888ToRGBA4444", &ConvertBGRA8888ToRGBA4444, &BGRA8888toRGBA4444);
+	BenchmarkConvert<u32, u32>("BGRA8888ToRGBA8888", &ConvertBGRA8888ToRGBA8888, &SwapRB);
+	return true;
+}
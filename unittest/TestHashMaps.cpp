@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/TimeUtil.h"
+#include "Common/Data/Collections/Hashmaps.h"
+
+#include "UnitTest.h"
+
+typedef void *TestValue;
+
+static TestValue MakeValue(uint64_t i) {
+	return (TestValue)(uintptr_t)(i + 1);
+}
+
+// The linear probing map that DenseHashMap used to be, kept for comparison in the benchmark.
+template <class Key, class Value, Value NullValue>
+class LinearProbeHashMap {
+public:
+	LinearProbeHashMap(int initialCapacity) : capacity_(initialCapacity) {
+		map.resize(initialCapacity);
+		state.resize(initialCapacity);
+	}
+
+	Value Get(const Key &key) {
+		uint32_t mask = capacity_ - 1;
+		uint32_t p = HashKey(key) & mask;
+		while (true) {
+			if (state[p] == TAKEN && KeyEquals(key, map[p].key))
+				return map[p].value;
+			else if (state[p] == FREE)
+				return NullValue;
+			p = (p + 1) & mask;
+		}
+	}
+
+	bool Insert(const Key &key, Value value) {
+		if (count_ > capacity_ / 2)
+			Grow();
+		uint32_t mask = capacity_ - 1;
+		uint32_t p = HashKey(key) & mask;
+		while (state[p] == TAKEN) {
+			if (KeyEquals(key, map[p].key))
+				return false;
+			p = (p + 1) & mask;
+		}
+		state[p] = TAKEN;
+		map[p].key = key;
+		map[p].value = value;
+		count_++;
+		return true;
+	}
+
+	bool Remove(const Key &key) {
+		uint32_t mask = capacity_ - 1;
+		uint32_t p = HashKey(key) & mask;
+		while (state[p] != FREE) {
+			if (state[p] == TAKEN && KeyEquals(key, map[p].key)) {
+				state[p] = REMOVED;
+				count_--;
+				return true;
+			}
+			p = (p + 1) & mask;
+		}
+		return false;
+	}
+
+private:
+	enum : uint8_t {
+		FREE,
+		TAKEN,
+		REMOVED,
+	};
+
+	void Grow() {
+		std::vector<Pair> old = std::move(map);
+		std::vector<uint8_t> oldState = std::move(state);
+		map.clear();
+		state.clear();
+		capacity_ *= 2;
+		map.resize(capacity_);
+		state.resize(capacity_);
+		count_ = 0;
+		for (size_t i = 0; i < old.size(); i++) {
+			if (oldState[i] == TAKEN)
+				Insert(old[i].key, old[i].value);
+		}
+	}
+
+	struct Pair {
+		Key key;
+		Value value;
+	};
+	std::vector<Pair> map;
+	std::vector<uint8_t> state;
+	int capacity_;
+	int count_ = 0;
+};
+
+static bool TestDenseHashMapRandom() {
+	DenseHashMap<uint64_t, TestValue, nullptr> map(4);
+	std::unordered_map<uint64_t, TestValue> reference;
+
+	uint32_t seed = 1234;
+	for (int i = 0; i < 200000; ++i) {
+		seed = seed * 1664525 + 1013904223;
+		// A small key space, so that removes and reinserts of the same keys are common.
+		uint64_t key = (seed >> 8) % 5000;
+		switch ((seed >> 4) & 3) {
+		case 0:
+		case 1:
+			if (reference.find(key) == reference.end()) {
+				EXPECT_TRUE(map.Insert(key, MakeValue(key)));
+				reference[key] = MakeValue(key);
+			}
+			break;
+		case 2:
+			EXPECT_EQ_INT(map.Remove(key), reference.erase(key) != 0);
+			break;
+		case 3:
+			EXPECT_TRUE(map.Get(key) == (reference.count(key) ? reference[key] : nullptr));
+			break;
+		}
+		if ((i & 0xFFF) == 0)
+			map.Maintain();
+	}
+
+	EXPECT_EQ_INT((int)map.size(), (int)reference.size());
+	size_t seen = 0;
+	bool allMatch = true;
+	map.Iterate([&](uint64_t key, TestValue value) {
+		auto it = reference.find(key);
+		allMatch = allMatch && it != reference.end() && it->second == value;
+		seen++;
+	});
+	EXPECT_TRUE(allMatch);
+	EXPECT_EQ_INT((int)seen, (int)reference.size());
+
+	map.Clear();
+	EXPECT_EQ_INT((int)map.size(), 0);
+	EXPECT_TRUE(map.Get(1) == nullptr);
+	return true;
+}
+
+static bool TestPrehashMapCollisions() {
+	PrehashMap<TestValue, nullptr> map(64);
+
+	// All of these start probing in the same group and share the control byte, so they
+	// fill whole groups and have to be found by comparing the hash.
+	const int COUNT = 200;
+	for (uint32_t i = 0; i < COUNT; ++i) {
+		EXPECT_TRUE(map.Insert(i << 20, MakeValue(i)));
+	}
+	EXPECT_FALSE(map.Insert(5 << 20, MakeValue(5)));
+	for (uint32_t i = 0; i < COUNT; ++i) {
+		EXPECT_TRUE(map.Get(i << 20) == MakeValue(i));
+	}
+	EXPECT_TRUE(map.Get(12345) == nullptr);
+
+	// Removing from full groups leaves tombstones, those further along must still be found.
+	for (uint32_t i = 0; i < COUNT; i += 2) {
+		EXPECT_TRUE(map.Remove(i << 20));
+	}
+	EXPECT_FALSE(map.Remove(0));
+	for (uint32_t i = 0; i < COUNT; ++i) {
+		EXPECT_TRUE(map.Get(i << 20) == ((i & 1) ? MakeValue(i) : nullptr));
+	}
+	map.Rebuild();
+	for (uint32_t i = 1; i < COUNT; i += 2) {
+		EXPECT_TRUE(map.Get(i << 20) == MakeValue(i));
+	}
+	EXPECT_EQ_INT((int)map.size(), COUNT / 2);
+
+	// Removing while iterating is done by the vertex caches.
+	map.Iterate([&](uint32_t hash, TestValue value) {
+		map.Remove(hash);
+	});
+	EXPECT_EQ_INT((int)map.size(), 0);
+	return true;
+}
+
+template <typename Map>
+static void BenchmarkMap(const char *name, int capacity, int count) {
+	std::vector<uint64_t> keys(count);
+	uint64_t seed = 42;
+	for (int i = 0; i < count; ++i) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		keys[i] = seed;
+	}
+
+	// Insert and remove are repeated on fresh maps, since a single pass is too short to time.
+	const int ROUNDS = std::max(1, 1000000 / count);
+	const int LOOKUPS = 4000000;
+	double insertTime = 0.0, hitTime = 0.0, missTime = 0.0, removeTime = 0.0;
+	uintptr_t sum = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		Map map(capacity);
+		double start = time_now_d();
+		for (int i = 0; i < count; ++i)
+			map.Insert(keys[i], MakeValue(i));
+		insertTime += time_now_d() - start;
+
+		if (r == 0) {
+			start = time_now_d();
+			for (int i = 0; i < LOOKUPS; ++i)
+				sum += (uintptr_t)map.Get(keys[(uint32_t)i * 7919u % (uint32_t)count]);
+			hitTime = time_now_d() - start;
+
+			start = time_now_d();
+			for (int i = 0; i < LOOKUPS; ++i)
+				sum += (uintptr_t)map.Get(keys[i % count] ^ 0x5555);
+			missTime = time_now_d() - start;
+		}
+
+		start = time_now_d();
+		for (int i = 0; i < count; ++i)
+			map.Remove(keys[(uint32_t)i * 7919u % (uint32_t)count]);
+		removeTime += time_now_d() - start;
+	}
+
+	printf("%-8s load %3d%%: insert %5.1f ns, hit %5.1f ns, miss %5.1f ns, remove %5.1f ns (%d)\n", name, count * 100 / capacity,
+		insertTime * 1e9 / ((double)count * ROUNDS), hitTime * 1e9 / LOOKUPS, missTime * 1e9 / LOOKUPS, removeTime * 1e9 / ((double)count * ROUNDS), (int)(sum & 1));
+}
+
+bool TestHashMaps() {
+	if (!TestDenseHashMapRandom())
+		return false;
+	if (!TestPrehashMapCollisions())
+		return false;
+
+	// The linear map grows past 50%, so at higher loads it ends up with more room.
+	const int CAPACITY = 16384;
+	for (int percent : { 25, 45, 70, 85 }) {
+		int count = CAPACITY * percent / 100;
+		BenchmarkMap<LinearProbeHashMap<uint64_t, TestValue, nullptr>>("linear", CAPACITY, count);
+		BenchmarkMap<DenseHashMap<uint64_t, TestValue, nullptr>>("swiss", CAPACITY, count);
+	}
+	return true;
+}
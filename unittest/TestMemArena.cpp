@@ -0,0 +1,152 @@
+#include "ppsspp_config.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Common/MemArena.h"
+#include "Common/TimeUtil.h"
+
+#include "UnitTest.h"
+
+#if defined(__linux__)
+// Counts data TLB read misses for the current thread, or returns -1 if perf isn't allowed.
+static int OpenTLBMissCounter() {
+	perf_event_attr attr{};
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// How much of the mapping at addr is mapped using huge pages, from smaps.
+static long HugeMappedKB(const void *addr) {
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (!f)
+		return -1;
+	char line[512];
+	bool inRange = false;
+	long kb = -1;
+	while (fgets(line, sizeof(line), f)) {
+		unsigned long start, end;
+		if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+			if (inRange)
+				break;
+			inRange = (uintptr_t)addr >= start && (uintptr_t)addr < end;
+		} else if (inRange && (sscanf(line, "ShmemPmdMapped: %ld kB", &kb) == 1 || sscanf(line, "FilePmdMapped: %ld kB", &kb) == 1)) {
+			break;
+		}
+	}
+	fclose(f);
+	return kb;
+}
+#endif
+
+// Maps a scratchpad-like view and two mirrors of a RAM-like view, like MemoryMap_Setup does.
+static bool TestArenaLayout(bool hugePages) {
+	const size_t SCRATCH_SIZE = 0x4000;
+	const size_t RAM_SIZE = 0x02000000;
+
+	MemArena arena;
+	arena.SetHugePages(hugePages);
+	const size_t ramOffset = arena.roundup(SCRATCH_SIZE);
+	EXPECT_TRUE(arena.GrabMemSpace(ramOffset + arena.roundup(RAM_SIZE)));
+
+	u8 *base = arena.Find4GBBase();
+	u8 *scratch = (u8 *)arena.CreateView(0, SCRATCH_SIZE, base + 0x00010000);
+	u8 *ram = (u8 *)arena.CreateView(ramOffset, RAM_SIZE, base + 0x08000000);
+	u8 *mirror = (u8 *)arena.CreateView(ramOffset, RAM_SIZE, base + 0x0A000000);
+	EXPECT_TRUE(scratch != nullptr && ram != nullptr && mirror != nullptr);
+
+	memset(scratch, 0x11, SCRATCH_SIZE);
+	for (size_t i = 0; i < RAM_SIZE; i += 4096)
+		ram[i] = (u8)(i >> 12);
+	for (size_t i = 0; i < RAM_SIZE; i += 4096) {
+		if (mirror[i] != (u8)(i >> 12)) {
+			printf("Mirror mismatch at %08x\n", (int)i);
+			return false;
+		}
+	}
+	EXPECT_EQ_INT(scratch[SCRATCH_SIZE - 1], 0x11);
+
+	// Random reads over the whole RAM view, which is the JIT's typical fastmem pattern at its worst.
+	const int READS = 1 << 24;
+#if defined(__linux__)
+	int counter = OpenTLBMissCounter();
+	if (counter >= 0) {
+		ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+		ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+	double start = time_now_d();
+	u32 seed = 1, sum = 0;
+	for (int i = 0; i < READS; ++i) {
+		seed = seed * 1664525 + 1013904223;
+		sum += ram[(seed >> 7) & (RAM_SIZE - 1)];
+	}
+	double elapsed = time_now_d() - start;
+
+	long long misses = -1;
+#if defined(__linux__)
+	if (counter >= 0) {
+		ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(counter, &misses, sizeof(misses)) != sizeof(misses))
+			misses = -1;
+		close(counter);
+	}
+	long hugeKB = HugeMappedKB(ram);
+#else
+	long hugeKB = -1;
+#endif
+	printf("MemArena huge pages %d: %0.1f ns/read, dTLB read misses: %lld, huge mapped: %ld kB (sum %08x)\n", (int)hugePages, elapsed * 1e9 / READS, misses, hugeKB, sum);
+
+#if defined(__linux__) && !defined(__ANDROID__)
+	// A forked child that unshares must keep its mirrors, without the parent seeing its writes.
+	scratch[5] = 9;
+	ram[0x123456] = 7;
+	pid_t pid = fork();
+	if (pid == 0) {
+		if (!arena.Unshare())
+			_exit(1);
+		if (arena.CreateView(0, SCRATCH_SIZE, scratch) != scratch || arena.CreateView(ramOffset, RAM_SIZE, ram) != ram || arena.CreateView(ramOffset, RAM_SIZE, mirror) != mirror)
+			_exit(2);
+		if (scratch[5] != 9 || ram[0x123456] != 7)
+			_exit(3);
+		scratch[5] = 1;
+		ram[0x123456] = 42;
+		_exit(mirror[0x123456] == 42 ? 0 : 4);
+	}
+	EXPECT_TRUE(pid > 0);
+	int status = -1;
+	waitpid(pid, &status, 0);
+	EXPECT_TRUE(WIFEXITED(status));
+	EXPECT_EQ_INT(WEXITSTATUS(status), 0);
+	EXPECT_EQ_INT(scratch[5], 9);
+	EXPECT_EQ_INT(ram[0x123456], 7);
+#endif
+
+	arena.ReleaseView(0, mirror, RAM_SIZE);
+	arena.ReleaseView(0, ram, RAM_SIZE);
+	arena.ReleaseView(0, scratch, SCRATCH_SIZE);
+	arena.ReleaseSpace();
+	return true;
+}
+
+bool TestMemArena() {
+	if (!TestArenaLayout(false))
+		return false;
+	// Falls back to regular pages if unsupported, so this should always pass.
+	if (!TestArenaLayout(true))
+		return false;
+	return true;
+}
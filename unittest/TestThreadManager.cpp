@@ -60,6 +60,25 @@ bool TestParallelLoop(ThreadManager *threadMan) {
 	printf("waitable test [10-30)\n");
 	WaitableCounter *waitable2 = ParallelRangeLoopWaitable(threadMan, rangeFunc, 10, 30, 40, TaskPriority::LOW);
 	waitable2->WaitAndRelease();
+
+	// Every item must be visited exactly once, also after the cost estimate has adapted the chunking.
+	printf("coverage test\n");
+	std::atomic<int> visits[1000];
+	for (int iter = 0; iter < 200; iter++) {
+		int upper = 1 + (iter * 37) % 1000;
+		for (int i = 0; i < upper; i++)
+			visits[i] = 0;
+		ParallelRangeLoop(threadMan, [&](int l, int h) {
+			for (int i = l; i < h; i++)
+				visits[i]++;
+		}, 0, upper, 1 + iter % 8);
+		for (int i = 0; i < upper; i++) {
+			if (visits[i] != 1) {
+				printf("item %d of [0-%d) visited %d times\n", i, upper, visits[i].load());
+				return false;
+			}
+		}
+	}
 	return true;
 }
 
@@ -123,6 +142,101 @@ bool TestMultithreadedScheduling() {
 	return true;
 }
 
+class BlockingTask : public Task {
+public:
+	BlockingTask(std::atomic<bool> *release, LimitedWaitable *started) : release_(release), started_(started) {}
+	TaskType Type() const override { return TaskType::CPU_COMPUTE; }
+	TaskPriority Priority() const override { return TaskPriority::NORMAL; }
+	void Run() override {
+		started_->Notify();
+		// Give up after a while, so a broken scheduler fails the test rather than hanging it.
+		auto start = Instant::Now();
+		while (!*release_ && start.Elapsed() < 2.0)
+			sleep_ms(1);
+	}
+private:
+	std::atomic<bool> *release_;
+	LimitedWaitable *started_;
+};
+
+// Parallel loop chunks queued behind a long task on thread 0 should get picked up by the other threads.
+bool TestWorkStealing(ThreadManager *threadMan) {
+	// Static since the blocker might still be checking it after we return.
+	static std::atomic<bool> release;
+	static LimitedWaitable started;
+	release = false;
+	threadMan->EnqueueTaskOnThread(0, new BlockingTask(&release, &started));
+	started.Wait();
+
+	std::atomic<int> done{ 0 };
+	auto start = Instant::Now();
+	ParallelRangeLoop(threadMan, [&](int l, int h) {
+		done += h - l;
+	}, 0, 64, 1);
+
+	// If the chunk for thread 0 was stuck behind the blocker, we'd have waited for it to give up.
+	bool stolen = start.Elapsed() < 1.0;
+	release = true;
+	EXPECT_EQ_INT(done.load(), 64);
+	EXPECT_TRUE(stolen);
+	return true;
+}
+
+class CountdownTask : public Task {
+public:
+	CountdownTask(std::atomic<int> *remaining, LimitedWaitable *done) : remaining_(remaining), done_(done) {}
+	TaskType Type() const override { return TaskType::CPU_COMPUTE; }
+	TaskPriority Priority() const override {
+		return TaskPriority::NORMAL;
+	}
+	void Run() override {
+		if (--*remaining_ == 0)
+			done_->Notify();
+	}
+private:
+	std::atomic<int> *remaining_;
+	LimitedWaitable *done_;
+};
+
+// Not a pass/fail test, just logs throughput and latency at different pool sizes.
+// Run it separately (PPSSPPUnitTest ThreadManagerBenchmark), since it takes a while.
+bool TestThreadManagerBenchmark() {
+	static const int poolSizes[] = { 1, 2, 4, 8, 16, 32, 64 };
+	for (int poolSize : poolSizes) {
+		ThreadManager manager;
+		// Bypass the usual cap, we want to see how the queues scale.
+		manager.Init(poolSize, 1, poolSize);
+
+		// Everything goes on thread 0's steal queue, so the other threads only get work by stealing.
+		// This goes straight to EnqueueTaskOnThread, since ParallelRangeLoop would run tiny loops inline.
+		const int BATCHES = 200;
+		const int BATCH_SIZE = 256;
+		auto start = Instant::Now();
+		for (int i = 0; i < BATCHES; ++i) {
+			std::atomic<int> remaining{ BATCH_SIZE };
+			LimitedWaitable *done = new LimitedWaitable();
+			for (int j = 0; j < BATCH_SIZE; ++j) {
+				manager.EnqueueTaskOnThread(0, new CountdownTask(&remaining, done), true);
+			}
+			done->WaitAndRelease();
+		}
+		double tasksPerSecond = (double)BATCHES * BATCH_SIZE / start.Elapsed();
+
+		const int ROUNDTRIPS = 2000;
+		start = Instant::Now();
+		for (int i = 0; i < ROUNDTRIPS; ++i) {
+			LimitedWaitable *waitable = new LimitedWaitable();
+			manager.EnqueueTask(new IncrementTask(TaskType::CPU_COMPUTE, waitable));
+			waitable->WaitAndRelease();
+		}
+		double latencyUs = start.Elapsed() * 1000000.0 / ROUNDTRIPS;
+
+		printf("ThreadManager %2d threads: %0.0f stealable tasks/s, %0.1f us enqueue-to-done latency\n", manager.GetNumLooperThreads(), tasksPerSecond, latencyUs);
+		manager.Teardown();
+	}
+	return true;
+}
+
 bool TestThreadManager() {
 	ThreadManager manager;
 	manager.Init(8, 1);
@@ -151,5 +265,9 @@ bool TestThreadManager() {
 		return false;
 	}
 
+	if (!TestWorkStealing(&manager)) {
+		return false;
+	}
+
 	return true;
 }
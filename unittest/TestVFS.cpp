@@ -82,13 +82,59 @@ bool TestZipFile() {
 	EXPECT_TRUE(dir->GetFileListing("b", &listing, nullptr));
 	EXPECT_TRUE(CheckContainsFile(listing, "in_b.txt"));
 	EXPECT_EQ_INT(listing.size(), 1);
+
+	// Lookups are case insensitive. big.txt is deflated.
+	size_t size = 0;
+	uint8_t *data = dir->ReadFile("BIG.txt", &size);
+	EXPECT_TRUE(data != nullptr);
+	EXPECT_EQ_STR(std::string((const char *)data, size), std::string("not really"));
+	delete[] data;
 	delete dir;
 
 	return true;
 }
 
+// Reads the same files through the open file interface, in small pieces and with rewinds.
+bool TestZipFileRead() {
+	Path zipPath = Path("../source_assets/ziptest.zip");
+	if (!File::Exists(zipPath)) {
+		zipPath = Path("source_assets/ziptest.zip");
+	}
+
+	ZipFileReader *dir = ZipFileReader::Create(zipPath, "", true);
+	EXPECT_TRUE(dir != nullptr);
+
+	VFSFileReference *ref = dir->GetFile("ziptest/data/big.txt");
+	EXPECT_TRUE(ref != nullptr);
+	File::FileInfo info;
+	EXPECT_TRUE(dir->GetFileInfo(ref, &info));
+	EXPECT_EQ_INT(info.size, 10);
+
+	size_t size = 0;
+	VFSOpenFile *file = dir->OpenFileForRead(ref, &size);
+	EXPECT_TRUE(file != nullptr);
+	EXPECT_EQ_INT(size, 10);
+	char buf[16]{};
+	EXPECT_EQ_INT(dir->Read(file, buf, 3), 3);
+	EXPECT_EQ_STR(std::string(buf, 3), std::string("not"));
+	dir->Rewind(file);
+	EXPECT_EQ_INT(dir->Read(file, buf, sizeof(buf)), 10);
+	EXPECT_EQ_STR(std::string(buf, 10), std::string("not really"));
+	EXPECT_EQ_INT(dir->Read(file, buf, sizeof(buf)), 0);
+	// Deflated files can't be accessed directly.
+	EXPECT_TRUE(dir->GetMappedData(file) == nullptr);
+	dir->CloseFile(file);
+	dir->ReleaseFile(ref);
+
+	EXPECT_TRUE(dir->GetFile("ziptest/data/missing.txt") == nullptr);
+	delete dir;
+	return true;
+}
+
 bool TestVFS() {
 	if (!TestZipFile())
 		return false;
+	if (!TestZipFileRead())
+		return false;
 	return true;
 }
@@ -2,7 +2,10 @@
 
 #if PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
 
+#include <algorithm>
+
 #include "Common/CPUDetect.h"
+#include "Common/TimeUtil.h"
 #include "Common/x64Emitter.h"
 #include "Core/MIPS/x86/RegCacheFPU.h"
 #include "Core/MIPS/x86/Jit.h"
@@ -28,6 +31,54 @@ static void PrintLast(const Gen::XEmitter &emit) {
 	printf("\n");
 }
 
+#if PPSSPP_ARCH(AMD64)
+// A mix of the instructions the jits emit the most.  Returns how many were emitted.
+static int EmitInstructionMix(Gen::XEmitter &emit, int count) {
+	using namespace Gen;
+	for (int i = 0; i < count; ++i) {
+		X64Reg reg = (X64Reg)(R8 + (i & 7));
+		emit.MOV(32, R(EAX), MDisp(RBP, (i & 31) * 4));
+		emit.MOV(32, R(reg), MDisp(RBX, 0x1000 + i));
+		emit.ADD(32, R(EAX), Imm32(i));
+		emit.MOV(64, R(RDX), R(reg));
+		emit.MOV(32, MComplex(RBX, RCX, SCALE_1, 0x20), R(EAX));
+		emit.CMP(32, R(EAX), R(EDX));
+		FixupBranch skip = emit.J_CC(CC_NE);
+		emit.LEA(32, EDX, MDisp(EAX, 8));
+		emit.SetJumpTarget(skip);
+		emit.MOVSS(XMM1, MDisp(RBP, 0x100 + (i & 15) * 4));
+		emit.ADDSS(XMM1, R(XMM2));
+		emit.MOVSS(MDisp(R14, 0x200), XMM1);
+		emit.SHL(32, R(EAX), Imm8(2));
+		emit.AND(32, R(reg), Imm32(0x3FFFFFFF));
+		emit.TEST(32, R(EAX), Imm32(0x80));
+	}
+	return count * 15;
+}
+
+static void BenchmarkX64Emitter() {
+	const int CODE_SIZE = 8 * 1024 * 1024;
+	const int ROUNDS = 20;
+	Gen::XCodeBlock block;
+	block.AllocCodeSpace(CODE_SIZE);
+
+	double best = 0.0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		block.ClearCodeSpace(0);
+		block.BeginWriteBatch();
+		block.BeginWrite(CODE_SIZE);
+		double start = time_now_d();
+		int count = EmitInstructionMix(block, 50000);
+		double elapsed = time_now_d() - start;
+		block.EndWrite();
+		block.EndWriteBatch();
+		best = std::max(best, count / elapsed);
+	}
+	printf("x64 emitter: %0.1f million instructions/s (%d bytes per round)\n", best / 1000000.0, (int)block.GetOffset(block.GetCodePtr()));
+	block.FreeCodeSpace();
+}
+#endif
+
 bool TestX64Emitter() {
 	using namespace Gen;
 
@@ -47,8 +98,39 @@ bool TestX64Emitter() {
 
 	cpu_info.bAVX = prevAVX;
 
+#if PPSSPP_ARCH(AMD64)
+	// These go through the faster paths for register and memory operands.
+	prevStart = emitter.GetCodePointer();
+	emitter.MOV(64, R(R8), R(RAX));
+	RET(CheckLast(emitter, "mov r8, rax"));
+
+	prevStart = emitter.GetCodePointer();
+	emitter.MOV(16, R(EAX), R(R9));
+	RET(CheckLast(emitter, "mov ax, r9w"));
+
+	prevStart = emitter.GetCodePointer();
+	emitter.ADD(32, R(EDX), MComplex(RBX, R12, SCALE_4, 0x100));
+	RET(CheckLast(emitter, "add edx, [rbx+r12*4+0x100]"));
+
+	prevStart = emitter.GetCodePointer();
+	emitter.SHL(32, R(R10), Imm8(3));
+	RET(CheckLast(emitter, "shl r10d, 0x3"));
+
+	prevStart = emitter.GetCodePointer();
+	emitter.MOVSS(XMM9, MDisp(RSP, 8));
+	RET(CheckLast(emitter, "movss xmm9, dword [rsp+0x8]"));
+
+	prevStart = emitter.GetCodePointer();
+	emitter.LEA(64, RCX, MDisp(R13, -4));
+	RET(CheckLast(emitter, "lea rcx, [r13-0x4]"));
+#endif
+
 	// Just for checking.
 	PrintLast(emitter);
+
+#if PPSSPP_ARCH(AMD64)
+	BenchmarkX64Emitter();
+#endif
 	return true;
 }
 
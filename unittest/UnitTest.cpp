@@ -35,12 +35,14 @@
 #include "ppsspp_config.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
 #include <vector>
 #include <string>
 #include <sstream>
+#include <thread>
 
 #if PPSSPP_PLATFORM(ANDROID)
 #include <jni.h>
@@ -52,6 +54,7 @@
 #include "Common/Data/Text/Parsers.h"
 #include "Common/Data/Text/WrapText.h"
 #include "Common/Data/Encoding/Utf8.h"
+#include "Common/Data/Format/IniFile.h"
 #include "Common/File/Path.h"
 #include "Common/Input/InputState.h"
 #include "Common/Math/math_util.h"
@@ -62,14 +65,19 @@
 #include "Common/ArmEmitter.h"
 #include "Common/BitScan.h"
 #include "Common/CPUDetect.h"
+#include "Common/ConsoleListener.h"
 #include "Common/Log.h"
+#include "Common/LogManager.h"
 #include "Common/StringUtils.h"
+#include "Common/TimeUtil.h"
 #include "Core/Config.h"
+#include "Core/CoreTiming.h"
 #include "Common/File/VFS/VFS.h"
 #include "Common/File/VFS/DirectoryReader.h"
 #include "Core/FileSystems/ISOFileSystem.h"
 #include "Core/MemMap.h"
 #include "Core/KeyMap.h"
+#include "Core/MIPS/MIPS.h"
 #include "Core/MIPS/MIPSVFPUUtils.h"
 #include "GPU/Common/TextureDecoder.h"
 #include "GPU/Common/GPUStateUtils.h"
@@ -635,6 +643,55 @@ bool TestCLZ() {
 	return true;
 }
 
+static int timingFiredA;
+static int timingFiredB;
+
+// Two timing contexts used from one thread must keep their own events and clocks.
+static bool TestCoreTimingContexts() {
+	CoreTiming::Context *a = CoreTiming::CreateContext();
+	CoreTiming::Context *b = CoreTiming::CreateContext();
+	timingFiredA = 0;
+	timingFiredB = 0;
+
+	CoreTiming::SetThreadContext(a);
+	CoreTiming::Init();
+	int eventA = CoreTiming::RegisterEvent("TestA", [](u64 userdata, int cyclesLate) { timingFiredA += (int)userdata; });
+	CoreTiming::ScheduleEvent(1000, eventA, 1);
+
+	CoreTiming::SetThreadContext(b);
+	CoreTiming::Init();
+	int eventB = CoreTiming::RegisterEvent("TestB", [](u64 userdata, int cyclesLate) { timingFiredB += (int)userdata; });
+	CoreTiming::ScheduleEvent(5000, eventB, 2);
+	EXPECT_EQ_INT((int)CoreTiming::GetTicks(), 0);
+
+	// Run A until its event fires, B must not notice.
+	CoreTiming::SetThreadContext(a);
+	CoreTiming::Idle();
+	CoreTiming::Advance();
+	EXPECT_EQ_INT(timingFiredA, 1);
+	EXPECT_EQ_INT(timingFiredB, 0);
+	EXPECT_EQ_INT((int)CoreTiming::GetTicks(), 1000);
+	EXPECT_FALSE(CoreTiming::IsScheduled(eventA));
+
+	CoreTiming::SetThreadContext(b);
+	EXPECT_EQ_INT((int)CoreTiming::GetTicks(), 0);
+	EXPECT_TRUE(CoreTiming::IsScheduled(eventB));
+	CoreTiming::Idle();
+	CoreTiming::Advance();
+	EXPECT_EQ_INT(timingFiredB, 2);
+	EXPECT_EQ_INT((int)CoreTiming::GetTicks(), 5000);
+	CoreTiming::Shutdown();
+
+	CoreTiming::SetThreadContext(a);
+	EXPECT_EQ_INT((int)CoreTiming::GetTicks(), 1000);
+	CoreTiming::Shutdown();
+
+	CoreTiming::SetThreadContext(nullptr);
+	CoreTiming::DestroyContext(a);
+	CoreTiming::DestroyContext(b);
+	return true;
+}
+
 static bool TestMemMap() {
 	Memory::g_MemorySize = Memory::RAM_DOUBLE_SIZE;
 
@@ -977,6 +1034,123 @@ bool TestSubstitutions() {
 	return true;
 }
 
+bool TestIniFile() {
+	std::stringstream stream(
+		"; Header comment\n"
+		"[Options]\n"
+		"version = 1\n"
+		"Hash = Quick   # trailing comment\n"
+		"escaped = a\\#b\n"
+		"[Hashes]\n"
+		"0800000012345678 = first.png\n"
+		"0800000012345678 = second.png\n");
+	IniFile ini;
+	ini.Load(stream);
+
+	std::string value;
+	EXPECT_TRUE(ini.Get("options", "HASH", &value, ""));
+	EXPECT_EQ_STR(value, std::string("Quick"));
+	EXPECT_TRUE(ini.Get("Options", "escaped", &value, ""));
+	EXPECT_EQ_STR(value, std::string("a#b"));
+	EXPECT_FALSE(ini.Get("Options", "missing", &value, "default"));
+	EXPECT_EQ_STR(value, std::string("default"));
+
+	// Changing a value keeps the comment.
+	Section *options = ini.GetOrCreateSection("Options");
+	options->Set("hash", "XXH64");
+	std::vector<std::string> lines;
+	ini.GetLines("Options", lines, false);
+	EXPECT_EQ_INT((int)lines.size(), 3);
+	EXPECT_EQ_STR(lines[1], std::string("hash = XXH64   # trailing comment"));
+
+	// The first of a duplicated key wins, and deleting it reveals the next.
+	EXPECT_TRUE(ini.Get("Hashes", "0800000012345678", &value, ""));
+	EXPECT_EQ_STR(value, std::string("first.png"));
+	EXPECT_TRUE(ini.DeleteKey("Hashes", "0800000012345678"));
+	EXPECT_TRUE(ini.Get("Hashes", "0800000012345678", &value, ""));
+	EXPECT_EQ_STR(value, std::string("second.png"));
+
+	// Benchmark with something shaped like a big texture pack's textures.ini.
+	const int count = 50000;
+	std::string big = "[options]\nversion = 1\n[hashes]\n";
+	for (int i = 0; i < count; i++) {
+		big += StringFromFormat("%016x = textures/tex_%d.png\n", i * 2654435761U, i);
+	}
+	std::stringstream bigStream(big);
+	IniFile bigIni;
+	double start = time_now_d();
+	bigIni.Load(bigStream);
+	double loaded = time_now_d();
+	const Section *hashes = bigIni.GetOrCreateSection("hashes");
+	int found = 0;
+	for (int i = 0; i < count; i++) {
+		if (hashes->Get(StringFromFormat("%016x", i * 2654435761U).c_str(), &value, nullptr))
+			found++;
+	}
+	double done = time_now_d();
+	EXPECT_EQ_INT(found, count);
+	printf("IniFile: %d entries, load %0.2f ms, lookup %0.2f ms\n", count, (loaded - start) * 1000.0, (done - loaded) * 1000.0);
+	return true;
+}
+
+class CountingLogListener : public LogListener {
+public:
+	void Log(const LogMessage &msg) override {
+		if (msg.msg.find("LogManager test") != std::string::npos)
+			count++;
+	}
+	std::atomic<int> count{};
+};
+
+bool TestLogManager() {
+	bool enabled = true;
+	LogManager::Init(&enabled);
+	LogManager *logManager = LogManager::GetInstance();
+	// Keep the console quiet.
+	logManager->RemoveListener(logManager->GetConsoleListener());
+	logManager->SetLogLevel(LogType::SYSTEM, LogLevel::LINFO);
+	CountingLogListener listener;
+	logManager->AddListener(&listener);
+
+	// Switching back to sync while other threads are logging must not leave anything in the queue.
+	const int THREADS = 4;
+	const int MESSAGES = 2000;
+	logManager->SetAsync(true);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; t++) {
+		threads.emplace_back([=] {
+			for (int i = 0; i < MESSAGES; i++) {
+				INFO_LOG(SYSTEM, "LogManager test %d %d", t, i);
+			}
+		});
+	}
+	sleep_ms(1);
+	logManager->SetAsync(false);
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	EXPECT_FALSE(logManager->IsAsync());
+	EXPECT_EQ_INT(listener.count + (int)logManager->GetDroppedCount(), THREADS * MESSAGES);
+
+	// Queued messages are delivered by the switch itself, without a Flush.
+	int before = listener.count;
+	logManager->SetAsync(true);
+	INFO_LOG(SYSTEM, "LogManager test queued");
+	logManager->SetAsync(false);
+	EXPECT_EQ_INT(listener.count, before + 1);
+
+	// Errors are delivered right away, since a crash might follow.
+	logManager->SetAsync(true);
+	INFO_LOG(SYSTEM, "LogManager test before error");
+	ERROR_LOG(SYSTEM, "LogManager test error");
+	EXPECT_EQ_INT(listener.count, before + 3);
+	logManager->SetAsync(false);
+
+	logManager->RemoveListener(&listener);
+	LogManager::Shutdown();
+	return true;
+}
+
 typedef bool (*TestFunc)();
 struct TestItem {
 	const char *name;
@@ -993,7 +1167,12 @@ bool TestShaderGenerators();
 bool TestSoftwareGPUJit();
 bool TestIRPassSimplify();
 bool TestThreadManager();
+bool TestThreadManagerBenchmark();
+bool TestColorConv();
+bool TestHashMaps();
+bool TestMemArena();
 bool TestVFS();
+bool TestVulkanQueueRunner();
 
 TestItem availableTests[] = {
 #if PPSSPP_ARCH(ARM64) || PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
@@ -1016,25 +1195,34 @@ TestItem availableTests[] = {
 	TEST_ITEM(Parsers),
 	TEST_ITEM(IRPassSimplify),
 	TEST_ITEM(Jit),
+	TEST_ITEM(InterpreterFusion),
 	TEST_ITEM(MatrixTranspose),
 	TEST_ITEM(ParseLBN),
 	TEST_ITEM(QuickTexHash),
 	TEST_ITEM(CLZ),
 	TEST_ITEM(MemMap),
+	TEST_ITEM(CoreTimingContexts),
+	TEST_ITEM(MemArena),
 	TEST_ITEM(ShaderGenerators),
 	TEST_ITEM(SoftwareGPUJit),
 	TEST_ITEM(Path),
 	TEST_ITEM(AndroidContentURI),
 	TEST_ITEM(ThreadManager),
+	TEST_ITEM(ThreadManagerBenchmark),
 	TEST_ITEM(WrapText),
 	TEST_ITEM(TinySet),
 	TEST_ITEM(FastVec),
 	TEST_ITEM(SmallDataConvert),
+	TEST_ITEM(ColorConv),
+	TEST_ITEM(HashMaps),
 	TEST_ITEM(DepthMath),
 	TEST_ITEM(InputMapping),
 	TEST_ITEM(EscapeMenuString),
 	TEST_ITEM(VFS),
+	TEST_ITEM(VulkanQueueRunner),
 	TEST_ITEM(Substitutions),
+	TEST_ITEM(IniFile),
+	TEST_ITEM(LogManager),
 };
 
 int main(int argc, const char *argv[]) {